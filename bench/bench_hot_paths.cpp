@@ -0,0 +1,122 @@
+// Microbenchmarks for every kernel on the 104 Hz path. Run via the
+// collar_bench target; bench/check_baselines.py compares the JSON output
+// against bench/baselines.json and fails on a >10% regression (see the
+// bench_check target). Synthetic inputs are fixed-seed so runs are
+// comparable across checkouts.
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+
+#include "classify/classifier.h"
+#include "core/sample_batch.h"
+#include "core/sample_ring.h"
+#include "dsp/features.h"
+#include "server/simd_decode.h"
+#include "storage/frame.h"
+
+namespace {
+
+using namespace collar;
+
+uint32_t lcg(uint32_t& s) {
+    s = s * 1664525u + 1013904223u;
+    return s;
+}
+
+SampleBatch make_batch(uint32_t seed) {
+    SampleBatch b;
+    b.base_tick = 1000;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        ImuSample s{};
+        s.ax = int16_t(lcg(seed) >> 26);  // small deltas, like real accel
+        s.ay = int16_t(lcg(seed) >> 26);
+        s.az = int16_t(16384 + int(lcg(seed) >> 26));
+        s.temp = 500;
+        s.dt = 10;
+        b.append(s);
+    }
+    return b;
+}
+
+void BM_SampleRingPushPop(benchmark::State& state) {
+    static SampleRing<ImuSample, 512> ring;
+    ImuSample s{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ring.try_push(s));
+        benchmark::DoNotOptimize(ring.try_pop(s));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SampleRingPushPop);
+
+void BM_ExtractFeaturesScalar(benchmark::State& state) {
+    const SampleBatch b = make_batch(1);
+    dsp::FeatureVector f{};
+    for (auto _ : state) {
+        dsp::extract_features<dsp::ScalarIsa>(b, f);
+        benchmark::DoNotOptimize(f);
+    }
+    state.SetItemsProcessed(state.iterations() * b.count);
+}
+BENCHMARK(BM_ExtractFeaturesScalar);
+
+void BM_ExtractFeaturesDefault(benchmark::State& state) {
+    const SampleBatch b = make_batch(1);
+    dsp::FeatureVector f{};
+    for (auto _ : state) {
+        dsp::extract_features<>(b, f);
+        benchmark::DoNotOptimize(f);
+    }
+    state.SetItemsProcessed(state.iterations() * b.count);
+}
+BENCHMARK(BM_ExtractFeaturesDefault);
+
+void BM_FrameEncode(benchmark::State& state) {
+    const SampleBatch b = make_batch(2);
+    uint8_t page[storage::kFlashPageSize];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(storage::encode_frame(b, 0, 1, page));
+    }
+    state.SetItemsProcessed(state.iterations() * b.count);
+}
+BENCHMARK(BM_FrameEncode);
+
+void BM_FrameDecode(benchmark::State& state) {
+    const SampleBatch b = make_batch(2);
+    uint8_t page[storage::kFlashPageSize];
+    storage::encode_frame(b, 0, 1, page);
+    SampleBatch out;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(storage::decode_frame(page, out));
+    }
+    state.SetItemsProcessed(state.iterations() * b.count);
+}
+BENCHMARK(BM_FrameDecode);
+
+void BM_FrameDecodeSimd(benchmark::State& state) {
+    const SampleBatch b = make_batch(2);
+    uint8_t page[storage::kFlashPageSize];
+    storage::encode_frame(b, 0, 1, page);
+    SampleBatch out;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(collar::server::decode_frame_simd(page, out));
+    }
+    state.SetItemsProcessed(state.iterations() * b.count);
+}
+BENCHMARK(BM_FrameDecodeSimd);
+
+void BM_ClassifierInfer(benchmark::State& state) {
+    const classify::Classifier c;
+    classify::QuantFeatures q = {100, 100, 16000, 640, 640, 640,
+                                 100, 4000, 200, 50};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(c.classify_quantized(q));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ClassifierInfer);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Compare a Google Benchmark JSON result file against committed baselines.
+
+Usage:
+    check_baselines.py results.json baselines.json [--update] [--tolerance 0.10]
+
+Exits non-zero if any benchmark's cpu_time regressed more than the tolerance
+over its baseline, so the perf runner fails the PR loudly. --update rewrites
+the baseline file from the results (run on the dedicated perf machine only;
+baselines from laptops are noise).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_times(path):
+    with open(path) as f:
+        data = json.load(f)
+    return {b["name"]: b["cpu_time"] for b in data["benchmarks"]}
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("results")
+    ap.add_argument("baselines")
+    ap.add_argument("--update", action="store_true")
+    ap.add_argument("--tolerance", type=float, default=0.10)
+    args = ap.parse_args()
+
+    results = load_times(args.results)
+
+    if args.update:
+        with open(args.baselines, "w") as f:
+            json.dump({"benchmarks": [
+                {"name": n, "cpu_time": t} for n, t in sorted(results.items())
+            ]}, f, indent=2)
+            f.write("\n")
+        print(f"wrote {len(results)} baselines to {args.baselines}")
+        return 0
+
+    baselines = load_times(args.baselines)
+    failed = []
+    for name, base in sorted(baselines.items()):
+        if name not in results:
+            failed.append(f"{name}: missing from results")
+            continue
+        got = results[name]
+        ratio = got / base if base else float("inf")
+        status = "ok"
+        if ratio > 1.0 + args.tolerance:
+            failed.append(f"{name}: {base:.1f} -> {got:.1f} ns "
+                          f"({(ratio - 1) * 100:+.1f}%)")
+            status = "REGRESSED"
+        print(f"{name:32s} base {base:10.1f} now {got:10.1f} ns  {status}")
+    for name in sorted(set(results) - set(baselines)):
+        print(f"{name:32s} (new, no baseline)")
+
+    if failed:
+        print("\nregressions over tolerance:", file=sys.stderr)
+        for f in failed:
+            print("  " + f, file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "core/sample_batch.h"
+#include "storage/varint.h"
+
+namespace collar::proto {
+
+// Per-collar delta dictionaries. Cats are creatures of habit: one collar's
+// per-column delta distribution concentrates on a handful of values, so a
+// trained table of the 15 most common deltas per column lets each sample
+// spend a 4-bit code instead of a whole varint byte, escaping to
+// zigzag-varint for the rest. On habitual data that is ~0.5 bytes/value
+// against varint's 1+ — the 30-40% the corpus experiments promised — and
+// both sides of the link decode with a table lookup, no entropy-coder
+// state machine.
+//
+// The server trains dictionaries from decoded uploads (see
+// server/dict_trainer.h), ships them in a kDict wire frame during sync,
+// and the collar encodes subsequent uploads against its copy. Version 0
+// everywhere means "no dictionary yet; plain delta+varint".
+
+inline constexpr std::size_t kDictSlots = 15;
+inline constexpr uint8_t kDictEscape = 15;
+
+struct ColumnDict {
+    int16_t values[kDictSlots];
+};
+
+inline constexpr std::size_t kDictColumns = 7;  // signed columns, not dt
+
+struct DeltaDict {
+    uint32_t version;  // 0 = untrained
+    ColumnDict col[kDictColumns];
+    uint16_t reserved;  // keeps the wire size explicit, no implicit padding
+};
+static_assert(sizeof(DeltaDict) == 4 + kDictColumns * kDictSlots * 2 + 2,
+              "shipped to the collar verbatim");
+
+// Encoded column layout: [u16 count][nibble codes, 2/byte][escape varints].
+// Codes 0..14 index the dictionary; kDictEscape pulls the next escape
+// varint. Returns encoded bytes, 0 if cap is too small. Allocation-free —
+// the collar runs this in the upload path.
+inline std::size_t dict_encode(const ColumnDict& dict, const int16_t* deltas,
+                               std::size_t n, uint8_t* out, std::size_t cap) {
+    const std::size_t nibble_bytes = (n + 1) / 2;
+    if (cap < 2 + nibble_bytes) {
+        return 0;
+    }
+    out[0] = uint8_t(n);
+    out[1] = uint8_t(n >> 8);
+    uint8_t* nibbles = out + 2;
+    std::memset(nibbles, 0, nibble_bytes);
+    std::size_t esc_off = 2 + nibble_bytes;
+    for (std::size_t i = 0; i < n; ++i) {
+        uint8_t code = kDictEscape;
+        for (std::size_t k = 0; k < kDictSlots; ++k) {
+            if (dict.values[k] == deltas[i]) {
+                code = uint8_t(k);
+                break;
+            }
+        }
+        nibbles[i / 2] |= uint8_t(code << ((i & 1) * 4));
+        if (code == kDictEscape) {
+            if (esc_off + 5 > cap) {
+                return 0;
+            }
+            esc_off += storage::put_varint32(
+                out + esc_off, storage::zigzag32(deltas[i]));
+        }
+    }
+    return esc_off;
+}
+
+inline bool dict_decode(const ColumnDict& dict, const uint8_t* in,
+                        std::size_t len, int16_t* deltas, std::size_t cap,
+                        std::size_t& n_out) {
+    if (len < 2) {
+        return false;
+    }
+    const std::size_t n = std::size_t(in[0]) | (std::size_t(in[1]) << 8);
+    const std::size_t nibble_bytes = (n + 1) / 2;
+    if (n > cap || len < 2 + nibble_bytes) {
+        return false;
+    }
+    const uint8_t* nibbles = in + 2;
+    std::size_t esc_off = 2 + nibble_bytes;
+    for (std::size_t i = 0; i < n; ++i) {
+        const uint8_t code = (nibbles[i / 2] >> ((i & 1) * 4)) & 0xf;
+        if (code != kDictEscape) {
+            deltas[i] = dict.values[code];
+            continue;
+        }
+        uint32_t zz;
+        const std::size_t used =
+            storage::get_varint32(in + esc_off, len - esc_off, zz);
+        if (used == 0) {
+            return false;
+        }
+        esc_off += used;
+        deltas[i] = int16_t(storage::unzigzag32(zz));
+    }
+    n_out = n;
+    return true;
+}
+
+// One whole window encoded against a dictionary: the payload of a
+// kDictPages frame. Layout (all LE): [u32 dict_version][u64 base_tick]
+// [u16 sample_count], then the seven signed columns as [u16 len] +
+// dict_encode stream each, then dt as [u16 len] + plain varints — dt is
+// not delta-of-delta material and stays outside the dictionary, which is
+// also the version-0 fallback story: a collar holding no dictionary keeps
+// sending plain kPages frames and nothing here runs.
+//
+// Worst case (every delta escapes) is ~7.1 KB for a 256-sample window;
+// kDictWindowMax rounds that up. A collar whose data stopped matching its
+// dictionary that badly should fall back to kPages anyway.
+inline constexpr std::size_t kDictWindowMax = 8192;
+inline constexpr std::size_t kDictWindowHeader = 14;
+
+inline std::size_t dict_window_encode(const DeltaDict& dict,
+                                      const SampleBatch& batch, uint8_t* out,
+                                      std::size_t cap) {
+    if (dict.version == 0 || cap < kDictWindowHeader) {
+        return 0;
+    }
+    std::memcpy(out, &dict.version, 4);
+    std::memcpy(out + 4, &batch.base_tick, 8);
+    const uint16_t count = uint16_t(batch.count);
+    std::memcpy(out + 12, &count, 2);
+    std::size_t off = kDictWindowHeader;
+
+    const int16_t* cols[kDictColumns] = {batch.ax, batch.ay, batch.az,
+                                         batch.gx, batch.gy, batch.gz,
+                                         batch.temp};
+    int16_t deltas[SampleBatch::capacity];
+    for (std::size_t c = 0; c < kDictColumns; ++c) {
+        int32_t prev = 0;
+        for (std::size_t i = 0; i < batch.count; ++i) {
+            deltas[i] = int16_t(cols[c][i] - prev);
+            prev = cols[c][i];
+        }
+        if (off + 2 > cap) {
+            return 0;
+        }
+        const std::size_t n = dict_encode(dict.col[c], deltas, batch.count,
+                                          out + off + 2, cap - off - 2);
+        if (n == 0) {
+            return 0;
+        }
+        const uint16_t len = uint16_t(n);
+        std::memcpy(out + off, &len, 2);
+        off += 2 + n;
+    }
+
+    if (off + 2 > cap) {
+        return 0;
+    }
+    std::size_t dt_off = off + 2;
+    for (std::size_t i = 0; i < batch.count; ++i) {
+        if (dt_off + 5 > cap) {
+            return 0;
+        }
+        dt_off += storage::put_varint32(out + dt_off, batch.dt[i]);
+    }
+    const uint16_t dt_len = uint16_t(dt_off - off - 2);
+    std::memcpy(out + off, &dt_len, 2);
+    return dt_off;
+}
+
+// Decodes one window against the receiver's copy of the dictionary. A
+// version mismatch (including version 0: never trained) fails the frame —
+// the collar re-syncs its dictionary from the next kDict and falls back
+// to kPages meanwhile.
+inline bool dict_window_decode(const DeltaDict& dict, const uint8_t* in,
+                               std::size_t len, SampleBatch& batch) {
+    if (len < kDictWindowHeader) {
+        return false;
+    }
+    uint32_t version;
+    std::memcpy(&version, in, 4);
+    if (version == 0 || version != dict.version) {
+        return false;
+    }
+    uint16_t count;
+    std::memcpy(&count, in + 12, 2);
+    if (count > SampleBatch::capacity) {
+        return false;
+    }
+    batch.clear();
+    std::memcpy(&batch.base_tick, in + 4, 8);
+    std::size_t off = kDictWindowHeader;
+
+    int16_t* cols[kDictColumns] = {batch.ax, batch.ay, batch.az, batch.gx,
+                                   batch.gy, batch.gz, batch.temp};
+    int16_t deltas[SampleBatch::capacity];
+    for (std::size_t c = 0; c < kDictColumns; ++c) {
+        if (off + 2 > len) {
+            return false;
+        }
+        uint16_t clen;
+        std::memcpy(&clen, in + off, 2);
+        if (off + 2 + clen > len) {
+            return false;
+        }
+        std::size_t n_out = 0;
+        if (!dict_decode(dict.col[c], in + off + 2, clen, deltas,
+                         SampleBatch::capacity, n_out) ||
+            n_out != count) {
+            return false;
+        }
+        int32_t prev = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            prev += deltas[i];
+            cols[c][i] = int16_t(prev);
+        }
+        off += 2 + clen;
+    }
+
+    if (off + 2 > len) {
+        return false;
+    }
+    uint16_t dt_len;
+    std::memcpy(&dt_len, in + off, 2);
+    if (off + 2 + dt_len > len) {
+        return false;
+    }
+    const uint8_t* p = in + off + 2;
+    const uint8_t* const dt_end = p + dt_len;
+    for (std::size_t i = 0; i < count; ++i) {
+        uint32_t v;
+        const std::size_t n = storage::get_varint32(p, std::size_t(dt_end - p), v);
+        if (n == 0) {
+            return false;
+        }
+        p += n;
+        batch.dt[i] = uint16_t(v);
+    }
+    if (p != dt_end) {
+        return false;
+    }
+    batch.count = count;
+    return off + 2 + dt_len == len;
+}
+
+}  // namespace collar::proto
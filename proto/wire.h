@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "storage/frame.h"
+
+namespace collar::proto {
+
+// Upload wire protocol v2, shared by src/ble/ (sender) and server/
+// (receiver). Replaces the gateway app's JSON-over-characteristic scheme:
+// length-prefixed binary frames, header parseable in place, payload bytes
+// identical to what sits in the flash double buffer so the collar transmits
+// a frame as a scatter-gather list and the server hands payload spans to the
+// decoder without a copy on either end.
+//
+// Byte order is little-endian on the wire — both current ends are LE and
+// the collar cannot afford swab passes; a BE port byte-swaps in
+// parse_header.
+
+inline constexpr uint32_t kWireMagic = 0x32505743;  // "CWP2"
+inline constexpr uint16_t kWireVersion = 2;
+
+enum FrameKind : uint16_t {
+    kHello = 1,  // first frame on a connection; empty payload
+    kPages = 2,  // payload is a whole number of 4 KB flash-log pages
+    kAck = 3,    // server -> collar; empty payload
+    kDict = 4,   // server -> collar; payload is one proto::DeltaDict
+    kDictPages = 5,  // payload is one dict-coded window (proto/dict.h)
+};
+
+struct WireHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind;
+    uint64_t collar_id;
+    uint32_t payload_bytes;
+    uint32_t reserved;
+};
+inline constexpr std::size_t kWireHeaderSize = 24;
+static_assert(sizeof(WireHeader) == kWireHeaderSize,
+              "header is copied to the wire verbatim");
+
+// Payload ceiling a receiver must buffer for a straddled frame. 64 pages is
+// a full sync burst from a collar that slept through the night.
+inline constexpr std::size_t kMaxPayload = 64 * storage::kFlashPageSize;
+
+inline void encode_header(const WireHeader& h, uint8_t* out) {
+    std::memcpy(out, &h, kWireHeaderSize);
+}
+
+// Returns false on bad magic/version/length; h is valid only on true.
+inline bool parse_header(const uint8_t* p, WireHeader& h) {
+    std::memcpy(&h, p, kWireHeaderSize);
+    return h.magic == kWireMagic && h.version == kWireVersion &&
+           h.payload_bytes <= kMaxPayload;
+}
+
+// One element of a scatter-gather transmit list. The collar's link layer
+// walks the list instead of flattening it into a staging buffer.
+struct SgSpan {
+    const uint8_t* data;
+    uint32_t len;
+};
+
+// Builds a kPages frame as a scatter-gather list: the header is written
+// into hdr_out and becomes iov[0]; iov[1..n_pages] alias the pages where
+// they already live (the flash double buffer). iov must have room for
+// n_pages + 1 entries. Returns the entry count. No bytes are copied.
+inline std::size_t pages_frame_sg(uint8_t (&hdr_out)[kWireHeaderSize],
+                                  uint64_t collar_id,
+                                  const uint8_t* const* pages,
+                                  std::size_t n_pages, SgSpan* iov) {
+    WireHeader h{};
+    h.magic = kWireMagic;
+    h.version = kWireVersion;
+    h.kind = kPages;
+    h.collar_id = collar_id;
+    h.payload_bytes = uint32_t(n_pages * storage::kFlashPageSize);
+    encode_header(h, hdr_out);
+    iov[0] = {hdr_out, kWireHeaderSize};
+    for (std::size_t i = 0; i < n_pages; ++i) {
+        iov[i + 1] = {pages[i], uint32_t(storage::kFlashPageSize)};
+    }
+    return n_pages + 1;
+}
+
+// Builds a kDict frame shipping a trained dictionary to the collar during
+// sync. The payload span aliases the dictionary itself, which must stay
+// alive until the list is transmitted.
+template <typename DictT>
+inline std::size_t dict_frame_sg(uint8_t (&hdr_out)[kWireHeaderSize],
+                                 uint64_t collar_id, const DictT& dict,
+                                 SgSpan* iov) {
+    WireHeader h{};
+    h.magic = kWireMagic;
+    h.version = kWireVersion;
+    h.kind = kDict;
+    h.collar_id = collar_id;
+    h.payload_bytes = uint32_t(sizeof(DictT));
+    encode_header(h, hdr_out);
+    iov[0] = {hdr_out, kWireHeaderSize};
+    iov[1] = {reinterpret_cast<const uint8_t*>(&dict), uint32_t(sizeof(DictT))};
+    return 2;
+}
+
+// Builds a kDictPages frame around one dict-coded window (the output of
+// proto::dict_window_encode). The payload span aliases the caller's
+// encode buffer, which must stay alive until the list is transmitted.
+inline std::size_t dict_pages_frame_sg(uint8_t (&hdr_out)[kWireHeaderSize],
+                                       uint64_t collar_id,
+                                       const uint8_t* payload,
+                                       std::size_t payload_len, SgSpan* iov) {
+    WireHeader h{};
+    h.magic = kWireMagic;
+    h.version = kWireVersion;
+    h.kind = kDictPages;
+    h.collar_id = collar_id;
+    h.payload_bytes = uint32_t(payload_len);
+    encode_header(h, hdr_out);
+    iov[0] = {hdr_out, kWireHeaderSize};
+    iov[1] = {payload, uint32_t(payload_len)};
+    return 2;
+}
+
+}  // namespace collar::proto
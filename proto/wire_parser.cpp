@@ -0,0 +1,63 @@
+#include "proto/wire_parser.h"
+
+namespace collar::proto {
+
+bool WireParser::feed(const uint8_t* data, std::size_t len) {
+    // Drain the straddle buffer first: top it up to a header, then to a
+    // whole frame, then emit from the buffer.
+    while (!pending_.empty()) {
+        if (pending_.size() < kWireHeaderSize) {
+            const std::size_t need = kWireHeaderSize - pending_.size();
+            const std::size_t take = need < len ? need : len;
+            pending_.insert(pending_.end(), data, data + take);
+            data += take;
+            len -= take;
+            if (pending_.size() < kWireHeaderSize) {
+                return true;  // still mid-header
+            }
+        }
+        WireHeader h;
+        if (!parse_header(pending_.data(), h)) {
+            return false;
+        }
+        const std::size_t frame = kWireHeaderSize + h.payload_bytes;
+        if (pending_.size() < frame) {
+            const std::size_t need = frame - pending_.size();
+            const std::size_t take = need < len ? need : len;
+            pending_.insert(pending_.end(), data, data + take);
+            data += take;
+            len -= take;
+            if (pending_.size() < frame) {
+                return true;  // still mid-payload
+            }
+        }
+        ++frames_;
+        on_frame_(h, pending_.data() + kWireHeaderSize, h.payload_bytes);
+        pending_.clear();
+    }
+
+    // Whole frames straight out of the caller's buffer.
+    while (len >= kWireHeaderSize) {
+        WireHeader h;
+        if (!parse_header(data, h)) {
+            return false;
+        }
+        const std::size_t frame = kWireHeaderSize + h.payload_bytes;
+        if (len < frame) {
+            break;
+        }
+        ++frames_;
+        ++zero_copy_;
+        on_frame_(h, data + kWireHeaderSize, h.payload_bytes);
+        data += frame;
+        len -= frame;
+    }
+
+    // Tail of a cut frame waits for the next read.
+    if (len > 0) {
+        pending_.assign(data, data + len);
+    }
+    return true;
+}
+
+}  // namespace collar::proto
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "proto/wire.h"
+
+namespace collar::proto {
+
+// Server-side incremental parser for the v2 wire stream. Host-only (it
+// buffers straddled frames on the heap); the collar never parses, it only
+// builds frames with pages_frame_sg().
+//
+// Zero-copy is the common case: a socket read usually delivers whole
+// frames, and those are emitted as spans into the caller's receive buffer.
+// Only a frame cut by a read boundary is stitched through the internal
+// buffer. The frame callback must finish with the span before feed()
+// returns — on_upload copies what it keeps, so this holds today.
+class WireParser {
+public:
+    using FrameFn =
+        std::function<void(const WireHeader&, const uint8_t* payload,
+                           std::size_t len)>;
+
+    explicit WireParser(FrameFn on_frame) : on_frame_(std::move(on_frame)) {}
+
+    // Returns false on a protocol violation (bad magic/version/length);
+    // the caller should drop the connection — there is no resync.
+    bool feed(const uint8_t* data, std::size_t len);
+
+    uint64_t frames() const { return frames_; }
+    uint64_t zero_copy_frames() const { return zero_copy_; }
+
+private:
+    FrameFn on_frame_;
+    std::vector<uint8_t> pending_;  // partial frame across feed boundaries
+    uint64_t frames_ = 0;
+    uint64_t zero_copy_ = 0;
+};
+
+}  // namespace collar::proto
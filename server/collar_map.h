@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "server/epoch.h"
+
+namespace collar::server {
+
+// Open-addressing hash map for per-collar session state: one flat slot
+// array, linear probing, 64-bit collar-ID keys, values stored inline. No
+// node allocations, so a lookup is one cache-line-friendly probe run
+// instead of a pointer chase — this sits on the 60k-lookups/s ingest path.
+//
+// Concurrency model:
+//  - exactly one writer (the owning executor shard) inserts and mutates;
+//  - any thread may read concurrently without a lock, by holding an
+//    epoch::Guard across the find. Growth publishes a fresh table and
+//    retires the old one through the epoch reclaimer, so a reader mid-probe
+//    on the old table stays valid until it leaves its guard;
+//  - cross-thread readers of a live value (stats scrapes) tolerate torn
+//    fields: counters are monotonic and monitoring rounds down. Decisions
+//    that need exact state run on the owning shard.
+//
+// Key 0 is the empty sentinel; collar serials start at 1.
+template <typename V>
+class CollarMap {
+public:
+    explicit CollarMap(std::size_t initial_capacity = 1024)
+        : table_(Table::make(round_up(initial_capacity))) {}
+
+    ~CollarMap() {
+        delete table_.load(std::memory_order_relaxed);
+        // Anything still in the epoch reclaimer drains there.
+    }
+
+    CollarMap(const CollarMap&) = delete;
+    CollarMap& operator=(const CollarMap&) = delete;
+
+    // Writer only. Returns the value slot for key, inserting a
+    // default-constructed V if absent.
+    V& get_or_insert(uint64_t key) {
+        Table* t = table_.load(std::memory_order_relaxed);
+        if ((size_ + 1) * 10 > t->capacity * 7) {  // 0.7 load factor
+            t = grow(t);
+        }
+        Slot* s = probe(t, key, /*for_insert=*/true);
+        if (s->key.load(std::memory_order_relaxed) == 0) {
+            s->value = V{};
+            s->key.store(key, std::memory_order_release);
+            ++size_;
+        }
+        return s->value;
+    }
+
+    // Any thread; caller must hold an epoch::Guard. Returns nullptr when
+    // absent. The pointer is valid for the guard's lifetime.
+    const V* find(uint64_t key) const {
+        Table* t = table_.load(std::memory_order_acquire);
+        const std::size_t mask = t->capacity - 1;
+        std::size_t i = hash(key) & mask;
+        for (std::size_t n = 0; n < t->capacity; ++n, i = (i + 1) & mask) {
+            const uint64_t k = t->slots[i].key.load(std::memory_order_acquire);
+            if (k == key) {
+                return &t->slots[i].value;
+            }
+            if (k == 0) {
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const {
+        return table_.load(std::memory_order_relaxed)->capacity;
+    }
+
+    // Writer only: iterate live entries (stats dumps, shutdown flush).
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        Table* t = table_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < t->capacity; ++i) {
+            if (t->slots[i].key.load(std::memory_order_relaxed) != 0) {
+                fn(t->slots[i].key.load(std::memory_order_relaxed),
+                   t->slots[i].value);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> key{0};
+        V value{};
+    };
+
+    struct Table {
+        std::size_t capacity;
+        std::vector<Slot> slots;
+
+        static Table* make(std::size_t cap) {
+            Table* t = new Table;
+            t->capacity = cap;
+            t->slots = std::vector<Slot>(cap);
+            return t;
+        }
+    };
+
+    static std::size_t round_up(std::size_t n) {
+        std::size_t c = 16;
+        while (c < n) {
+            c <<= 1;
+        }
+        return c;
+    }
+
+    static std::size_t hash(uint64_t key) {
+        return std::size_t((key * 0x9e3779b97f4a7c15ull) >> 13);
+    }
+
+    Slot* probe(Table* t, uint64_t key, bool for_insert) {
+        const std::size_t mask = t->capacity - 1;
+        std::size_t i = hash(key) & mask;
+        for (;;) {
+            const uint64_t k = t->slots[i].key.load(std::memory_order_relaxed);
+            if (k == key || (k == 0 && for_insert)) {
+                return &t->slots[i];
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    Table* grow(Table* old) {
+        Table* fresh = Table::make(old->capacity * 2);
+        for (std::size_t i = 0; i < old->capacity; ++i) {
+            const uint64_t k = old->slots[i].key.load(std::memory_order_relaxed);
+            if (k != 0) {
+                Slot* s = probe(fresh, k, true);
+                s->value = old->slots[i].value;
+                s->key.store(k, std::memory_order_release);
+            }
+        }
+        table_.store(fresh, std::memory_order_release);
+        // Readers may still be probing the old table; the epoch reclaimer
+        // frees it once every guard active at retire time has exited.
+        epoch::retire(old, [](void* p) { delete static_cast<Table*>(p); });
+        return fresh;
+    }
+
+    std::atomic<Table*> table_;
+    std::size_t size_ = 0;  // writer-owned
+};
+
+}  // namespace collar::server
@@ -0,0 +1,252 @@
+#include "server/compact/compactor.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace collar::server::compact {
+
+using storage::ColumnId;
+using storage::kArchiveColumns;
+
+void Compactor::plan(std::vector<Job>& jobs) const {
+    std::vector<std::size_t> order(in_.segment_count());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [this](std::size_t a, std::size_t b) {
+                  const auto& ma = in_.meta(a);
+                  const auto& mb = in_.meta(b);
+                  if (ma.collar_id != mb.collar_id) {
+                      return ma.collar_id < mb.collar_id;
+                  }
+                  if (ma.base_tick != mb.base_tick) {
+                      return ma.base_tick < mb.base_tick;
+                  }
+                  return a < b;
+              });
+
+    // End tick (base_tick + sum of dt) per segment, for the contiguity
+    // split below. One dt decode per input segment — cheap next to the
+    // merge decodes, and it keeps merge_job free of timestamp surgery.
+    std::vector<uint64_t> end_tick(in_.segment_count());
+    std::vector<uint16_t> dt;
+    for (std::size_t i = 0; i < in_.segment_count(); ++i) {
+        const auto& m = in_.meta(i);
+        if (m.sample_count > dt.size()) {
+            dt.resize(m.sample_count);
+        }
+        uint64_t end = m.base_tick;
+        if (in_.read_dt(i, dt.data())) {
+            for (std::size_t k = 0; k < m.sample_count; ++k) {
+                end += dt[k];
+            }
+        }
+        end_tick[i] = end;
+    }
+
+    Job cur;
+    std::size_t cur_samples = 0;
+    uint64_t cur_collar = 0;
+    uint64_t cur_end = 0;
+    for (const std::size_t i : order) {
+        const auto& m = in_.meta(i);
+        // A merged segment keeps only the first input's base_tick and the
+        // concatenated dt streams, so inputs must tile in time exactly:
+        // merging across a gap (BLE dead time, duty-cycled sampling, a
+        // missed upload) would silently re-timestamp everything after the
+        // junction. Split there instead. Also never plan past the
+        // archive's per-segment ceiling — append_encoded would only
+        // reject the job after the merge work is already done.
+        if (!cur.inputs.empty() &&
+            (m.collar_id != cur_collar ||
+             cur_samples >= opt_.target_samples ||
+             m.base_tick != cur_end ||
+             cur_samples + m.sample_count >
+                 storage::kArchiveMaxSegmentSamples)) {
+            jobs.push_back(std::move(cur));
+            cur = Job{};
+            cur_samples = 0;
+        }
+        cur_collar = m.collar_id;
+        cur.inputs.push_back(i);
+        cur_samples += m.sample_count;
+        cur_end = end_tick[i];
+    }
+    if (!cur.inputs.empty()) {
+        jobs.push_back(std::move(cur));
+    }
+    // A job is cold when even its newest input predates the cutoff; mixed
+    // jobs stay hot so recent data never pays the heavy decode.
+    for (Job& j : jobs) {
+        const auto& newest = in_.meta(j.inputs.back());
+        j.cold = opt_.cold_before_tick > 0 &&
+                 newest.base_tick < opt_.cold_before_tick;
+    }
+}
+
+bool Compactor::merge_job(const Job& job, Result& res) const {
+    std::size_t total = 0;
+    for (const std::size_t i : job.inputs) {
+        total += in_.meta(i).sample_count;
+    }
+    res.collar_id = in_.meta(job.inputs.front()).collar_id;
+    res.base_tick = in_.meta(job.inputs.front()).base_tick;
+    res.sample_count = uint32_t(total);
+
+    std::vector<int16_t> merged(total);
+    std::vector<uint16_t> merged_dt(total);
+    for (std::size_t c = 0; c + 1 < kArchiveColumns; ++c) {
+        std::size_t at = 0;
+        for (const std::size_t i : job.inputs) {
+            if (!in_.read_column(i, ColumnId(c), merged.data() + at)) {
+                return false;
+            }
+            at += in_.meta(i).sample_count;
+        }
+        res.col[c].resize(storage::column_codec_bound(total));
+        const std::size_t bytes =
+            job.cold ? storage::encode_column_for_packed(merged.data(), total,
+                                                         res.col[c].data())
+                     : storage::encode_column_signed(merged.data(), total,
+                                                     res.col[c].data());
+        res.col[c].resize(bytes);
+        res.codec[c] = job.cold ? storage::kCodecForPacked
+                                : storage::kCodecDeltaVarint;
+    }
+    std::size_t at = 0;
+    for (const std::size_t i : job.inputs) {
+        if (!in_.read_dt(i, merged_dt.data() + at)) {
+            return false;
+        }
+        at += in_.meta(i).sample_count;
+    }
+    const std::size_t dt_idx = std::size_t(ColumnId::kDt);
+    res.col[dt_idx].resize(storage::column_codec_bound(total));
+    res.col[dt_idx].resize(storage::encode_column_dt(
+        merged_dt.data(), total, res.col[dt_idx].data()));
+    res.codec[dt_idx] = storage::kCodecVarint;
+    return true;
+}
+
+void Compactor::worker_loop(std::size_t self) {
+    for (;;) {
+        std::size_t job = SIZE_MAX;
+        {
+            std::lock_guard<std::mutex> lk(*queue_mu_[self]);
+            if (!queues_[self].empty()) {
+                job = queues_[self].back();
+                queues_[self].pop_back();
+            }
+        }
+        if (job == SIZE_MAX) {
+            // Own queue dry: steal from a victim's front — the opposite
+            // end the owner pops, so contention stays on the lock, not
+            // the jobs.
+            for (std::size_t v = 0; v < queues_.size() && job == SIZE_MAX;
+                 ++v) {
+                if (v == self) {
+                    continue;
+                }
+                std::lock_guard<std::mutex> lk(*queue_mu_[v]);
+                if (!queues_[v].empty()) {
+                    job = queues_[v].front();
+                    queues_[v].pop_front();
+                    steals_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        if (job == SIZE_MAX) {
+            return;  // no queue holds work and none is ever added
+        }
+        Result& res = *results_[job];
+        res.failed = !merge_job(jobs_[job], res);
+        {
+            std::lock_guard<std::mutex> lk(done_mu_);
+            res.ready.store(true, std::memory_order_release);
+        }
+        done_cv_.notify_one();
+    }
+}
+
+bool Compactor::run(storage::ArchiveWriter& out) {
+    jobs_.clear();
+    plan(jobs_);
+    stats_ = Stats{};
+    stats_.input_segments = in_.segment_count();
+    for (std::size_t i = 0; i < in_.segment_count(); ++i) {
+        for (std::size_t c = 0; c < kArchiveColumns; ++c) {
+            stats_.input_bytes += in_.meta(i).col[c].bytes;
+        }
+    }
+
+    std::size_t workers = opt_.workers != 0
+                              ? opt_.workers
+                              : std::thread::hardware_concurrency();
+    if (workers == 0) {
+        workers = 1;
+    }
+    if (workers > jobs_.size() && !jobs_.empty()) {
+        workers = jobs_.size();
+    }
+
+    results_.clear();
+    queues_.assign(workers, {});
+    queue_mu_.clear();
+    for (std::size_t w = 0; w < workers; ++w) {
+        queue_mu_.push_back(std::make_unique<std::mutex>());
+    }
+    for (std::size_t j = 0; j < jobs_.size(); ++j) {
+        results_.push_back(std::make_unique<Result>());
+        queues_[j % workers].push_back(j);
+    }
+    steals_.store(0);
+
+    std::vector<std::thread> threads;
+    for (std::size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([this, w] { worker_loop(w); });
+    }
+
+    // Append strictly in planned order: the output stays sorted by
+    // (collar, time) and finished jobs are released as they land.
+    bool ok = true;
+    for (std::size_t j = 0; j < jobs_.size(); ++j) {
+        Result& res = *results_[j];
+        {
+            std::unique_lock<std::mutex> lk(done_mu_);
+            done_cv_.wait(lk, [&res] {
+                return res.ready.load(std::memory_order_acquire);
+            });
+        }
+        if (res.failed) {
+            ok = false;
+            continue;
+        }
+        storage::EncodedColumn cols[kArchiveColumns];
+        for (std::size_t c = 0; c < kArchiveColumns; ++c) {
+            cols[c] = {res.col[c].data(), uint32_t(res.col[c].size()),
+                       res.codec[c]};
+            stats_.output_bytes += res.col[c].size();
+        }
+        if (!out.append_encoded(res.collar_id, res.base_tick,
+                                res.sample_count, cols)) {
+            ok = false;
+            continue;
+        }
+        ++stats_.output_segments;
+        if (jobs_[j].cold) {
+            ++stats_.cold_segments;
+        }
+        for (auto& buf : res.col) {
+            buf.clear();
+            buf.shrink_to_fit();
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    stats_.steals = steals_.load();
+    return ok;
+}
+
+}  // namespace collar::server::compact
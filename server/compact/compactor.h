@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "storage/archive.h"
+
+namespace collar::server::compact {
+
+// Archive compaction: merges the thousands of small per-flush row groups
+// an ingest day leaves behind into large segments sorted by (collar, time),
+// and re-compresses cold segments with the heavier bit-packed codec.
+// Small-segment sprawl is what degrades scans — the footer index grows
+// linearly and every segment costs a decode setup — so compaction is a
+// standing job, not a rescue.
+//
+// Parallelism is work-stealing over merge jobs: each worker owns a deque
+// seeded round-robin, pops from its own back, and steals from a victim's
+// front when empty, so one collar with a month of backlog cannot idle the
+// other cores. Workers encode merged columns into memory; the writer
+// thread appends finished jobs strictly in planned order, which keeps the
+// output file sorted and memory bounded by the in-flight window rather
+// than the whole run.
+class Compactor {
+public:
+    struct Options {
+        std::size_t workers = 0;            // 0 = hardware concurrency
+        std::size_t target_samples = 64 * 1024;  // per merged segment
+        // Segments whose newest tick is older than this are cold and get
+        // the bit-packed codec; 0 keeps everything on the hot codec.
+        uint64_t cold_before_tick = 0;
+    };
+
+    struct Stats {
+        uint64_t input_segments = 0;
+        uint64_t output_segments = 0;
+        uint64_t input_bytes = 0;
+        uint64_t output_bytes = 0;
+        uint64_t cold_segments = 0;
+        uint64_t steals = 0;
+    };
+
+    Compactor(const storage::ArchiveReader& in, Options opt)
+        : in_(in), opt_(opt) {}
+    Compactor(const Compactor&) = delete;
+    Compactor& operator=(const Compactor&) = delete;
+
+    // Plan, merge and write. Returns false on a decode or write failure;
+    // the output writer is left un-closed either way (caller owns close).
+    bool run(storage::ArchiveWriter& out);
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Job {
+        std::vector<std::size_t> inputs;  // segment indices, time-sorted
+        bool cold = false;
+    };
+
+    struct Result {
+        uint64_t collar_id = 0;
+        uint64_t base_tick = 0;
+        uint32_t sample_count = 0;
+        std::vector<uint8_t> col[storage::kArchiveColumns];
+        uint8_t codec[storage::kArchiveColumns] = {};
+        std::atomic<bool> ready{false};
+        bool failed = false;
+    };
+
+    void plan(std::vector<Job>& jobs) const;
+    bool merge_job(const Job& job, Result& res) const;
+    void worker_loop(std::size_t self);
+
+    const storage::ArchiveReader& in_;
+    Options opt_;
+    Stats stats_;
+
+    // Work-stealing state, alive only during run().
+    std::vector<Job> jobs_;
+    std::vector<std::unique_ptr<Result>> results_;
+    std::vector<std::deque<std::size_t>> queues_;
+    std::vector<std::unique_ptr<std::mutex>> queue_mu_;
+    std::atomic<uint64_t> steals_{0};
+    std::mutex done_mu_;
+    std::condition_variable done_cv_;
+};
+
+}  // namespace collar::server::compact
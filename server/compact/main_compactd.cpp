@@ -0,0 +1,74 @@
+// collar_compactd — archive compaction and tiering job.
+//
+// Reads one archive, merges its per-flush row groups into large segments
+// sorted by (collar, time), re-compresses cold segments with the
+// bit-packed codec, and writes a fresh archive. Run from cron against
+// yesterday's file; the swap (rename over the old archive once readers
+// drain) is the operator's move, not this binary's.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "server/compact/compactor.h"
+#include "storage/archive.h"
+
+int main(int argc, char** argv) {
+    const char* in_path = nullptr;
+    const char* out_path = nullptr;
+    collar::server::compact::Compactor::Options opt;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--in") == 0 && i + 1 < argc) {
+            in_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            opt.workers = std::size_t(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--target-samples") == 0 &&
+                   i + 1 < argc) {
+            opt.target_samples = std::size_t(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--cold-before-tick") == 0 &&
+                   i + 1 < argc) {
+            opt.cold_before_tick = uint64_t(std::atoll(argv[++i]));
+        } else {
+            in_path = nullptr;
+            break;
+        }
+    }
+    if (in_path == nullptr || out_path == nullptr) {
+        std::fprintf(stderr,
+                     "usage: %s --in PATH --out PATH [--workers N]\n"
+                     "          [--target-samples N] [--cold-before-tick T]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    collar::storage::ArchiveReader in;
+    if (!in.open(in_path)) {
+        std::fprintf(stderr, "cannot open archive %s\n", in_path);
+        return 1;
+    }
+    collar::storage::ArchiveWriter out;
+    if (!out.open(out_path)) {
+        std::fprintf(stderr, "cannot create %s\n", out_path);
+        return 1;
+    }
+
+    collar::server::compact::Compactor compactor(in, opt);
+    const bool ok = compactor.run(out) && out.close();
+    const auto& s = compactor.stats();
+    std::printf("collar_compactd: %" PRIu64 " -> %" PRIu64 " segments, %" PRIu64
+                " -> %" PRIu64 " bytes (%.2fx), %" PRIu64 " cold, %" PRIu64
+                " steals\n",
+                s.input_segments, s.output_segments, s.input_bytes,
+                s.output_bytes,
+                s.output_bytes ? double(s.input_bytes) / double(s.output_bytes)
+                               : 0.0,
+                s.cold_segments, s.steals);
+    if (!ok) {
+        std::fprintf(stderr, "compaction failed; output is not valid\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "core/sample_batch.h"
+#include "proto/dict.h"
+
+namespace collar::server {
+
+// Learns one collar's delta distribution from decoded uploads and builds
+// its proto::DeltaDict. Lives inside the shard-owned CollarSession, so
+// observe() needs no lock. Habitual deltas are small; the histogram covers
+// [-128, 127] and everything outside stays an escape — exactly what the
+// 4-bit code can't help with anyway.
+class DictTrainer {
+public:
+    // Windows observed before the first dictionary is built (~20 s of
+    // data). More data keeps refining later versions during quiet periods;
+    // this is just the floor.
+    static constexpr uint32_t kTrainWindows = 8;
+
+    void observe(const SampleBatch& batch) {
+        const int16_t* cols[proto::kDictColumns] = {
+            batch.ax, batch.ay, batch.az, batch.gx,
+            batch.gy, batch.gz, batch.temp};
+        for (std::size_t c = 0; c < proto::kDictColumns; ++c) {
+            for (std::size_t i = 1; i < batch.count; ++i) {
+                const int32_t d = int32_t(cols[c][i]) - cols[c][i - 1];
+                if (d >= -128 && d <= 127) {
+                    uint16_t& n = counts_[c][d + 128];
+                    if (n != 0xffff) {
+                        ++n;
+                    }
+                }
+            }
+        }
+        ++windows_;
+    }
+
+    bool ready() const { return windows_ >= kTrainWindows; }
+    uint32_t windows() const { return windows_; }
+
+    // Top kDictSlots deltas per column, most frequent first.
+    proto::DeltaDict build(uint32_t version) const {
+        proto::DeltaDict dict{};
+        dict.version = version;
+        for (std::size_t c = 0; c < proto::kDictColumns; ++c) {
+            uint16_t taken[256];
+            std::memcpy(taken, counts_[c], sizeof(taken));
+            for (std::size_t k = 0; k < proto::kDictSlots; ++k) {
+                std::size_t best = 0;
+                for (std::size_t v = 1; v < 256; ++v) {
+                    if (taken[v] > taken[best]) {
+                        best = v;
+                    }
+                }
+                dict.col[c].values[k] = int16_t(int(best) - 128);
+                taken[best] = 0;
+            }
+        }
+        return dict;
+    }
+
+private:
+    uint16_t counts_[proto::kDictColumns][256] = {};
+    uint32_t windows_ = 0;
+};
+
+}  // namespace collar::server
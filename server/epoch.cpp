@@ -0,0 +1,136 @@
+#include "server/epoch.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace collar::server::epoch {
+
+namespace {
+
+constexpr std::size_t kMaxThreads = 128;
+constexpr uint64_t kQuiescent = ~uint64_t(0);
+constexpr std::size_t kCollectThreshold = 8;
+
+// Global epoch, bumped on every retire. Reader slots publish the epoch they
+// entered under; a retired object is free when the minimum over all active
+// slots has moved past its retire epoch.
+std::atomic<uint64_t> g_epoch{1};
+
+struct ReaderSlot {
+    std::atomic<uint64_t> epoch{kQuiescent};
+    std::atomic<bool> claimed{false};
+};
+ReaderSlot g_slots[kMaxThreads];
+
+struct ThreadReg {
+    ReaderSlot* slot = nullptr;
+    ~ThreadReg() {
+        if (slot) {
+            slot->epoch.store(kQuiescent, std::memory_order_release);
+            slot->claimed.store(false, std::memory_order_release);
+        }
+    }
+};
+
+ReaderSlot& my_slot() {
+    thread_local ThreadReg reg;
+    if (!reg.slot) {
+        for (std::size_t i = 0; i < kMaxThreads; ++i) {
+            bool expected = false;
+            if (g_slots[i].claimed.compare_exchange_strong(expected, true)) {
+                reg.slot = &g_slots[i];
+                break;
+            }
+        }
+        // More threads than slots is a deployment error; crash early.
+        if (!reg.slot) {
+            __builtin_trap();
+        }
+    }
+    return *reg.slot;
+}
+
+struct Retired {
+    void* ptr;
+    void (*deleter)(void*);
+    uint64_t epoch;
+};
+
+// The retire list is writer-side only and cold; a mutex here costs nothing
+// on the reader path, which never touches it.
+std::mutex g_retired_mu;
+std::vector<Retired> g_retired;
+
+uint64_t min_active_epoch() {
+    uint64_t min = kQuiescent;
+    for (std::size_t i = 0; i < kMaxThreads; ++i) {
+        const uint64_t e = g_slots[i].epoch.load(std::memory_order_acquire);
+        if (e < min) {
+            min = e;
+        }
+    }
+    return min;
+}
+
+}  // namespace
+
+Guard::Guard() {
+    ReaderSlot& s = my_slot();
+    s.epoch.store(g_epoch.load(std::memory_order_acquire),
+                  std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+Guard::~Guard() {
+    my_slot().epoch.store(kQuiescent, std::memory_order_release);
+}
+
+void retire(void* ptr, void (*deleter)(void*)) {
+    const uint64_t e = g_epoch.fetch_add(1, std::memory_order_acq_rel);
+    bool should_collect;
+    {
+        std::lock_guard lk(g_retired_mu);
+        g_retired.push_back({ptr, deleter, e});
+        should_collect = g_retired.size() >= kCollectThreshold;
+    }
+    if (should_collect) {
+        collect();
+    }
+}
+
+void collect() {
+    // The other half of the Dekker pattern with Guard's seq_cst fence: the
+    // acq_rel epoch bump in retire() is not enough by the C++ model — a
+    // reader's slot store and the collector's slot loads could each miss
+    // the other, freeing a table a guard still references. Harmless on
+    // x86's ordering, a use-after-free anywhere weaker.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint64_t min = min_active_epoch();
+    std::vector<Retired> free_now;
+    {
+        std::lock_guard lk(g_retired_mu);
+        auto keep = g_retired.begin();
+        for (auto& r : g_retired) {
+            // A guard that entered at epoch E can hold references retired
+            // at epoch >= E; only objects retired strictly before every
+            // active reader's entry epoch are safe.
+            if (r.epoch < min) {
+                free_now.push_back(r);
+            } else {
+                *keep++ = r;
+            }
+        }
+        g_retired.erase(keep, g_retired.end());
+    }
+    for (auto& r : free_now) {
+        r.deleter(r.ptr);
+    }
+}
+
+std::size_t pending() {
+    std::lock_guard lk(g_retired_mu);
+    return g_retired.size();
+}
+
+}  // namespace collar::server::epoch
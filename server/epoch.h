@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace collar::server::epoch {
+
+// Epoch-based reclamation for read-mostly server structures (currently the
+// per-collar session tables). Readers wrap unlocked accesses in a Guard;
+// writers hand replaced memory to retire(), which frees it only after every
+// guard that could have observed it has exited. No reader ever takes a
+// lock or performs an RMW on a shared line beyond its own slot.
+
+// Enter/exit a read-side critical section. Cheap enough for per-frame use:
+// one store on enter, one on exit, both to a thread-private slot.
+class Guard {
+public:
+    Guard();
+    ~Guard();
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+};
+
+// Hand off memory for deferred reclamation. deleter(ptr) runs on a later
+// retire()/collect() call from any writer thread, never concurrently with a
+// guard that predates this retire.
+void retire(void* ptr, void (*deleter)(void*));
+
+// Attempt to free retired memory now. Called opportunistically by writers;
+// retire() also invokes it once its backlog grows.
+void collect();
+
+// Test/ops visibility: number of retired-but-not-yet-freed objects.
+std::size_t pending();
+
+}  // namespace collar::server::epoch
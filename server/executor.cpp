@@ -0,0 +1,131 @@
+#include "server/executor.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace collar::server {
+
+ShardedExecutor::ShardedExecutor(std::size_t workers) {
+    if (workers == 0) {
+        workers = 1;
+    }
+    queues_.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        queues_.push_back(std::make_unique<Worker>());
+    }
+    workers_.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ShardedExecutor::~ShardedExecutor() {
+    stop_.store(true);
+    for (auto& q : queues_) {
+        std::lock_guard lk(q->mu);
+        q->cv.notify_all();
+    }
+    for (auto& t : workers_) {
+        t.join();
+    }
+}
+
+void ShardedExecutor::submit(uint64_t collar_id, Task task) {
+    Worker& w = *queues_[shard_of(collar_id)];
+    {
+        std::lock_guard lk(w.mu);
+        w.pinned.push_back(std::move(task));
+    }
+    w.cv.notify_one();
+}
+
+void ShardedExecutor::submit(Task task) {
+    // Spread shard-agnostic work round-robin; thieves even it out from
+    // there.
+    static std::atomic<std::size_t> next{0};
+    Worker& w = *queues_[next.fetch_add(1, std::memory_order_relaxed) %
+                         queues_.size()];
+    {
+        std::lock_guard lk(w.mu);
+        w.shared.push_back(std::move(task));
+    }
+    w.cv.notify_one();
+}
+
+bool ShardedExecutor::try_get_local(std::size_t self, Task& out) {
+    Worker& w = *queues_[self];
+    std::lock_guard lk(w.mu);
+    if (!w.pinned.empty()) {
+        out = std::move(w.pinned.front());
+        w.pinned.pop_front();
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    if (!w.shared.empty()) {
+        out = std::move(w.shared.front());
+        w.shared.pop_front();
+        in_flight_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool ShardedExecutor::try_steal(std::size_t self, Task& out) {
+    const std::size_t n = queues_.size();
+    for (std::size_t d = 1; d < n; ++d) {
+        Worker& v = *queues_[(self + d) % n];
+        std::lock_guard lk(v.mu);
+        if (!v.shared.empty()) {
+            // Steal from the back: the victim keeps its cache-warm front.
+            out = std::move(v.shared.back());
+            v.shared.pop_back();
+            in_flight_.fetch_add(1, std::memory_order_relaxed);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ShardedExecutor::worker_loop(std::size_t self) {
+    Worker& w = *queues_[self];
+    Task task;
+    while (!stop_.load(std::memory_order_relaxed)) {
+        if (try_get_local(self, task) || try_steal(self, task)) {
+            task();
+            // Destroy the closure (and whatever it owns) before the task
+            // stops counting as in flight.
+            task = nullptr;
+            in_flight_.fetch_sub(1, std::memory_order_release);
+            continue;
+        }
+        std::unique_lock lk(w.mu);
+        w.cv.wait_for(lk, std::chrono::milliseconds(1), [&] {
+            return stop_.load(std::memory_order_relaxed) ||
+                   !w.pinned.empty() || !w.shared.empty();
+        });
+    }
+}
+
+void ShardedExecutor::drain() {
+    for (;;) {
+        bool idle = true;
+        for (auto& q : queues_) {
+            std::lock_guard lk(q->mu);
+            if (!q->pinned.empty() || !q->shared.empty()) {
+                idle = false;
+                break;
+            }
+        }
+        // Order matters: a task popped before a queue looked empty was
+        // counted in flight while that queue's lock was still held, so if
+        // every queue scanned empty and the counter reads zero afterwards,
+        // nothing can still be running.
+        if (idle && in_flight_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+}  // namespace collar::server
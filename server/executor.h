@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace collar::server {
+
+// Work-stealing executor with collar-ID sharding. Every worker owns two
+// queues:
+//
+//  - a pinned queue, fed by submit(collar_id, task): the owning worker is
+//    the only thread that ever pops it, so all tasks for one collar run on
+//    one thread in order and per-collar session state needs no lock at all;
+//  - a shared queue, fed by submit(task): the owner pops the front, idle
+//    workers steal from the back. Stateless work (frame CRC + varint
+//    decode) goes here so an evening sync storm spreads across cores even
+//    when it lands on a handful of shards.
+//
+// Queue protection is one small mutex per worker; at ingest task
+// granularity (one 4 KB frame) that lock is uncontended background noise
+// compared to the decode itself.
+class ShardedExecutor {
+public:
+    using Task = std::function<void()>;
+
+    explicit ShardedExecutor(std::size_t workers);
+    ~ShardedExecutor();
+
+    ShardedExecutor(const ShardedExecutor&) = delete;
+    ShardedExecutor& operator=(const ShardedExecutor&) = delete;
+
+    std::size_t worker_count() const { return workers_.size(); }
+    std::size_t shard_of(uint64_t collar_id) const {
+        // Fibonacci hash: collar IDs are dense sequential serials and a
+        // plain modulo would put whole manufacturing batches on one shard.
+        return std::size_t((collar_id * 0x9e3779b97f4a7c15ull) >> 32) %
+               workers_.size();
+    }
+
+    // Run task on the shard that owns collar_id, after all previously
+    // submitted tasks for that shard.
+    void submit(uint64_t collar_id, Task task);
+
+    // Run task on any worker; eligible for stealing.
+    void submit(Task task);
+
+    // Block until every queue is empty and every worker is idle. Test and
+    // shutdown aid, not a hot-path primitive.
+    void drain();
+
+    uint64_t steal_count() const { return steals_; }
+
+private:
+    struct Worker {
+        std::mutex mu;
+        std::condition_variable cv;
+        std::deque<Task> pinned;
+        std::deque<Task> shared;
+    };
+
+    void worker_loop(std::size_t self);
+    bool try_get_local(std::size_t self, Task& out);
+    bool try_steal(std::size_t self, Task& out);
+
+    std::vector<std::unique_ptr<Worker>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> steals_{0};
+    // Tasks popped but not yet finished. Incremented while the pop still
+    // holds the queue lock, so drain() can never observe an empty queue
+    // without also observing the in-flight task it lost — a per-worker
+    // busy flag set after the lock drops had exactly that window.
+    std::atomic<std::size_t> in_flight_{0};
+};
+
+}  // namespace collar::server
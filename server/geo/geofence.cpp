@@ -0,0 +1,179 @@
+#include "server/geo/geofence.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace collar::server::geo {
+
+namespace {
+
+BBox ring_bbox(const std::vector<GeoPoint>& ring) {
+    BBox b{INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+    for (const GeoPoint& p : ring) {
+        b.min_lat = std::min(b.min_lat, p.lat_e7);
+        b.min_lon = std::min(b.min_lon, p.lon_e7);
+        b.max_lat = std::max(b.max_lat, p.lat_e7);
+        b.max_lon = std::max(b.max_lon, p.lon_e7);
+    }
+    return b;
+}
+
+BBox merge(const BBox& a, const BBox& b) {
+    return {std::min(a.min_lat, b.min_lat), std::min(a.min_lon, b.min_lon),
+            std::max(a.max_lat, b.max_lat), std::max(a.max_lon, b.max_lon)};
+}
+
+}  // namespace
+
+void PackedRTree::build(const std::vector<BBox>& items) {
+    nodes_.clear();
+    items_.clear();
+    item_boxes_ = items;
+    if (items.empty()) {
+        return;
+    }
+
+    // STR bulk load: sort by longitude, slice into vertical strips, sort
+    // each strip by latitude, pack runs of kFanout into leaves.
+    items_.resize(items.size());
+    for (uint32_t i = 0; i < items.size(); ++i) {
+        items_[i] = i;
+    }
+    auto center_lon = [&](uint32_t i) {
+        return int64_t(items[i].min_lon) + items[i].max_lon;
+    };
+    auto center_lat = [&](uint32_t i) {
+        return int64_t(items[i].min_lat) + items[i].max_lat;
+    };
+    std::sort(items_.begin(), items_.end(),
+              [&](uint32_t a, uint32_t b) { return center_lon(a) < center_lon(b); });
+    const std::size_t n_leaves = (items.size() + kFanout - 1) / kFanout;
+    const std::size_t strip_count =
+        std::size_t(std::ceil(std::sqrt(double(n_leaves))));
+    const std::size_t strip_len =
+        (items.size() + strip_count - 1) / strip_count;
+    for (std::size_t s = 0; s < items.size(); s += strip_len) {
+        const std::size_t e = std::min(s + strip_len, items.size());
+        std::sort(items_.begin() + s, items_.begin() + e,
+                  [&](uint32_t a, uint32_t b) {
+                      return center_lat(a) < center_lat(b);
+                  });
+    }
+
+    // Leaf level.
+    std::vector<uint32_t> level;  // node indices of the level being built
+    for (std::size_t i = 0; i < items.size(); i += kFanout) {
+        const uint16_t count =
+            uint16_t(std::min(kFanout, items.size() - i));
+        BBox b = items[items_[i]];
+        for (uint16_t k = 1; k < count; ++k) {
+            b = merge(b, items[items_[i + k]]);
+        }
+        level.push_back(uint32_t(nodes_.size()));
+        nodes_.push_back({b, uint32_t(i), count, 1});
+    }
+
+    // Inner levels, bottom-up, until one root remains. Children of a node
+    // are contiguous because each level is appended in order.
+    while (level.size() > 1) {
+        std::vector<uint32_t> parents;
+        for (std::size_t i = 0; i < level.size(); i += kFanout) {
+            const uint16_t count =
+                uint16_t(std::min(kFanout, level.size() - i));
+            BBox b = nodes_[level[i]].bbox;
+            for (uint16_t k = 1; k < count; ++k) {
+                b = merge(b, nodes_[level[i + k]].bbox);
+            }
+            parents.push_back(uint32_t(nodes_.size()));
+            nodes_.push_back({b, level[i], count, 0});
+        }
+        level.swap(parents);
+    }
+
+    root_ = level[0];
+}
+
+bool GeofenceEngine::point_in_ring(GeoPoint p,
+                                   const std::vector<GeoPoint>& ring) {
+    // Ray cast east; int64 cross products, no floating point.
+    bool inside = false;
+    const std::size_t n = ring.size();
+    for (std::size_t i = 0, j = n - 1; i < n; j = i++) {
+        const GeoPoint& a = ring[i];
+        const GeoPoint& b = ring[j];
+        if ((a.lat_e7 > p.lat_e7) != (b.lat_e7 > p.lat_e7)) {
+            const int64_t x = int64_t(b.lon_e7 - a.lon_e7) *
+                                  (p.lat_e7 - a.lat_e7) /
+                                  (b.lat_e7 - a.lat_e7) +
+                              a.lon_e7;
+            if (p.lon_e7 < x) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+void GeofenceEngine::add_fence(Fence fence) {
+    boxes_.push_back(ring_bbox(fence.ring));
+    fences_.push_back(std::move(fence));
+}
+
+void GeofenceEngine::build() {
+    tree_.build(boxes_);
+    collars_.clear();  // cached indices are invalidated by a rebuild
+}
+
+uint64_t GeofenceEngine::full_evaluate(GeoPoint fix, uint32_t& idx_out) const {
+    uint64_t found = kNoFence;
+    uint32_t idx = kInvalid;
+    tree_.query(fix, [&](uint32_t i) {
+        if (found == kNoFence && point_in_ring(fix, fences_[i].ring)) {
+            found = fences_[i].fence_id;
+            idx = i;
+        }
+    });
+    idx_out = idx;
+    return found;
+}
+
+GeofenceEngine::Result GeofenceEngine::evaluate(uint64_t collar_id,
+                                                GeoPoint fix) {
+    auto it = collars_.find(collar_id);
+    if (it != collars_.end() && it->second.fence_idx != kInvalid) {
+        CollarGeoState& st = it->second;
+        // Fast path: still within the cached fence's expanded bbox. Only
+        // the one polygon needs testing, and usually only its bbox.
+        if (st.expanded.contains(fix)) {
+            ++fast_hits_;
+            if (boxes_[st.fence_idx].contains(fix) &&
+                point_in_ring(fix, fences_[st.fence_idx].ring)) {
+                return {fences_[st.fence_idx].fence_id, false};
+            }
+            // Inside the margin but outside the polygon: fall through to a
+            // full pass — it may have crossed straight into a neighbour.
+        }
+    }
+
+    ++full_evals_;
+    uint32_t idx;
+    const uint64_t now = full_evaluate(fix, idx);
+    const uint64_t before =
+        (it != collars_.end() && it->second.fence_idx != kInvalid)
+            ? fences_[it->second.fence_idx].fence_id
+            : kNoFence;
+
+    CollarGeoState st;
+    st.fence_idx = idx;
+    if (idx != kInvalid) {
+        st.expanded = boxes_[idx];
+        st.expanded.min_lat -= kMarginE7;
+        st.expanded.min_lon -= kMarginE7;
+        st.expanded.max_lat += kMarginE7;
+        st.expanded.max_lon += kMarginE7;
+    }
+    collars_[collar_id] = st;
+    return {now, now != before};
+}
+
+}  // namespace collar::server::geo
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace collar::server::geo {
+
+// Coordinates are WGS84 degrees * 1e7, the native unit of the GPS fixes the
+// collars upload. int64 intermediate math keeps every predicate exact.
+struct GeoPoint {
+    int32_t lat_e7;
+    int32_t lon_e7;
+};
+
+struct BBox {
+    int32_t min_lat, min_lon, max_lat, max_lon;
+
+    bool contains(GeoPoint p) const {
+        return p.lat_e7 >= min_lat && p.lat_e7 <= max_lat &&
+               p.lon_e7 >= min_lon && p.lon_e7 <= max_lon;
+    }
+    bool intersects(const BBox& o) const {
+        return !(o.min_lat > max_lat || o.max_lat < min_lat ||
+                 o.min_lon > max_lon || o.max_lon < min_lon);
+    }
+};
+
+// Bulk-loaded packed R-tree over fence bounding boxes. All nodes live in
+// one contiguous array, children of a node are a contiguous index range —
+// no per-node allocations, no pointers, and a query's working set is a few
+// sequentially prefetched cache lines. Rebuilt wholesale when the fence set
+// changes (customer edits are rare; fixes are 60k/s).
+class PackedRTree {
+public:
+    static constexpr std::size_t kFanout = 16;
+
+    // items[i] becomes leaf value i.
+    void build(const std::vector<BBox>& items);
+
+    // Invoke fn(item_index) for every item whose bbox contains p.
+    template <typename Fn>
+    void query(GeoPoint p, Fn&& fn) const {
+        if (nodes_.empty()) {
+            return;
+        }
+        query_node(root_, p, fn);
+    }
+
+    std::size_t node_count() const { return nodes_.size(); }
+
+private:
+    struct Node {
+        BBox bbox;
+        uint32_t first;   // child node index, or item index when leaf
+        uint16_t count;   // number of children / items
+        uint16_t leaf;
+    };
+
+    template <typename Fn>
+    void query_node(std::size_t n, GeoPoint p, Fn&& fn) const {
+        const Node& node = nodes_[n];
+        if (!node.bbox.contains(p)) {
+            return;
+        }
+        if (node.leaf) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                if (item_boxes_[items_[node.first + i]].contains(p)) {
+                    fn(items_[node.first + i]);
+                }
+            }
+            return;
+        }
+        for (uint32_t i = 0; i < node.count; ++i) {
+            query_node(node.first + i, p, fn);
+        }
+    }
+
+    std::vector<Node> nodes_;
+    uint32_t root_ = 0;
+    std::vector<uint32_t> items_;     // leaf item indices, STR order
+    std::vector<BBox> item_boxes_;
+};
+
+struct Fence {
+    uint64_t fence_id;
+    std::vector<GeoPoint> ring;  // closed implicitly (last connects to first)
+};
+
+// Incremental geofence evaluator. The full R-tree + point-in-polygon pass
+// runs only when a collar's fix leaves the expanded bounding box of the
+// fence it was last seen inside; the common case — cat asleep in its own
+// garden, fix after fix — is one bbox test.
+class GeofenceEngine {
+public:
+    static constexpr uint64_t kNoFence = 0;
+    // Expansion margin on the cached bbox, in 1e7 degrees (~50 m). Must
+    // exceed fix-to-fix jitter or the fast path never sticks.
+    static constexpr int32_t kMarginE7 = 4500;
+
+    void add_fence(Fence fence);
+    void build();
+
+    struct Result {
+        uint64_t fence_id;  // containing fence after this fix, or kNoFence
+        bool changed;       // fence differs from the previous fix's
+    };
+    Result evaluate(uint64_t collar_id, GeoPoint fix);
+
+    uint64_t fast_path_hits() const { return fast_hits_; }
+    uint64_t full_evaluations() const { return full_evals_; }
+    std::size_t fence_count() const { return fences_.size(); }
+
+    static bool point_in_ring(GeoPoint p, const std::vector<GeoPoint>& ring);
+
+private:
+    struct CollarGeoState {
+        uint32_t fence_idx;     // index into fences_, or kInvalid
+        BBox expanded;          // cached fence bbox + margin
+    };
+    static constexpr uint32_t kInvalid = ~uint32_t(0);
+
+    uint64_t full_evaluate(GeoPoint fix, uint32_t& idx_out) const;
+
+    std::vector<Fence> fences_;
+    std::vector<BBox> boxes_;
+    PackedRTree tree_;
+    std::unordered_map<uint64_t, CollarGeoState> collars_;
+    uint64_t fast_hits_ = 0;
+    uint64_t full_evals_ = 0;
+};
+
+}  // namespace collar::server::geo
@@ -0,0 +1,113 @@
+#include "server/group_commit.h"
+
+#include "instrument/counters.h"
+
+namespace collar::server {
+
+namespace {
+
+instrument::StageCounters& stage_ctr() {
+    return instrument::stage_counters(instrument::Stage::kArchiveWrite);
+}
+
+}  // namespace
+
+GroupCommitWriter::GroupCommitWriter(storage::ArchiveWriter& archive,
+                                     Options opt)
+    : archive_(archive), opt_(opt), flusher_([this] { flusher_loop(); }) {}
+
+GroupCommitWriter::~GroupCommitWriter() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    flusher_.join();
+}
+
+void GroupCommitWriter::submit(uint64_t collar_id,
+                               std::shared_ptr<SampleBatch> batch,
+                               std::function<void()> ack) {
+    bool over = false;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        // Accumulation is measured in raw sample bytes — close enough to
+        // the encoded size for thresholding, and known without encoding.
+        pending_bytes_ += batch->count * sizeof(ImuSample);
+        stage_ctr().add_in(batch->count);
+        queue_.push_back({collar_id, std::move(batch), std::move(ack)});
+        over = pending_bytes_ >= opt_.max_pending_bytes;
+    }
+    cv_.notify_one();
+    (void)over;
+}
+
+void GroupCommitWriter::flush_now() {
+    std::unique_lock<std::mutex> lk(mu_);
+    force_ = true;
+    cv_.notify_all();
+    drained_.wait(lk, [&] { return queue_.empty() && !flushing_; });
+}
+
+void GroupCommitWriter::flusher_loop() {
+    for (;;) {
+        std::unique_lock<std::mutex> lk(mu_);
+        cv_.wait(lk, [&] { return stop_ || force_ || !queue_.empty(); });
+        if (queue_.empty() && stop_) {
+            return;
+        }
+        if (queue_.empty() && force_) {
+            force_ = false;
+            drained_.notify_all();
+            continue;
+        }
+        // The group accumulates until the size threshold or the latency
+        // budget, whichever comes first. Under load the size trips before
+        // the timer; a trickle pays at most max_latency of extra delay.
+        if (!stop_ && !force_ &&
+            pending_bytes_ < opt_.max_pending_bytes) {
+            cv_.wait_for(lk, opt_.max_latency, [&] {
+                return stop_ || force_ ||
+                       pending_bytes_ >= opt_.max_pending_bytes;
+            });
+        }
+        std::vector<Pending> group;
+        group.swap(queue_);
+        pending_bytes_ = 0;
+        force_ = false;
+        flushing_ = true;
+        lk.unlock();
+
+        bool ok = true;
+        for (const Pending& p : group) {
+            ok = archive_.append(p.collar_id, *p.batch) && ok;
+        }
+        ok = archive_.sync() && ok;
+        if (ok) {
+            for (const Pending& p : group) {
+                stage_ctr().add_out(p.batch->count);
+                stage_ctr().add_bytes(p.batch->count * sizeof(ImuSample));
+            }
+            commits_.fetch_add(1, std::memory_order_relaxed);
+            windows_.fetch_add(group.size(), std::memory_order_relaxed);
+            // Durable first, acks second — never the other way around.
+            for (const Pending& p : group) {
+                if (p.ack) {
+                    p.ack();
+                }
+            }
+        }
+        // On failure acks are withheld; the collars keep their flash and
+        // re-upload next sync.
+        if (!ok) {
+            // A stall, not a drop: the unacked windows come back.
+            stage_ctr().add_stalls(1);
+        }
+
+        lk.lock();
+        flushing_ = false;
+        drained_.notify_all();
+    }
+}
+
+}  // namespace collar::server
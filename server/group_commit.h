@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/sample_batch.h"
+#include "storage/archive.h"
+
+namespace collar::server {
+
+// Group-commit front end for the archive: worker threads hand decoded
+// windows to submit() and get their ack callback after the bytes are
+// durable. One flusher thread drains the accumulated batch, appends it to
+// the archive, and pays one sync (data fdatasync plus the segment-meta
+// journal write) for the whole group — on a size threshold under load, on
+// a latency threshold when trickling — so the disk does one flush per
+// group instead of one per upload. The collar erases its flash only after
+// the ack, so acks must never run before the sync returns, and the sync
+// must leave the row groups recoverable even if the daemon dies before a
+// clean ArchiveWriter::close(); both halves of that contract live in
+// ArchiveWriter::sync().
+class GroupCommitWriter {
+public:
+    struct Options {
+        std::size_t max_pending_bytes = 4 << 20;        // flush at 4 MB...
+        std::chrono::milliseconds max_latency{10};      // ...or after 10 ms
+    };
+
+    explicit GroupCommitWriter(storage::ArchiveWriter& archive)
+        : GroupCommitWriter(archive, Options()) {}
+    GroupCommitWriter(storage::ArchiveWriter& archive, Options opt);
+    ~GroupCommitWriter();  // flushes and acks everything pending
+    GroupCommitWriter(const GroupCommitWriter&) = delete;
+    GroupCommitWriter& operator=(const GroupCommitWriter&) = delete;
+
+    // Thread-safe. ack runs on the flusher thread after the group holding
+    // this window is durable; keep it cheap (bump a counter, queue a kAck).
+    void submit(uint64_t collar_id, std::shared_ptr<SampleBatch> batch,
+                std::function<void()> ack);
+
+    // Block until everything submitted so far is durable and acked.
+    void flush_now();
+
+    uint64_t commits() const { return commits_; }
+    uint64_t windows_committed() const { return windows_; }
+
+private:
+    struct Pending {
+        uint64_t collar_id;
+        std::shared_ptr<SampleBatch> batch;
+        std::function<void()> ack;
+    };
+
+    void flusher_loop();
+
+    storage::ArchiveWriter& archive_;
+    Options opt_;
+    std::mutex mu_;
+    std::condition_variable cv_;        // wakes the flusher
+    std::condition_variable drained_;   // wakes flush_now waiters
+    std::vector<Pending> queue_;
+    std::size_t pending_bytes_ = 0;
+    bool stop_ = false;
+    bool force_ = false;
+    bool flushing_ = false;
+    std::atomic<uint64_t> commits_{0};
+    std::atomic<uint64_t> windows_{0};
+    std::thread flusher_;
+};
+
+}  // namespace collar::server
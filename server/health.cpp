@@ -0,0 +1,84 @@
+#include "server/health.h"
+
+#include <cstdlib>
+
+namespace collar::server {
+
+uint8_t HealthMonitor::update(const SampleBatch& batch) {
+    if (batch.count == 0) {
+        return flags_;
+    }
+
+    // Batch activity: mean first-difference magnitude of the accel axes.
+    // Gravity is common-mode across consecutive samples, so this is zero
+    // for a motionless collar regardless of how the cat is lying.
+    int64_t act = 0;
+    for (std::size_t i = 1; i < batch.count; ++i) {
+        act += std::abs(int32_t(batch.ax[i]) - batch.ax[i - 1]);
+        act += std::abs(int32_t(batch.ay[i]) - batch.ay[i - 1]);
+        act += std::abs(int32_t(batch.az[i]) - batch.az[i - 1]);
+    }
+    const int32_t activity =
+        batch.count > 1 ? int32_t(act / (batch.count - 1)) : 0;
+    if (activity_ewma_ < 0) {
+        activity_ewma_ = activity;
+    } else {
+        activity_ewma_ += (activity - activity_ewma_) >> 3;
+    }
+    if (activity_ewma_ < kLethargyActivityLsb) {
+        if (still_batches_ < kLethargyBatches) {
+            ++still_batches_;
+        }
+    } else {
+        still_batches_ = 0;
+    }
+
+    // Batch temperature: mean, then a z-score against the ring window.
+    // All integer — z > kFeverZ is tested as delta^2 > z^2 * variance with
+    // both sides scaled by n^2 to avoid the divisions.
+    int64_t tsum = 0;
+    for (std::size_t i = 0; i < batch.count; ++i) {
+        tsum += batch.temp[i];
+    }
+    const int32_t t = int32_t(tsum / batch.count);
+
+    bool hot = false;
+    if (temp_count_ >= kTempMinSamples) {
+        const int64_t n = temp_count_;
+        const int64_t delta_n = int64_t(t) * n - temp_sum_;  // (t - mean) * n
+        const int64_t var_nn = n * temp_sumsq_ - temp_sum_ * temp_sum_;
+        hot = delta_n > kFeverMinDeltaLsb * n &&
+              delta_n * delta_n > kFeverZ * kFeverZ * var_nn;
+    }
+    if (hot) {
+        if (hot_batches_ < kFeverBatches) {
+            ++hot_batches_;
+        }
+        // A feverish batch is excluded from the ring so the spike cannot
+        // drag its own baseline up and mask itself.
+    } else {
+        hot_batches_ = 0;
+        if (temp_count_ == kTempWindow) {
+            const int32_t old = temps_[temp_head_];
+            temp_sum_ -= old;
+            temp_sumsq_ -= int64_t(old) * old;
+        } else {
+            ++temp_count_;
+        }
+        temps_[temp_head_] = t;
+        temp_sum_ += t;
+        temp_sumsq_ += int64_t(t) * t;
+        temp_head_ = (temp_head_ + 1) % kTempWindow;
+    }
+
+    flags_ = kNone;
+    if (hot_batches_ >= kFeverBatches) {
+        flags_ |= kFever;
+    }
+    if (still_batches_ >= kLethargyBatches) {
+        flags_ |= kLethargy;
+    }
+    return flags_;
+}
+
+}  // namespace collar::server
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/sample_batch.h"
+
+namespace collar::server {
+
+// Streaming per-collar health monitor. One O(1)-amortized update per decoded
+// batch maintains an activity EWMA and a rolling temperature z-score in
+// fixed-size state embedded in the collar's session — no allocation after
+// construction and no archive re-read. Replaces the nightly batch job that
+// recomputed the same statistics from the full day's archive.
+class HealthMonitor {
+public:
+    enum Flag : uint8_t {
+        kNone = 0,
+        kFever = 1 << 0,     // batch temp z-score above kFeverZ, sustained
+        kLethargy = 1 << 1,  // activity EWMA below floor for kLethargyBatches
+    };
+
+    // Ring of per-batch mean temperatures. At 256 samples/batch and 52 Hz
+    // this spans ~10 minutes — long enough for a stable baseline, short
+    // enough to track ambient drift through the day.
+    static constexpr std::size_t kTempWindow = 128;
+    // Warm-up before the z-score is trusted at all.
+    static constexpr uint32_t kTempMinSamples = 32;
+    static constexpr int32_t kFeverZ = 3;
+    // Guard against a near-zero-variance window flagging sensor LSB noise:
+    // the batch must also sit this many raw LSB above the window mean.
+    static constexpr int32_t kFeverMinDeltaLsb = 64;
+    static constexpr uint32_t kFeverBatches = 3;
+
+    // Mean per-sample accel step |d ax|+|d ay|+|d az| below this reads as
+    // "not moving"; gravity cancels in the differences, so orientation
+    // doesn't matter. Tuned against the classifier's rest corpus.
+    static constexpr int32_t kLethargyActivityLsb = 24;
+    static constexpr uint32_t kLethargyBatches = 512;  // ~40 min of stillness
+
+    // Folds one decoded batch in and returns the flags now in effect
+    // (bitwise or of Flag). Empty batches are ignored.
+    uint8_t update(const SampleBatch& batch);
+
+    uint8_t flags() const { return flags_; }
+    int32_t activity_ewma() const { return activity_ewma_; }
+    int32_t temp_mean() const {
+        return temp_count_ ? int32_t(temp_sum_ / temp_count_) : 0;
+    }
+
+private:
+    int32_t temps_[kTempWindow] = {};
+    int64_t temp_sum_ = 0;
+    int64_t temp_sumsq_ = 0;
+    uint32_t temp_count_ = 0;
+    uint32_t temp_head_ = 0;
+    int32_t activity_ewma_ = -1;  // seeded from the first batch
+    uint32_t hot_batches_ = 0;
+    uint32_t still_batches_ = 0;
+    uint8_t flags_ = kNone;
+};
+
+}  // namespace collar::server
@@ -0,0 +1,156 @@
+#include "server/ingest.h"
+
+#include "instrument/counters.h"
+#include "server/group_commit.h"
+#include "server/simd_decode.h"
+
+namespace collar::server {
+
+IngestPipeline::IngestPipeline(ShardedExecutor& exec) : exec_(exec) {
+    shards_.reserve(exec.worker_count());
+    for (std::size_t i = 0; i < exec.worker_count(); ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+void IngestPipeline::on_upload(uint64_t collar_id, const uint8_t* data,
+                               std::size_t len) {
+    const std::size_t pages = len / storage::kFlashPageSize;
+    for (std::size_t p = 0; p < pages; ++p) {
+        // One shared copy of the page per task; decode is stateless and
+        // stealable, the session update hops to the collar's shard.
+        auto page = std::make_shared<std::vector<uint8_t>>(
+            data + p * storage::kFlashPageSize,
+            data + (p + 1) * storage::kFlashPageSize);
+        exec_.submit([this, collar_id, page = std::move(page)] {
+            auto batch = std::make_shared<SampleBatch>();
+            const bool ok = decode_frame_simd(page->data(), *batch);
+            auto& decode_ctr = instrument::stage_counters(
+                instrument::Stage::kIngestDecode);
+            decode_ctr.add_bytes(storage::kFlashPageSize);
+            if (ok) {
+                decode_ctr.add_in(batch->count);
+                decode_ctr.add_out(batch->count);
+            } else {
+                // A rejected page's sample count is unknowable; drops are
+                // counted in frames for this stage.
+                decode_ctr.add_drops(1);
+            }
+            exec_.submit(collar_id,
+                         [this, collar_id, batch = std::move(batch), ok] {
+                Shard& shard = *shards_[exec_.shard_of(collar_id)];
+                CollarSession& s = shard.sessions.get_or_insert(collar_id);
+                if (!ok) {
+                    ++s.bad_frames;
+                    return;
+                }
+                apply_decoded(s, collar_id, batch);
+            });
+        });
+    }
+}
+
+void IngestPipeline::on_dict_upload(uint64_t collar_id, const uint8_t* data,
+                                    std::size_t len) {
+    auto body = std::make_shared<std::vector<uint8_t>>(data, data + len);
+    exec_.submit(collar_id, [this, collar_id, body = std::move(body)] {
+        auto& decode_ctr =
+            instrument::stage_counters(instrument::Stage::kIngestDecode);
+        decode_ctr.add_bytes(body->size());
+        Shard& shard = *shards_[exec_.shard_of(collar_id)];
+        CollarSession& s = shard.sessions.get_or_insert(collar_id);
+        auto batch = std::make_shared<SampleBatch>();
+        if (!proto::dict_window_decode(s.dict, body->data(), body->size(),
+                                       *batch)) {
+            // Version skew or corruption; either way the window is lost
+            // and the collar should re-sync its dictionary.
+            decode_ctr.add_drops(1);
+            ++s.bad_frames;
+            return;
+        }
+        decode_ctr.add_in(batch->count);
+        decode_ctr.add_out(batch->count);
+        apply_decoded(s, collar_id, batch);
+    });
+}
+
+void IngestPipeline::apply_decoded(CollarSession& s, uint64_t collar_id,
+                                   const std::shared_ptr<SampleBatch>& batch) {
+    ++s.frames;
+    s.samples += batch->count;
+    s.last_base_tick = batch->base_tick;
+    // Health stage: between decode and archive write, on the collar's own
+    // shard so the monitor state needs no lock.
+    auto& anomaly_ctr =
+        instrument::stage_counters(instrument::Stage::kAnomaly);
+    anomaly_ctr.add_in(batch->count);
+    const uint8_t before = s.health.flags();
+    const uint8_t now = s.health.update(*batch);
+    anomaly_ctr.add_out(batch->count);
+    const uint8_t risen = uint8_t(now & ~before);
+    if (risen & HealthMonitor::kFever) {
+        ++s.fever_alerts;
+    }
+    if (risen & HealthMonitor::kLethargy) {
+        ++s.lethargy_alerts;
+    }
+    if (risen) {
+        total_health_alerts_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Dictionary training rides the same shard-owned pass.
+    s.dict_trainer.observe(*batch);
+    if (s.dict.version == 0 && s.dict_trainer.ready()) {
+        // Seqlock write: odd while the table is being installed. The
+        // acq_rel/release bumps keep the payload stores between the marks
+        // for the reactor-thread reader in dict().
+        s.dict_seq.fetch_add(1, std::memory_order_acq_rel);
+        s.dict = s.dict_trainer.build(1);
+        s.dict_seq.fetch_add(1, std::memory_order_release);
+    }
+    total_frames_.fetch_add(1, std::memory_order_relaxed);
+    total_samples_.fetch_add(batch->count, std::memory_order_relaxed);
+    if (writer_ != nullptr) {
+        writer_->submit(collar_id, batch, [this] {
+            total_durable_.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+}
+
+void IngestPipeline::on_wire_frame(const proto::WireHeader& h,
+                                   const uint8_t* payload, std::size_t len) {
+    // kHello and kAck carry no samples; only upload frames make work.
+    if (h.kind == proto::kPages) {
+        on_upload(h.collar_id, payload, len);
+    } else if (h.kind == proto::kDictPages) {
+        on_dict_upload(h.collar_id, payload, len);
+    }
+}
+
+CollarSession IngestPipeline::session(uint64_t collar_id) const {
+    epoch::Guard guard;
+    const Shard& shard = *shards_[exec_.shard_of(collar_id)];
+    const CollarSession* s = shard.sessions.find(collar_id);
+    return s ? *s : CollarSession{};
+}
+
+proto::DeltaDict IngestPipeline::dict(uint64_t collar_id) const {
+    epoch::Guard guard;
+    const Shard& shard = *shards_[exec_.shard_of(collar_id)];
+    const CollarSession* s = shard.sessions.find(collar_id);
+    if (s == nullptr) {
+        return proto::DeltaDict{};
+    }
+    for (;;) {
+        const uint32_t before = s->dict_seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;  // mid-install; the writer is one brief shard task
+        }
+        const proto::DeltaDict d = s->dict;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s->dict_seq.load(std::memory_order_relaxed) == before) {
+            return d;
+        }
+    }
+}
+
+}  // namespace collar::server
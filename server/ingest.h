@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/sample_batch.h"
+#include "proto/dict.h"
+#include "proto/wire.h"
+#include "server/collar_map.h"
+#include "server/dict_trainer.h"
+#include "server/executor.h"
+#include "server/health.h"
+#include "storage/frame.h"
+
+namespace collar::server {
+
+// Per-collar session state, owned exclusively by one executor shard —
+// touched only from collar-pinned tasks, so no lock. Grows alongside the
+// protocol (decode dictionary, battery trend).
+struct CollarSession {
+    uint64_t frames = 0;
+    uint64_t samples = 0;
+    uint64_t bad_frames = 0;
+    uint64_t last_base_tick = 0;
+    HealthMonitor health;
+    uint32_t fever_alerts = 0;     // rising edges of HealthMonitor::kFever
+    uint32_t lethargy_alerts = 0;  // rising edges of HealthMonitor::kLethargy
+    // Compression dictionary state: the trainer keeps learning, dict holds
+    // the version last built — shipped to the collar in a kDict frame at
+    // the next sync (dict.version == 0 until trained).
+    DictTrainer dict_trainer;
+    proto::DeltaDict dict{};
+    // Seqlock over dict (odd = install in progress): the listener reads it
+    // from the reactor thread to answer a hello while the owning shard may
+    // be installing a newly trained table. The rest of the session
+    // tolerates a torn snapshot; a torn dictionary would pass the version
+    // check on both ends and then silently misdecode every kDictPages
+    // window. Read through IngestPipeline::dict(), never session().
+    std::atomic<uint32_t> dict_seq{0};
+
+    CollarSession() = default;
+    // Snapshot copies, for session() and the collar map's growth path;
+    // only the live shard-owned row's seqlock is ever bumped.
+    CollarSession(const CollarSession& o) { *this = o; }
+    CollarSession& operator=(const CollarSession& o) {
+        frames = o.frames;
+        samples = o.samples;
+        bad_frames = o.bad_frames;
+        last_base_tick = o.last_base_tick;
+        health = o.health;
+        fever_alerts = o.fever_alerts;
+        lethargy_alerts = o.lethargy_alerts;
+        dict_trainer = o.dict_trainer;
+        dict = o.dict;
+        dict_seq.store(o.dict_seq.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+        return *this;
+    }
+};
+
+// Decode front end of collar_ingestd: takes a raw upload (a run of 4 KB
+// flash pages, exactly as the collar shipped them), fans stateless frame
+// decodes out across the executor's shared queues, and lands per-collar
+// state updates on the collar's own shard.
+class GroupCommitWriter;
+
+class IngestPipeline {
+public:
+    explicit IngestPipeline(ShardedExecutor& exec);
+
+    // Optional archive back end. When set, every decoded window is handed
+    // to the group-commit writer and the upload counts as acked only once
+    // its group is durable. Set before the first upload; not hot-swappable.
+    void set_group_writer(GroupCommitWriter* writer) { writer_ = writer; }
+
+    // Upload body must be a whole number of flash pages. The buffer is
+    // copied out of the connection before the tasks run, so the socket
+    // layer may reuse it immediately.
+    void on_upload(uint64_t collar_id, const uint8_t* data, std::size_t len);
+
+    // Dict-coded upload body: one proto::dict_window_encode window. Unlike
+    // page decode this is not stealable — the dictionary is session state —
+    // so the whole task lands on the collar's shard. A version mismatch
+    // (stale or unknown dictionary) counts as a bad frame; the collar falls
+    // back to kPages until the next kDict re-sync. Copies like on_upload.
+    void on_dict_upload(uint64_t collar_id, const uint8_t* data,
+                        std::size_t len);
+
+    // Wire-protocol v2 entry point: one parsed frame straight off a
+    // connection (hook this up as the WireParser callback). The payload
+    // span only needs to outlive the call — kPages routes through
+    // on_upload, which copies the pages before returning.
+    void on_wire_frame(const proto::WireHeader& h, const uint8_t* payload,
+                       std::size_t len);
+
+    // Lock-free read of one collar's session from any thread (epoch-guarded
+    // under the hood). Counters may be mid-update; drain() the executor
+    // first if exact numbers matter. Returns a default session for unknown
+    // collars. The dictionary in the copy may be torn mid-install — ship
+    // only what dict() returns.
+    CollarSession session(uint64_t collar_id) const;
+
+    // Consistent read of one collar's dictionary from any thread: retries
+    // the session's seqlock until the copy is stable, so the returned
+    // table is never a mix of two generations. Version 0 for unknown or
+    // untrained collars.
+    proto::DeltaDict dict(uint64_t collar_id) const;
+
+    uint64_t total_frames() const {
+        return total_frames_.load(std::memory_order_relaxed);
+    }
+    uint64_t total_samples() const {
+        return total_samples_.load(std::memory_order_relaxed);
+    }
+    uint64_t total_health_alerts() const {
+        return total_health_alerts_.load(std::memory_order_relaxed);
+    }
+    // Windows whose archive group has hit disk; what the ack path to the
+    // collars will drain once the listener lands.
+    uint64_t total_durable() const {
+        return total_durable_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Shard {
+        // Written only by the owning executor shard; read lock-free from
+        // anywhere via epoch guards.
+        CollarMap<CollarSession> sessions;
+    };
+
+    // Session update shared by the page and dict decode paths. Must run on
+    // collar_id's shard; s is that shard's session row.
+    void apply_decoded(CollarSession& s, uint64_t collar_id,
+                       const std::shared_ptr<SampleBatch>& batch);
+
+    ShardedExecutor& exec_;
+    GroupCommitWriter* writer_ = nullptr;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> total_frames_{0};
+    std::atomic<uint64_t> total_samples_{0};
+    std::atomic<uint64_t> total_health_alerts_{0};
+    std::atomic<uint64_t> total_durable_{0};
+};
+
+}  // namespace collar::server
@@ -0,0 +1,174 @@
+#include "server/listener.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "proto/wire.h"
+#include "proto/wire_parser.h"
+
+namespace collar::server {
+
+namespace {
+
+// One socket read's worth of upload stream. Big enough that a full 64-page
+// sync burst arrives in a handful of reads; small enough that ten thousand
+// parked connections stay cheap (the buffer lives in the coroutine frame's
+// heap allocation only while the connection is being served).
+constexpr std::size_t kRecvChunk = 64 * 1024;
+
+bool set_nonblocking(int fd) {
+    const int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+}  // namespace
+
+IngestListener::~IngestListener() {
+    if (listen_fd_ >= 0) {
+        reactor_.forget(listen_fd_);
+        ::close(listen_fd_);
+    }
+}
+
+bool IngestListener::listen(uint16_t port) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0 || !set_nonblocking(listen_fd_)) {
+        return false;
+    }
+    const int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr),
+               sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 4096) != 0) {
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    accept_loop();
+    return true;
+}
+
+ota::DetachedTask IngestListener::accept_loop() {
+    for (;;) {
+        co_await reactor_.readable(listen_fd_);
+        for (;;) {
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr,
+                                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                break;  // EAGAIN: armed again at the top of the loop
+            }
+            ++connections_;
+            serve(fd);
+        }
+    }
+}
+
+ota::DetachedTask IngestListener::serve(int fd) {
+    const auto buf = std::make_unique<uint8_t[]>(kRecvChunk);
+    // Collar ids whose frames were accepted by the last feed(); drained
+    // into kAck frames after the parse so the callback stays trivial.
+    // Hellos are also noted separately: a collar announcing itself gets the
+    // current trained dictionary (if any) pushed right after its ack.
+    std::vector<uint64_t> to_ack;
+    std::vector<uint64_t> to_dict;
+    proto::WireParser parser([this, &to_ack, &to_dict](
+                                 const proto::WireHeader& h,
+                                 const uint8_t* payload, std::size_t len) {
+        pipeline_.on_wire_frame(h, payload, len);
+        ++frames_;
+        if (h.kind == proto::kHello || h.kind == proto::kPages ||
+            h.kind == proto::kDictPages) {
+            to_ack.push_back(h.collar_id);
+        }
+        if (h.kind == proto::kHello) {
+            to_dict.push_back(h.collar_id);
+        }
+    });
+
+    uint8_t ack_buf[proto::kWireHeaderSize];
+    for (;;) {
+        const ssize_t n = ::recv(fd, buf.get(), kRecvChunk, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            goto done;  // client hung up or hard error
+        }
+        if (n < 0) {
+            co_await reactor_.readable(fd);
+            continue;
+        }
+        if (!parser.feed(buf.get(), std::size_t(n))) {
+            goto done;  // protocol violation: drop, there is no resync
+        }
+        for (std::size_t a = 0; a < to_ack.size(); ++a) {
+            proto::WireHeader ack{};
+            ack.magic = proto::kWireMagic;
+            ack.version = proto::kWireVersion;
+            ack.kind = proto::kAck;
+            ack.collar_id = to_ack[a];
+            proto::encode_header(ack, ack_buf);
+            std::size_t sent = 0;
+            while (sent < sizeof(ack_buf)) {
+                const ssize_t s = ::send(fd, ack_buf + sent,
+                                         sizeof(ack_buf) - sent, MSG_NOSIGNAL);
+                if (s > 0) {
+                    sent += std::size_t(s);
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await reactor_.writable(fd);
+                } else {
+                    goto done;
+                }
+            }
+        }
+        to_ack.clear();
+        for (std::size_t d = 0; d < to_dict.size(); ++d) {
+            // dict() is the seqlocked read — a session() snapshot could
+            // tear mid-install and ship a table mixing two generations.
+            // Version 0 means the trainer has not seen enough windows yet,
+            // so the collar stays on plain kPages and no frame is sent.
+            const proto::DeltaDict dict = pipeline_.dict(to_dict[d]);
+            if (dict.version == 0) {
+                continue;
+            }
+            uint8_t dict_msg[proto::kWireHeaderSize +
+                             sizeof(proto::DeltaDict)];
+            uint8_t dict_hdr[proto::kWireHeaderSize];
+            proto::SgSpan iov[2];
+            proto::dict_frame_sg(dict_hdr, to_dict[d], dict, iov);
+            std::memcpy(dict_msg, iov[0].data, iov[0].len);
+            std::memcpy(dict_msg + iov[0].len, iov[1].data, iov[1].len);
+            std::size_t sent = 0;
+            while (sent < sizeof(dict_msg)) {
+                const ssize_t s = ::send(fd, dict_msg + sent,
+                                         sizeof(dict_msg) - sent,
+                                         MSG_NOSIGNAL);
+                if (s > 0) {
+                    sent += std::size_t(s);
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await reactor_.writable(fd);
+                } else {
+                    goto done;
+                }
+            }
+        }
+        to_dict.clear();
+    }
+done:
+    reactor_.forget(fd);
+    ::close(fd);
+}
+
+}  // namespace collar::server
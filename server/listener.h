@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+#include "server/ingest.h"
+#include "server/ota/reactor.h"
+
+namespace collar::server {
+
+// TCP termination for the v2 upload wire protocol: coroutine-per-connection
+// on the epoll reactor (grown for the OTA server, shared here — one loop
+// thread carries both services in a deployment). Each connection owns a
+// WireParser whose frames feed IngestPipeline::on_wire_frame; every kHello,
+// kPages and kDictPages frame is answered with a kAck once it is in the
+// pipeline's hands, and a kHello from a collar whose session holds a trained
+// dictionary is additionally answered with a kDict frame carrying it — the
+// collar encodes subsequent uploads as kDictPages, with plain kPages as the
+// version-0 fallback. The decode itself is sharded across the executor, so
+// the reactor thread only parses headers and moves bytes.
+//
+// Ack timing: today an ack means "parsed and queued" — coupling acks to
+// group-commit durability needs a cross-thread reactor wake (the flusher
+// thread cannot write a reactor-owned socket), and lands together with the
+// ack-drain work. The loadgen harness therefore measures termination and
+// dispatch latency, which is where the evening-storm limits live.
+class IngestListener {
+public:
+    IngestListener(ota::Reactor& reactor, IngestPipeline& pipeline)
+        : reactor_(reactor), pipeline_(pipeline) {}
+    ~IngestListener();
+    IngestListener(const IngestListener&) = delete;
+    IngestListener& operator=(const IngestListener&) = delete;
+
+    // Bind and start accepting. port 0 picks an ephemeral port (tests);
+    // call port() afterwards for the bound value.
+    bool listen(uint16_t port);
+    uint16_t port() const { return port_; }
+
+    uint64_t connections_served() const { return connections_; }
+    uint64_t frames_received() const { return frames_; }
+
+private:
+    ota::DetachedTask accept_loop();
+    ota::DetachedTask serve(int fd);
+
+    ota::Reactor& reactor_;
+    IngestPipeline& pipeline_;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    uint64_t connections_ = 0;
+    uint64_t frames_ = 0;
+};
+
+}  // namespace collar::server
@@ -0,0 +1,92 @@
+// collar_ingestd — upload termination daemon for the collar fleet.
+//
+// Wires the wire-protocol listener, the sharded decode pipeline and the
+// group-commit archive back end together. Without --port it still comes up
+// headless (the shape the ops playbooks referenced before the listener
+// landed); with --port it terminates v2 uploads on loopback, which is what
+// the collar_loadgen harness drives.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "server/executor.h"
+#include "server/group_commit.h"
+#include "server/ingest.h"
+#include "server/listener.h"
+#include "server/metrics.h"
+#include "server/ota/reactor.h"
+#include "storage/archive.h"
+
+int main(int argc, char** argv) {
+    std::size_t workers = std::thread::hardware_concurrency();
+    const char* archive_path = nullptr;
+    int port = -1;
+    int metrics_port = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = std::size_t(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--archive") == 0 && i + 1 < argc) {
+            archive_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--metrics-port") == 0 &&
+                   i + 1 < argc) {
+            metrics_port = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--workers N] [--archive PATH] "
+                         "[--port P] [--metrics-port M]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    collar::server::ShardedExecutor exec(workers);
+    collar::server::IngestPipeline pipeline(exec);
+
+    collar::storage::ArchiveWriter archive;
+    std::unique_ptr<collar::server::GroupCommitWriter> group;
+    if (archive_path != nullptr) {
+        if (!archive.open(archive_path)) {
+            std::fprintf(stderr, "cannot open archive %s\n", archive_path);
+            return 1;
+        }
+        group = std::make_unique<collar::server::GroupCommitWriter>(archive);
+        pipeline.set_group_writer(group.get());
+    }
+
+    if (port < 0 && metrics_port < 0) {
+        std::printf("collar_ingestd: %zu workers%s, no --port, idle\n",
+                    exec.worker_count(),
+                    archive_path ? ", group-commit archive" : "");
+        return 0;
+    }
+
+    collar::server::ota::Reactor reactor;
+    collar::server::IngestListener listener(reactor, pipeline);
+    if (port >= 0) {
+        if (!listener.listen(uint16_t(port))) {
+            std::fprintf(stderr, "cannot listen on port %d\n", port);
+            return 1;
+        }
+        std::printf("collar_ingestd: %zu workers%s, listening on %u\n",
+                    exec.worker_count(),
+                    archive_path ? ", group-commit archive" : "",
+                    unsigned(listener.port()));
+    }
+    collar::server::MetricsListener metrics(reactor);
+    if (metrics_port >= 0) {
+        if (!metrics.listen(uint16_t(metrics_port))) {
+            std::fprintf(stderr, "cannot listen on metrics port %d\n",
+                         metrics_port);
+            return 1;
+        }
+        std::printf("collar_ingestd: metrics on %u\n",
+                    unsigned(metrics.port()));
+    }
+    reactor.run();
+    return 0;
+}
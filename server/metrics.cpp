@@ -0,0 +1,144 @@
+#include "server/metrics.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "instrument/counters.h"
+
+namespace collar::server {
+
+namespace {
+
+// 30 counter lines plus TYPE headers is well under 4 KB today; the size
+// check in counters_prometheus keeps a future stage from silently
+// truncating the scrape.
+constexpr std::size_t kBodyCap = 4096;
+
+// End of the request head: a blank line, with or without carriage returns.
+bool head_complete(const uint8_t* p, std::size_t n) {
+    for (std::size_t i = 1; i < n; ++i) {
+        if (p[i] == '\n' &&
+            (p[i - 1] == '\n' ||
+             (i >= 3 && p[i - 1] == '\r' && p[i - 2] == '\n'))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool set_nonblocking(int fd) {
+    const int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+}  // namespace
+
+MetricsListener::~MetricsListener() {
+    if (listen_fd_ >= 0) {
+        reactor_.forget(listen_fd_);
+        ::close(listen_fd_);
+    }
+}
+
+bool MetricsListener::listen(uint16_t port) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0 || !set_nonblocking(listen_fd_)) {
+        return false;
+    }
+    const int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr),
+               sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 64) != 0) {
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    accept_loop();
+    return true;
+}
+
+ota::DetachedTask MetricsListener::accept_loop() {
+    for (;;) {
+        co_await reactor_.readable(listen_fd_);
+        for (;;) {
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr,
+                                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                break;  // EAGAIN: armed again at the top of the loop
+            }
+            serve(fd);
+        }
+    }
+}
+
+ota::DetachedTask MetricsListener::serve(int fd) {
+    // Read until the blank line ends the request head. The request itself
+    // is discarded: every path gets the counter table.
+    uint8_t req[1024];
+    std::size_t got = 0;
+    while (got < sizeof(req)) {
+        const ssize_t n = ::recv(fd, req + got, sizeof(req) - got, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            goto done;
+        }
+        if (n < 0) {
+            co_await reactor_.readable(fd);
+            continue;
+        }
+        got += std::size_t(n);
+        if (head_complete(req, got)) {
+            break;
+        }
+    }
+
+    {
+        char body[kBodyCap];
+        const std::size_t body_len =
+            instrument::counters_prometheus(body, sizeof(body));
+        char head[160];
+        const int head_len = std::snprintf(
+            head, sizeof(head),
+            "HTTP/1.0 200 OK\r\n"
+            "Content-Type: text/plain; version=0.0.4\r\n"
+            "Content-Length: %zu\r\n"
+            "Connection: close\r\n\r\n",
+            body_len);
+        char out[kBodyCap + sizeof(head)];
+        std::memcpy(out, head, std::size_t(head_len));
+        std::memcpy(out + head_len, body, body_len);
+        const std::size_t total = std::size_t(head_len) + body_len;
+        std::size_t sent = 0;
+        while (sent < total) {
+            const ssize_t s =
+                ::send(fd, out + sent, total - sent, MSG_NOSIGNAL);
+            if (s > 0) {
+                sent += std::size_t(s);
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                co_await reactor_.writable(fd);
+            } else {
+                goto done;
+            }
+        }
+        ++scrapes_;
+    }
+done:
+    reactor_.forget(fd);
+    ::close(fd);
+}
+
+}  // namespace collar::server
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "server/ota/reactor.h"
+
+namespace collar::server {
+
+// Prometheus scrape endpoint for collar_ingestd: a minimal HTTP/1.0
+// responder on the shared epoll reactor that answers every request with
+// the stage-counter table in text exposition format and closes. One
+// scrape every fifteen seconds from one Prometheus does not deserve a
+// real HTTP stack; the request line is read and discarded, which is
+// exactly what node_exporter-class endpoints get away with too.
+class MetricsListener {
+public:
+    explicit MetricsListener(ota::Reactor& reactor) : reactor_(reactor) {}
+    ~MetricsListener();
+    MetricsListener(const MetricsListener&) = delete;
+    MetricsListener& operator=(const MetricsListener&) = delete;
+
+    // Bind and start serving. port 0 picks an ephemeral port (tests);
+    // call port() afterwards for the bound value.
+    bool listen(uint16_t port);
+    uint16_t port() const { return port_; }
+
+    uint64_t scrapes() const { return scrapes_; }
+
+private:
+    ota::DetachedTask accept_loop();
+    ota::DetachedTask serve(int fd);
+
+    ota::Reactor& reactor_;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    uint64_t scrapes_ = 0;
+};
+
+}  // namespace collar::server
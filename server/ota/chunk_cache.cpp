@@ -0,0 +1,50 @@
+#include "server/ota/chunk_cache.h"
+
+#include "storage/frame.h"  // crc32c
+
+namespace collar::server::ota {
+
+using collar::ota::kOtaChunkSize;
+
+void ChunkCache::add_release(uint32_t release_id,
+                             std::vector<uint8_t> image) {
+    std::lock_guard lk(mu_);
+    Release& r = releases_[release_id];
+    r.image = std::move(image);
+    r.image_crc = storage::crc32c(r.image.data(), r.image.size());
+    r.chunks.clear();
+}
+
+bool ChunkCache::get(uint32_t release_id, uint32_t offset, Chunk& out) {
+    std::lock_guard lk(mu_);
+    auto rit = releases_.find(release_id);
+    if (rit == releases_.end()) {
+        return false;
+    }
+    Release& r = rit->second;
+    if (offset % kOtaChunkSize != 0 || offset >= r.image.size()) {
+        return false;
+    }
+    auto cit = r.chunks.find(offset);
+    if (cit != r.chunks.end()) {
+        ++hits_;
+        out = cit->second;
+        return true;
+    }
+    ++misses_;
+    const uint32_t len = uint32_t(
+        std::min<std::size_t>(kOtaChunkSize, r.image.size() - offset));
+    auto data = std::make_shared<const std::vector<uint8_t>>(
+        r.image.begin() + offset, r.image.begin() + offset + len);
+    Chunk c;
+    c.data = data;
+    c.offset = offset;
+    c.crc = storage::crc32c(data->data(), data->size());
+    c.image_size = uint32_t(r.image.size());
+    c.image_crc = r.image_crc;
+    r.chunks.emplace(offset, c);
+    out = c;
+    return true;
+}
+
+}  // namespace collar::server::ota
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ota/protocol.h"
+
+namespace collar::server::ota {
+
+// In-memory firmware chunk cache keyed by (release, offset). A fleet-wide
+// rollout has 180k collars asking for the same few thousand chunks; serving
+// them out of shared ref-counted buffers means the image is read and sliced
+// once, not once per client, and a chunk stays alive exactly as long as
+// some connection is still sending it.
+class ChunkCache {
+public:
+    struct Chunk {
+        std::shared_ptr<const std::vector<uint8_t>> data;
+        uint32_t offset = 0;
+        uint32_t crc = 0;         // CRC-32C of data
+        uint32_t image_size = 0;
+        uint32_t image_crc = 0;
+    };
+
+    // Register a release image. Typically called once at rollout start.
+    void add_release(uint32_t release_id, std::vector<uint8_t> image);
+
+    // Fetch the chunk covering offset (which must be kOtaChunkSize-aligned).
+    // Returns false for unknown releases or offsets past the image end.
+    bool get(uint32_t release_id, uint32_t offset, Chunk& out);
+
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    struct Release {
+        std::vector<uint8_t> image;
+        uint32_t image_crc = 0;
+        // Sliced lazily: most rollouts never ship the whole image to the
+        // first client before others start asking for the same chunks.
+        std::map<uint32_t, Chunk> chunks;
+    };
+
+    std::mutex mu_;
+    std::map<uint32_t, Release> releases_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+}  // namespace collar::server::ota
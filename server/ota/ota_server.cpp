@@ -0,0 +1,138 @@
+#include "server/ota/ota_server.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace collar::server::ota {
+
+using collar::ota::OtaChunkHeader;
+using collar::ota::OtaRequest;
+
+namespace {
+
+bool set_nonblocking(int fd) {
+    const int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+}  // namespace
+
+OtaServer::~OtaServer() {
+    if (listen_fd_ >= 0) {
+        reactor_.forget(listen_fd_);
+        ::close(listen_fd_);
+    }
+}
+
+bool OtaServer::listen(uint16_t port) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0 || !set_nonblocking(listen_fd_)) {
+        return false;
+    }
+    const int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr),
+               sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 1024) != 0) {
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    accept_loop();
+    return true;
+}
+
+DetachedTask OtaServer::accept_loop() {
+    for (;;) {
+        co_await reactor_.readable(listen_fd_);
+        for (;;) {
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr,
+                                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                break;  // EAGAIN: armed again at the top of the loop
+            }
+            ++connections_;
+            serve(fd);
+        }
+    }
+}
+
+DetachedTask OtaServer::serve(int fd) {
+    uint8_t req_buf[sizeof(OtaRequest)];
+    for (;;) {
+        // Read one full request (tiny, but TCP may still split it).
+        std::size_t got = 0;
+        while (got < sizeof(req_buf)) {
+            const ssize_t n =
+                ::recv(fd, req_buf + got, sizeof(req_buf) - got, 0);
+            if (n > 0) {
+                got += std::size_t(n);
+            } else if (n == 0 ||
+                       (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                goto done;  // client hung up or hard error
+            } else {
+                co_await reactor_.readable(fd);
+            }
+        }
+
+        OtaRequest req;
+        std::memcpy(&req, req_buf, sizeof(req));
+        OtaChunkHeader hdr{};
+        hdr.magic = OtaChunkHeader::kMagic;
+        hdr.release_id = req.release_id;
+        hdr.offset = req.offset;
+
+        ChunkCache::Chunk chunk;
+        const bool ok = req.magic == OtaRequest::kMagic &&
+                        cache_.get(req.release_id, req.offset, chunk);
+        if (ok) {
+            hdr.len = uint32_t(chunk.data->size());
+            hdr.crc = chunk.crc;
+            hdr.image_size = chunk.image_size;
+            hdr.image_crc = chunk.image_crc;
+        }
+
+        // Send header + payload; the chunk's shared_ptr keeps the bytes
+        // alive across however many suspensions the socket needs.
+        uint8_t hdr_buf[sizeof(hdr)];
+        std::memcpy(hdr_buf, &hdr, sizeof(hdr));
+        const uint8_t* parts[2] = {hdr_buf,
+                                   ok ? chunk.data->data() : nullptr};
+        const std::size_t lens[2] = {sizeof(hdr), ok ? chunk.data->size() : 0};
+        for (int part = 0; part < 2; ++part) {
+            std::size_t sent = 0;
+            while (sent < lens[part]) {
+                const ssize_t n = ::send(fd, parts[part] + sent,
+                                         lens[part] - sent, MSG_NOSIGNAL);
+                if (n > 0) {
+                    sent += std::size_t(n);
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    co_await reactor_.writable(fd);
+                } else {
+                    goto done;
+                }
+            }
+        }
+        if (ok) {
+            ++chunks_sent_;
+        }
+    }
+done:
+    reactor_.forget(fd);
+    ::close(fd);
+}
+
+}  // namespace collar::server::ota
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "server/ota/chunk_cache.h"
+#include "server/ota/reactor.h"
+
+namespace collar::server::ota {
+
+// Coroutine-per-connection OTA distribution server. Each accepted
+// connection runs one handler coroutine: read an OtaRequest, look the chunk
+// up in the shared cache, stream it out, repeat until the client hangs up.
+// All I/O suspends into the reactor, so concurrency is bounded by memory
+// (a suspended transfer is one coroutine frame plus one shared chunk ref),
+// not by threads.
+class OtaServer {
+public:
+    OtaServer(Reactor& reactor, ChunkCache& cache)
+        : reactor_(reactor), cache_(cache) {}
+    ~OtaServer();
+
+    // Bind and start accepting. port 0 picks an ephemeral port (tests);
+    // call port() afterwards for the bound value.
+    bool listen(uint16_t port);
+    uint16_t port() const { return port_; }
+
+    uint64_t connections_served() const { return connections_; }
+    uint64_t chunks_sent() const { return chunks_sent_; }
+
+private:
+    DetachedTask accept_loop();
+    DetachedTask serve(int fd);
+
+    Reactor& reactor_;
+    ChunkCache& cache_;
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    uint64_t connections_ = 0;
+    uint64_t chunks_sent_ = 0;
+};
+
+}  // namespace collar::server::ota
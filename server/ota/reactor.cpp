@@ -0,0 +1,79 @@
+#include "server/ota/reactor.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+namespace collar::server::ota {
+
+Reactor::Reactor() {
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+}
+
+Reactor::~Reactor() {
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+}
+
+Reactor::FdAwaitable Reactor::readable(int fd) {
+    return FdAwaitable(*this, fd, EPOLLIN);
+}
+
+Reactor::FdAwaitable Reactor::writable(int fd) {
+    return FdAwaitable(*this, fd, EPOLLOUT);
+}
+
+void Reactor::arm(int fd, uint32_t events, std::coroutine_handle<> h) {
+    epoll_event ev{};
+    ev.events = events | EPOLLONESHOT;
+    ev.data.fd = fd;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) != 0) {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+    waiters_[fd] = h;
+}
+
+void Reactor::forget(int fd) {
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    waiters_.erase(fd);
+}
+
+void Reactor::run() {
+    epoll_event events[64];
+    while (!stopping_) {
+        const int n = ::epoll_wait(epoll_fd_, events, 64, -1);
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t tok;
+                [[maybe_unused]] ssize_t r = ::read(wake_fd_, &tok, sizeof(tok));
+                continue;
+            }
+            auto it = waiters_.find(fd);
+            if (it == waiters_.end()) {
+                continue;  // connection closed between ready and resume
+            }
+            const std::coroutine_handle<> h = it->second;
+            waiters_.erase(it);
+            h.resume();
+        }
+    }
+    stopping_ = false;
+}
+
+void Reactor::stop() {
+    stopping_ = true;
+    const uint64_t one = 1;
+    [[maybe_unused]] ssize_t r = ::write(wake_fd_, &one, sizeof(one));
+}
+
+}  // namespace collar::server::ota
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <unordered_map>
+
+namespace collar::server::ota {
+
+// Minimal epoll reactor for the coroutine-per-connection OTA server. One
+// thread calls run(); connection coroutines co_await readable()/writable()
+// and are resumed by the loop when the fd is ready. A suspended coroutine
+// costs a few hundred bytes of frame, which is what lets one process hold
+// tens of thousands of in-flight transfers where a thread-per-connection
+// design topples over.
+//
+// One waiter per fd at a time — exactly the shape of a request/response
+// transfer coroutine.
+class Reactor {
+public:
+    Reactor();
+    ~Reactor();
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    class FdAwaitable {
+    public:
+        FdAwaitable(Reactor& r, int fd, uint32_t events)
+            : r_(r), fd_(fd), events_(events) {}
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            r_.arm(fd_, events_, h);
+        }
+        void await_resume() const {}
+
+    private:
+        Reactor& r_;
+        int fd_;
+        uint32_t events_;
+    };
+
+    FdAwaitable readable(int fd);
+    FdAwaitable writable(int fd);
+
+    // Forget a (closed) fd. Safe to call for fds that were never armed.
+    void forget(int fd);
+
+    // Event loop; returns after stop(). Runs pending resumptions inline.
+    void run();
+
+    // Thread-safe: wakes the loop and makes run() return.
+    void stop();
+
+private:
+    void arm(int fd, uint32_t events, std::coroutine_handle<> h);
+
+    int epoll_fd_;
+    int wake_fd_;
+    std::atomic<bool> stopping_{false};
+    std::unordered_map<int, std::coroutine_handle<>> waiters_;
+};
+
+// Fire-and-forget coroutine type for connection handlers: starts eagerly,
+// cleans itself up at the final suspend point.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+}  // namespace collar::server::ota
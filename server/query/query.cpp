@@ -0,0 +1,167 @@
+#include "server/query/query.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "core/sample_batch.h"
+
+namespace collar::server::query {
+
+namespace {
+
+bool collar_qualifies(const Predicate& p, uint64_t collar_id) {
+    if (p.collars.empty()) {
+        return true;
+    }
+    for (uint64_t c : p.collars) {
+        if (c == collar_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+#if defined(__AVX2__)
+
+std::size_t count_in_range(const int16_t* v, std::size_t n, int16_t lo,
+                           int16_t hi) {
+    // v in [lo, hi] as !(lo > v) && !(v > hi): two compares, one OR, and a
+    // popcount of the misses — no off-by-one traps at the int16 extremes.
+    const __m256i vlo = _mm256_set1_epi16(lo);
+    const __m256i vhi = _mm256_set1_epi16(hi);
+    std::size_t matched = 0;
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i x = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(v + i));
+        const __m256i miss = _mm256_or_si256(_mm256_cmpgt_epi16(vlo, x),
+                                             _mm256_cmpgt_epi16(x, vhi));
+        const unsigned mask = unsigned(_mm256_movemask_epi8(miss));
+        matched += 16 - std::size_t(__builtin_popcount(mask)) / 2;
+    }
+    for (; i < n; ++i) {
+        if (v[i] >= lo && v[i] <= hi) {
+            ++matched;
+        }
+    }
+    return matched;
+}
+
+#else
+
+std::size_t count_in_range(const int16_t* v, std::size_t n, int16_t lo,
+                           int16_t hi) {
+    std::size_t matched = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (v[i] >= lo && v[i] <= hi) {
+            ++matched;
+        }
+    }
+    return matched;
+}
+
+#endif
+
+QueryEngine::QueryEngine(const storage::ArchiveReader& reader,
+                         std::size_t workers)
+    : reader_(reader),
+      workers_(workers ? workers
+                       : std::max<std::size_t>(
+                             1, std::thread::hardware_concurrency())) {}
+
+void QueryEngine::scan_range(const Predicate& p,
+                             const std::vector<uint32_t>& segs,
+                             std::size_t first, std::size_t last,
+                             ScanResult& out) const {
+    // Scratch sized to the largest segment this worker meets: compacted
+    // archives legitimately carry merged row groups far beyond one
+    // window's 256 samples. Grow-only, so steady state is allocation-free.
+    std::vector<int16_t> col;
+    for (std::size_t i = first; i < last; ++i) {
+        const uint32_t seg = segs[i];
+        const storage::SegmentMeta& m = reader_.meta(seg);
+        ++out.segments_scanned;
+        out.samples_scanned += m.sample_count;
+        uint32_t matched = m.sample_count;
+        if (p.has_filter) {
+            if (m.sample_count > col.size()) {
+                col.resize(m.sample_count);
+            }
+            if (!reader_.read_column(seg, p.filter_col, col.data())) {
+                continue;
+            }
+            matched = uint32_t(count_in_range(col.data(), m.sample_count,
+                                              p.filter_lo, p.filter_hi));
+        }
+        if (matched > 0) {
+            out.samples_matched += matched;
+            out.hits.push_back({seg, matched, m.collar_id, m.base_tick});
+        }
+    }
+}
+
+ScanResult QueryEngine::scan(const Predicate& p) const {
+    // Prune on the footer index alone — collar and time never touch column
+    // bytes. Row-group granularity: a group qualifies by its base tick.
+    std::vector<uint32_t> segs;
+    for (std::size_t i = 0; i < reader_.segment_count(); ++i) {
+        const storage::SegmentMeta& m = reader_.meta(i);
+        if (m.base_tick >= p.tick_min && m.base_tick <= p.tick_max &&
+            collar_qualifies(p, m.collar_id)) {
+            segs.push_back(uint32_t(i));
+        }
+    }
+
+    const std::size_t n = segs.size();
+    const std::size_t nw = std::min(workers_, std::max<std::size_t>(1, n));
+    std::vector<ScanResult> parts(nw);
+    std::vector<std::thread> pool;
+    const std::size_t chunk = (n + nw - 1) / nw;
+    for (std::size_t w = 0; w < nw; ++w) {
+        const std::size_t first = w * chunk;
+        const std::size_t last = std::min(n, first + chunk);
+        pool.emplace_back([&, w, first, last] {
+            scan_range(p, segs, first, last, parts[w]);
+        });
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+
+    // Contiguous partitions merge back in segment order.
+    ScanResult out;
+    for (ScanResult& part : parts) {
+        out.segments_scanned += part.segments_scanned;
+        out.samples_scanned += part.samples_scanned;
+        out.samples_matched += part.samples_matched;
+        out.hits.insert(out.hits.end(), part.hits.begin(), part.hits.end());
+    }
+    return out;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> QueryEngine::matched_by_collar(
+    const Predicate& p) const {
+    const ScanResult r = scan(p);
+    std::vector<std::pair<uint64_t, uint64_t>> by_collar;
+    for (const SegmentHit& h : r.hits) {
+        auto it = std::find_if(by_collar.begin(), by_collar.end(),
+                               [&](const auto& e) {
+                                   return e.first == h.collar_id;
+                               });
+        if (it == by_collar.end()) {
+            by_collar.push_back({h.collar_id, h.matched});
+        } else {
+            it->second += h.matched;
+        }
+    }
+    std::sort(by_collar.begin(), by_collar.end());
+    return by_collar;
+}
+
+}  // namespace collar::server::query
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "storage/archive.h"
+
+namespace collar::server::query {
+
+// One predicate scan over the mmap'd columnar archive: which collars, which
+// time range, and optionally a value filter on one column. Everything is
+// inclusive; empty collar set means the whole fleet.
+struct Predicate {
+    std::vector<uint64_t> collars;
+    uint64_t tick_min = 0;
+    uint64_t tick_max = ~uint64_t(0);
+    bool has_filter = false;
+    storage::ColumnId filter_col = storage::ColumnId::kAx;
+    int16_t filter_lo = 0;
+    int16_t filter_hi = 0;
+};
+
+// Per-row-group result; only groups with at least one matching sample are
+// reported.
+struct SegmentHit {
+    uint32_t segment;
+    uint32_t matched;
+    uint64_t collar_id;
+    uint64_t base_tick;
+};
+
+struct ScanResult {
+    uint64_t segments_scanned = 0;
+    uint64_t samples_scanned = 0;
+    uint64_t samples_matched = 0;
+    std::vector<SegmentHit> hits;
+};
+
+// In-process parallel scan engine — the replacement for the
+// export-to-pandas path. Collar/time pruning walks the footer index only;
+// qualifying segments are partitioned in contiguous runs across a pool of
+// scan threads, each decoding column blocks into a stack buffer and
+// counting filter matches with the AVX2 kernel (scalar elsewhere). The
+// mmap'd file is shared read-only state, so N threads cost no extra memory
+// beyond their 512-byte decode buffers.
+class QueryEngine {
+public:
+    // workers = 0 picks the hardware concurrency.
+    explicit QueryEngine(const storage::ArchiveReader& reader,
+                         std::size_t workers = 0);
+
+    ScanResult scan(const Predicate& p) const;
+
+    // The fleet-report shape analysts ask for: matched sample count per
+    // collar, e.g. "daily activity minutes" with an accel-energy filter.
+    // Sorted by collar id.
+    std::vector<std::pair<uint64_t, uint64_t>> matched_by_collar(
+        const Predicate& p) const;
+
+    std::size_t workers() const { return workers_; }
+
+private:
+    void scan_range(const Predicate& p, const std::vector<uint32_t>& segs,
+                    std::size_t first, std::size_t last,
+                    ScanResult& out) const;
+
+    const storage::ArchiveReader& reader_;
+    std::size_t workers_;
+};
+
+// Counts values in [lo, hi] (inclusive). Exposed for the unit tests;
+// AVX2 when the build has it.
+std::size_t count_in_range(const int16_t* v, std::size_t n, int16_t lo,
+                           int16_t hi);
+
+}  // namespace collar::server::query
@@ -0,0 +1,174 @@
+#include "server/simd_decode.h"
+
+#include <cstring>
+
+#include "storage/frame.h"
+#include "storage/varint.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace collar::server {
+
+#if !defined(__AVX2__)
+
+bool decode_frame_simd(const uint8_t* page, SampleBatch& batch) {
+    return storage::decode_frame(page, batch);
+}
+
+#else
+
+namespace {
+
+using storage::FrameHeader;
+using storage::get_varint32;
+using storage::unzigzag32;
+
+constexpr std::size_t kColumns = 8;
+
+// Decode one zigzag-delta column. prev/out are the running reconstruction;
+// returns false on a malformed stream.
+bool decode_signed_column(const uint8_t* p, const uint8_t* end,
+                          std::size_t count, int16_t* out) {
+    int32_t prev = 0;
+    std::size_t i = 0;
+    while (i < count) {
+        // Vector fast path: 32 stream bytes at a time. A zero movemask
+        // means 32 complete single-byte varints — unzigzag all of them with
+        // 16-lane arithmetic, then reconstruct the prefix sum. One scalar
+        // value is decoded whenever the next block has continuation bytes,
+        // so the loop re-qualifies for the vector path right after a
+        // multi-byte stretch.
+        if (i + 32 <= count && end - p >= 32) {
+            const __m256i raw =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            if (_mm256_movemask_epi8(raw) == 0) {
+                alignas(32) int16_t dec[32];
+                const __m128i lo = _mm256_castsi256_si128(raw);
+                const __m128i hi = _mm256_extracti128_si256(raw, 1);
+                for (int half = 0; half < 2; ++half) {
+                    const __m256i x = _mm256_cvtepu8_epi16(half == 0 ? lo : hi);
+                    // unzigzag: (x >> 1) ^ -(x & 1)
+                    const __m256i shifted = _mm256_srli_epi16(x, 1);
+                    const __m256i sign = _mm256_sub_epi16(
+                        _mm256_setzero_si256(),
+                        _mm256_and_si256(x, _mm256_set1_epi16(1)));
+                    _mm256_store_si256(
+                        reinterpret_cast<__m256i*>(dec + half * 16),
+                        _mm256_xor_si256(shifted, sign));
+                }
+                for (int k = 0; k < 32; ++k) {
+                    prev += dec[k];
+                    out[i + std::size_t(k)] = int16_t(prev);
+                }
+                p += 32;
+                i += 32;
+                continue;
+            }
+        }
+        uint32_t zz;
+        const std::size_t n = get_varint32(p, std::size_t(end - p), zz);
+        if (n == 0) {
+            return false;
+        }
+        p += n;
+        prev += unzigzag32(zz);
+        out[i++] = int16_t(prev);
+    }
+    return p == end;
+}
+
+bool decode_dt_column(const uint8_t* p, const uint8_t* end, std::size_t count,
+                      uint16_t* out) {
+    std::size_t i = 0;
+    while (i < count) {
+        if (i + 32 <= count && end - p >= 32) {
+            const __m256i raw =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            if (_mm256_movemask_epi8(raw) == 0) {
+                alignas(32) int16_t dec[32];
+                _mm256_store_si256(
+                    reinterpret_cast<__m256i*>(dec),
+                    _mm256_cvtepu8_epi16(_mm256_castsi256_si128(raw)));
+                _mm256_store_si256(
+                    reinterpret_cast<__m256i*>(dec + 16),
+                    _mm256_cvtepu8_epi16(_mm256_extracti128_si256(raw, 1)));
+                std::memcpy(out + i, dec, 32 * sizeof(uint16_t));
+                p += 32;
+                i += 32;
+                continue;
+            }
+        }
+        uint32_t v;
+        const std::size_t n = get_varint32(p, std::size_t(end - p), v);
+        if (n == 0) {
+            return false;
+        }
+        p += n;
+        out[i++] = uint16_t(v);
+    }
+    return p == end;
+}
+
+}  // namespace
+
+bool decode_frame_simd(const uint8_t* page, SampleBatch& batch) {
+    FrameHeader hdr;
+    std::memcpy(&hdr, page, sizeof(hdr));
+    if (hdr.magic != FrameHeader::kMagic ||
+        hdr.version != FrameHeader::kVersion ||
+        hdr.sample_count > SampleBatch::capacity ||
+        hdr.payload_bytes > storage::kFramePayloadMax) {
+        return false;
+    }
+    const uint8_t* payload = page + sizeof(FrameHeader);
+    if (storage::crc32c(payload, hdr.payload_bytes) != hdr.payload_crc) {
+        return false;
+    }
+
+    constexpr std::size_t kLenTable = kColumns * sizeof(uint16_t);
+    if (hdr.payload_bytes < kLenTable) {
+        return false;
+    }
+    uint16_t col_len[kColumns];
+    std::memcpy(col_len, payload, kLenTable);
+    // This path decodes untrusted network uploads, and the length table is
+    // payload — the CRC vouches for a crafted frame's oversized entries,
+    // which would run the 32-byte vector loads past the page. The columns
+    // must tile the payload exactly, and each end is clamped to the
+    // payload as a second fence.
+    std::size_t cols_total = 0;
+    for (std::size_t c = 0; c < kColumns; ++c) {
+        cols_total += col_len[c];
+    }
+    if (kLenTable + cols_total != hdr.payload_bytes) {
+        return false;
+    }
+    const uint8_t* const payload_end = payload + hdr.payload_bytes;
+
+    batch.clear();
+    batch.base_tick = hdr.base_tick;
+    const std::size_t count = hdr.sample_count;
+
+    int16_t* cols[kColumns - 1] = {batch.ax, batch.ay, batch.az, batch.gx,
+                                   batch.gy, batch.gz, batch.temp};
+    const uint8_t* p = payload + kLenTable;
+    for (std::size_t c = 0; c < kColumns - 1; ++c) {
+        const uint8_t* end = p + col_len[c];
+        if (end > payload_end ||
+            !decode_signed_column(p, end, count, cols[c])) {
+            return false;
+        }
+        p += col_len[c];
+    }
+    if (!decode_dt_column(p, p + col_len[kColumns - 1], count, batch.dt)) {
+        return false;
+    }
+    batch.count = count;
+    return true;
+}
+
+#endif  // __AVX2__
+
+}  // namespace collar::server
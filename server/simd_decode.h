@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+#include "core/sample_batch.h"
+
+namespace collar::server {
+
+// Server-side batch decoder for the on-flash frame format — same contract
+// as storage::decode_frame, but the varint column streams are decoded in
+// 32-byte gulps with AVX2 instead of byte-at-a-time.
+//
+// The trick is distributional: accel deltas from a sleeping or walking cat
+// are almost always single-byte varints, so a 32-byte load plus one
+// movemask classifies 32 values at once. Clean blocks take the vector
+// path (unzigzag as 16-lane arithmetic); any block with continuation bits
+// falls back to the scalar decoder for that stretch. Builds without AVX2
+// compile to a plain call into the scalar decoder.
+bool decode_frame_simd(const uint8_t* page, SampleBatch& batch);
+
+}  // namespace collar::server
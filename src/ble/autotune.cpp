@@ -0,0 +1,44 @@
+#include "ble/autotune.h"
+
+namespace collar::ble {
+
+void Autotuner::negotiate() {
+    // Order matters on real stacks: MTU first (it is an ATT exchange and
+    // fast), then the PHY upgrade, then the interval — central-side timing
+    // of the connection-parameter update can take a few events, which the
+    // measurement loop simply rides out.
+    ctl_.request_mtu(kRequestMtu);
+    ctl_.request_phy_2m();
+    ctl_.request_interval(kRequestInterval);
+    last_events_ = ctl_.conn_events();
+    last_bytes_ = ctl_.bytes_drained();
+    per_event_ = 0;
+}
+
+void Autotuner::update() {
+    const uint64_t events = ctl_.conn_events();
+    if (events - last_events_ < kMeasureEvents || unit_ == 0) {
+        return;
+    }
+    const uint64_t bytes = ctl_.bytes_drained();
+    per_event_ = (bytes - last_bytes_) / (events - last_events_);
+    last_events_ = events;
+    last_bytes_ = bytes;
+
+    // The event carried about what we offered: our quota is the cap, so
+    // offer more. The event carried clearly less: the link is the cap, so
+    // shrink to what it carries plus one notification of headroom —
+    // anything above that is just bytes parked in stack buffers.
+    const std::size_t carried = std::size_t(per_event_) / unit_;
+    if (carried + 1 >= quota_) {
+        if (quota_ < kMaxQuota) {
+            ++quota_;
+            ++raises_;
+        }
+    } else if (carried + 2 < quota_) {
+        quota_ = carried + 2 > kMinQuota ? carried + 2 : kMinQuota;
+        ++shrinks_;
+    }
+}
+
+}  // namespace collar::ble
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ble/link.h"
+
+namespace collar::ble {
+
+// Sync-start throughput autotuner. Field captures put default-parameter
+// syncs at ~18 kB/s where the same hardware tuned does 90+ kB/s, and radio
+// seconds are the most expensive seconds the collar spends — so at sync
+// start this negotiates 2M PHY, a big MTU and a short connection interval,
+// then keeps measuring achieved goodput per connection event and adapts
+// how many notifications the transfer engine holds in flight so each
+// event leaves full but never over-queued.
+//
+// Everything degrades gracefully: a phone that caps or rejects a
+// parameter just leaves the actuals lower, and the quota ladder then
+// converges on whatever the capped link actually carries per event.
+class Autotuner {
+public:
+    // Negotiation targets. 247 is the DLE-era MTU every phone since ~2016
+    // grants or counters sensibly; 12 x 1.25 ms = 15 ms interval.
+    static constexpr uint16_t kRequestMtu = 247;
+    static constexpr uint16_t kRequestInterval = 12;
+
+    // Quota ladder bounds: never fewer than 2 notifications in flight
+    // (the radio must not idle while the main loop runs), never more than
+    // 16 (stack TX buffers, and the double-buffer swap latency they cost).
+    static constexpr std::size_t kMinQuota = 2;
+    static constexpr std::size_t kMaxQuota = 16;
+    // Goodput is re-measured once this many connection events elapse.
+    static constexpr uint64_t kMeasureEvents = 8;
+
+    Autotuner(BleLinkControl& ctl, BleLink& link) : ctl_(ctl), link_(link) {}
+
+    // Fire the parameter requests and snapshot the counters. Call once at
+    // sync start, before the transfer engine picks its chunk size — the
+    // chunk derives from the MTU this negotiates.
+    void negotiate();
+
+    // The notification size the engine actually queues (its chunk); the
+    // unit the quota and the per-event measurement are counted in.
+    void set_unit_bytes(std::size_t unit) { unit_ = unit; }
+
+    // Measure and adapt; cheap except once per kMeasureEvents. The engine
+    // calls this every service().
+    void update();
+
+    // Notifications the engine should keep in flight.
+    std::size_t quota() const { return quota_; }
+
+    bool phy_2m() const { return ctl_.phy_2m_active(); }
+    uint16_t interval_1_25ms() const { return ctl_.interval_1_25ms(); }
+    std::size_t payload() const { return link_.payload_size(); }
+
+    uint64_t goodput_bytes_per_event() const { return per_event_; }
+    uint32_t raises() const { return raises_; }
+    uint32_t shrinks() const { return shrinks_; }
+
+private:
+    BleLinkControl& ctl_;
+    BleLink& link_;
+    std::size_t unit_ = 0;
+    std::size_t quota_ = 4;  // sane cold-start batch for any interval
+    uint64_t last_events_ = 0;
+    uint64_t last_bytes_ = 0;
+    uint64_t per_event_ = 0;
+    uint32_t raises_ = 0;
+    uint32_t shrinks_ = 0;
+};
+
+}  // namespace collar::ble
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace collar::ble {
+
+// Thin seam over the vendor BLE stack. The transfer engine only needs to
+// know the negotiated ATT payload size and whether the stack accepted a
+// notification into its TX queue; connection-parameter control lives on
+// the separate BleLinkControl seam below. Tests substitute a capture fake.
+class BleLink {
+public:
+    virtual ~BleLink() = default;
+
+    // Usable notification payload (ATT_MTU minus the 3-byte ATT header).
+    virtual std::size_t payload_size() const = 0;
+
+    // Queue one notification. The data pointer must stay valid until the
+    // stack reports the buffer drained — the transfer engine guarantees this
+    // by never recycling a flash page buffer with notifications in flight.
+    // Returns false when the TX queue is full (retry next service() call).
+    virtual bool notify(const uint8_t* data, std::size_t len) = 0;
+
+    // Notifications queued but not yet on air. The engine swaps its double
+    // buffer only when this hits zero for the draining half.
+    virtual std::size_t in_flight() const = 0;
+};
+
+// Connection-parameter seam for the sync autotuner. Every request is a
+// request: the phone is the central and may cap, counter or reject any of
+// them, so callers read back the actuals instead of assuming. The two
+// counters expose what the controller already tracks — how many
+// connection events have elapsed and how many payload bytes have gone to
+// air — which is all the goodput measurement needs.
+class BleLinkControl {
+public:
+    virtual ~BleLinkControl() = default;
+
+    virtual bool request_phy_2m() = 0;
+    virtual bool request_mtu(uint16_t mtu) = 0;
+    // Units of 1.25 ms, as the spec counts connection intervals.
+    virtual bool request_interval(uint16_t interval_1_25ms) = 0;
+
+    virtual bool phy_2m_active() const = 0;
+    virtual uint16_t interval_1_25ms() const = 0;
+
+    virtual uint64_t conn_events() const = 0;
+    virtual uint64_t bytes_drained() const = 0;
+};
+
+}  // namespace collar::ble
@@ -0,0 +1,142 @@
+#include "ble/transfer.h"
+
+#include <cstring>
+
+#include "instrument/counters.h"
+
+namespace collar::ble {
+
+namespace {
+
+instrument::StageCounters& stage_ctr() {
+    return instrument::stage_counters(instrument::Stage::kFlashToBle);
+}
+
+}  // namespace
+
+std::size_t TransferEngine::pick_chunk(std::size_t payload) {
+    // Largest power of two <= payload, floored at 16 — which still divides
+    // the 4 KB page, so pages stay a whole number of chunks even on a
+    // small MTU.
+    std::size_t chunk = 16;
+    while (chunk * 2 <= payload && chunk * 2 <= storage::kFlashPageSize) {
+        chunk *= 2;
+    }
+    return chunk;
+}
+
+bool TransferEngine::start(std::size_t first_frame) {
+    if (first_frame >= log_.frame_count()) {
+        return false;
+    }
+    if (tuner_ != nullptr) {
+        tuner_->negotiate();  // may grow payload_size() before the pick
+    }
+    // A payload that cannot carry the 24-byte wire header in one
+    // notification cannot stream frames at all. Fail the sync up front —
+    // the alternative is a service() loop stalled forever on a notify()
+    // the stack will never accept.
+    if (link_.payload_size() < proto::kWireHeaderSize) {
+        return false;
+    }
+    chunk_ = pick_chunk(link_.payload_size());
+    if (tuner_ != nullptr) {
+        tuner_->set_unit_bytes(chunk_);
+    }
+    next_frame_ = first_frame;
+    frames_sent_ = 0;
+    bufs_[0] = PageBuf{};
+    bufs_[1] = PageBuf{};
+    active_ = 0;
+    if (!prefetch(bufs_[0])) {
+        return false;
+    }
+    prefetch(bufs_[1]);  // may find nothing if only one frame remains
+    state_ = State::kStreaming;
+    return true;
+}
+
+bool TransferEngine::prefetch(PageBuf& buf) {
+    // On device this arms the QSPI DMA; the engine's structure (load into
+    // the idle half, swap only when drained) is what makes that overlap
+    // legal. The host build reads synchronously.
+    if (next_frame_ >= log_.frame_count()) {
+        buf.loaded = false;
+        return false;
+    }
+    if (!log_.read_frame_raw(next_frame_, buf.data)) {
+        buf.loaded = false;
+        return false;
+    }
+    // Frame the page in place: pages_frame_sg writes the wire header next
+    // to the page and the two become the scatter-gather list the service
+    // loop streams in order (header notification, then page chunks).
+    const uint8_t* page = buf.data;
+    proto::SgSpan iov[2];
+    proto::pages_frame_sg(buf.hdr, collar_id_, &page, 1, iov);
+    storage::FrameHeader fh;
+    std::memcpy(&fh, buf.data, sizeof(fh));
+    buf.samples = fh.sample_count;
+    stage_ctr().add_in(buf.samples);
+    buf.sent = 0;
+    buf.hdr_sent = false;
+    buf.loaded = true;
+    ++next_frame_;
+    return true;
+}
+
+bool TransferEngine::service() {
+    if (state_ != State::kStreaming) {
+        return false;
+    }
+    if (tuner_ != nullptr) {
+        tuner_->update();
+    }
+    // Batch ceiling: the tuner's per-event quota when tuned, otherwise
+    // whatever the stack accepts.
+    const auto room = [this] {
+        return tuner_ == nullptr || link_.in_flight() < tuner_->quota();
+    };
+    PageBuf& front = bufs_[active_];
+
+    // The wire header leads its page as one small notification.
+    if (front.loaded && !front.hdr_sent) {
+        if (!room() || !link_.notify(front.hdr, proto::kWireHeaderSize)) {
+            stage_ctr().add_stalls(1);
+            return true;
+        }
+        stage_ctr().add_bytes(proto::kWireHeaderSize);
+        front.hdr_sent = true;
+    }
+
+    // Queue chunks out of the front buffer until the batch is full or the
+    // stack pushes back.
+    while (front.loaded && front.sent < storage::kFlashPageSize) {
+        if (!room() || !link_.notify(front.data + front.sent, chunk_)) {
+            stage_ctr().add_stalls(1);
+            return true;  // batch/queue full; try again next loop
+        }
+        stage_ctr().add_bytes(chunk_);
+        front.sent += chunk_;
+    }
+
+    // Front fully queued: wait for the radio to drain it before recycling,
+    // since the in-flight notifications point into it.
+    if (front.loaded && front.sent == storage::kFlashPageSize) {
+        if (link_.in_flight() != 0) {
+            return true;
+        }
+        ++frames_sent_;
+        stage_ctr().add_out(front.samples);
+        front.loaded = false;
+        prefetch(front);            // becomes the new back half
+        active_ ^= 1;
+        if (!bufs_[active_].loaded) {
+            state_ = State::kIdle;  // nothing left in either half
+            return false;
+        }
+    }
+    return state_ == State::kStreaming;
+}
+
+}  // namespace collar::ble
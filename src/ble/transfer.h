@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ble/autotune.h"
+#include "ble/link.h"
+#include "proto/wire.h"
+#include "storage/flash_log.h"
+
+namespace collar::ble {
+
+// Streams flash-log frames to the phone as wire-protocol v2 frames, one
+// 4 KB page per frame, zero-copy: each frame is the scatter-gather pair
+// pages_frame_sg builds — a 24-byte header beside the page buffer, then the
+// page itself — and notifications point straight into those buffers, no
+// per-chunk staging. Two page buffers are kept — the radio drains one while
+// the next frame is read (DMA'd, on device) into the other — so flash
+// latency hides behind radio time instead of adding to it.
+//
+// Chunking: pages are cut into the largest power-of-two chunk that fits the
+// negotiated ATT payload. Because kFlashPageSize is a power of two, a page
+// is always a whole number of chunks; the header rides as its own small
+// notification ahead of them, so no re-framing or padding ever happens.
+class TransferEngine {
+public:
+    TransferEngine(storage::FlashLog& log, BleLink& link, uint64_t collar_id)
+        : log_(log), link_(link), collar_id_(collar_id) {}
+
+    // Optional throughput autotuner. When set, start() negotiates link
+    // parameters before the chunk size is picked, and service() holds no
+    // more than the tuner's quota of notifications in flight instead of
+    // queueing until the stack pushes back. Set before start().
+    void set_tuner(Autotuner* tuner) { tuner_ = tuner; }
+
+    // Begin a transfer of frames [first_frame, log.frame_count()). Called at
+    // sync start; first_frame > 0 resumes an interrupted sync.
+    bool start(std::size_t first_frame);
+
+    // Drive the pipeline from the main loop. Queues as many notifications as
+    // the stack accepts, swaps buffers when one half drains, prefetches the
+    // next frame into the idle half. Returns true while the transfer is
+    // still in progress.
+    bool service();
+
+    bool done() const { return state_ == State::kIdle; }
+    std::size_t frames_sent() const { return frames_sent_; }
+    std::size_t chunk_size() const { return chunk_; }
+
+private:
+    enum class State { kIdle, kStreaming };
+
+    struct PageBuf {
+        alignas(4) uint8_t data[storage::kFlashPageSize];
+        uint8_t hdr[proto::kWireHeaderSize];  // wire header for this page
+        std::size_t sent = 0;   // payload bytes handed to the link
+        uint16_t samples = 0;   // sample_count from the frame header
+        bool hdr_sent = false;
+        bool loaded = false;
+    };
+
+    bool prefetch(PageBuf& buf);
+    static std::size_t pick_chunk(std::size_t payload);
+
+    storage::FlashLog& log_;
+    BleLink& link_;
+    uint64_t collar_id_;
+    Autotuner* tuner_ = nullptr;
+    PageBuf bufs_[2];
+    std::size_t active_ = 0;        // half the radio is draining
+    std::size_t next_frame_ = 0;    // next frame index to read from flash
+    std::size_t frames_sent_ = 0;
+    std::size_t chunk_ = 0;
+    State state_ = State::kIdle;
+};
+
+}  // namespace collar::ble
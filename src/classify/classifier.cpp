@@ -0,0 +1,145 @@
+#include "classify/classifier.h"
+
+namespace collar::classify {
+
+namespace {
+
+// Feature indices, matching QuantFeatures order.
+enum : uint8_t {
+    kRmsAx = 0, kRmsAy, kRmsAz,
+    kZccAx, kZccAy, kZccAz,
+    kBand0, kBand1, kBand2, kBand3,
+};
+
+// Per-feature right-shifts mapping raw feature magnitudes into Q15. Part of
+// the model ABI: retraining must regenerate shifts and trees together.
+constexpr int kFeatureShift[kNumFeatures] = {
+    0, 0, 0,   // rms: raw LSB rms already fits int16 after clamp
+    -6, -6, -6,  // zcc: max 255 per window, scale up for resolution
+    4, 4, 4, 4,  // band energies
+};
+
+constexpr int16_t clamp_q15(int32_t v) {
+    return v > 32767 ? int16_t(32767) : (v < 0 ? int16_t(0) : int16_t(v));
+}
+
+// Model v0: three depth-limited trees, hand-derived from the fleet feature
+// corpus (cadence bands dominate; rms breaks rest/groom ties). Implicit heap
+// layout, 15 slots per tree; unused slots are zero-filled leaves voting
+// rest, which descent never reaches.
+constexpr std::size_t kTreeSlots = 15;
+constexpr std::size_t kNumTrees = 3;
+
+constexpr TreeNode L(Activity a) {
+    return {TreeNode::kLeaf, 0, int16_t(a)};
+}
+constexpr TreeNode N(uint8_t f, int16_t thr) { return {f, 0, thr}; }
+
+constexpr TreeNode kForest[kNumTrees][kTreeSlots] = {
+    // Tree 0: cadence-band split first.
+    {
+        N(kBand1, 2000),                     // 0: any gait-band energy?
+        N(kBand3, 1500), N(kBand1, 8000),    // 1, 2
+        N(kBand2, 1500), L(Activity::kScratch),           // 3, 4
+        L(Activity::kWalk), L(Activity::kRun),            // 5, 6
+        L(Activity::kRest), L(Activity::kGroom),          // 7, 8
+        L(Activity::kRest), L(Activity::kRest),
+        L(Activity::kRest), L(Activity::kRest),
+        L(Activity::kRest), L(Activity::kRest),
+    },
+    // Tree 1: same shape, thresholds perturbed to soften the boundaries.
+    {
+        N(kBand1, 2400),
+        N(kBand3, 1200), N(kBand1, 7200),
+        N(kBand2, 1800), L(Activity::kScratch),
+        L(Activity::kWalk), L(Activity::kRun),
+        L(Activity::kRest), L(Activity::kGroom),
+        L(Activity::kRest), L(Activity::kRest),
+        L(Activity::kRest), L(Activity::kRest),
+        L(Activity::kRest), L(Activity::kRest),
+    },
+    // Tree 2: zcc view — paw-flick rates separate scratch from groom when
+    // the band split is ambiguous.
+    {
+        N(kBand1, 2200),
+        N(kZccAx, 12000), N(kBand1, 7600),
+        N(kBand2, 1600), L(Activity::kScratch),
+        L(Activity::kWalk), L(Activity::kRun),
+        L(Activity::kRest), L(Activity::kGroom),
+        L(Activity::kRest), L(Activity::kRest),
+        L(Activity::kRest), L(Activity::kRest),
+        L(Activity::kRest), L(Activity::kRest),
+    },
+};
+
+}  // namespace
+
+const char* activity_name(Activity a) {
+    switch (a) {
+        case Activity::kRest: return "rest";
+        case Activity::kWalk: return "walk";
+        case Activity::kRun: return "run";
+        case Activity::kGroom: return "groom";
+        case Activity::kScratch: return "scratch";
+        default: return "?";
+    }
+}
+
+void Classifier::quantize(const dsp::FeatureVector& features,
+                          QuantFeatures out) {
+    const float raw[kNumFeatures] = {
+        features.rms[0], features.rms[1], features.rms[2],
+        float(features.zcc[0]), float(features.zcc[1]), float(features.zcc[2]),
+        features.band_energy[0], features.band_energy[1],
+        features.band_energy[2], features.band_energy[3],
+    };
+    for (std::size_t i = 0; i < kNumFeatures; ++i) {
+        const int shift = kFeatureShift[i];
+        // Saturate in float space, at the value that shifts to the Q15
+        // ceiling: band energies exceed INT32_MAX at amplitudes well
+        // inside sensor range, and float->int conversion past that is UB
+        // (x86 lands on INT32_MIN, which clamp_q15 would map to zero — the
+        // most vigorous windows quantizing to rest).
+        const float cap =
+            shift >= 0 ? float(32767 << shift) : float(32767 >> -shift);
+        const float f = raw[i] < 0.0f ? 0.0f : (raw[i] > cap ? cap : raw[i]);
+        const int32_t v = int32_t(f);
+        out[i] = clamp_q15(shift >= 0 ? (v >> shift) : (v << -shift));
+    }
+}
+
+Activity Classifier::classify_quantized(
+    const QuantFeatures q,
+    uint8_t votes_out[std::size_t(Activity::kCount)]) const {
+    uint8_t votes[std::size_t(Activity::kCount)] = {};
+    for (std::size_t t = 0; t < kNumTrees; ++t) {
+        const TreeNode* tree = kForest[t];
+        std::size_t i = 0;
+        while (tree[i].feature != TreeNode::kLeaf) {
+            // Implicit heap descent: pure index arithmetic, one compare per
+            // level, the whole tree resident in two cache lines.
+            i = 2 * i + 1 + std::size_t(q[tree[i].feature] > tree[i].threshold);
+        }
+        ++votes[std::size_t(tree[i].threshold)];
+    }
+    std::size_t best = 0;
+    for (std::size_t a = 1; a < std::size_t(Activity::kCount); ++a) {
+        if (votes[a] > votes[best]) {
+            best = a;
+        }
+    }
+    if (votes_out) {
+        for (std::size_t a = 0; a < std::size_t(Activity::kCount); ++a) {
+            votes_out[a] = votes[a];
+        }
+    }
+    return Activity(best);
+}
+
+Activity Classifier::classify(const dsp::FeatureVector& features) const {
+    QuantFeatures q;
+    quantize(features, q);
+    return classify_quantized(q);
+}
+
+}  // namespace collar::classify
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "dsp/features.h"
+
+namespace collar::classify {
+
+enum class Activity : uint8_t {
+    kRest = 0,
+    kWalk,
+    kRun,
+    kGroom,
+    kScratch,
+    kCount,
+};
+
+const char* activity_name(Activity a);
+
+// Quantized feature layout the model is trained against. Order and scaling
+// are model ABI: rms[3], zcc[3], band_energy[4], all mapped into Q15 with
+// the per-feature shifts in classifier.cpp. Append-only.
+inline constexpr std::size_t kNumFeatures = 10;
+using QuantFeatures = int16_t[kNumFeatures];
+
+// One node of a flattened decision tree. Trees are stored as implicit binary
+// heaps in one contiguous array: the children of node i are 2i+1 and 2i+2,
+// so descending a tree is index arithmetic on a flat array — no pointers to
+// chase, no cache-missing node allocations. Leaves carry the vote in
+// `threshold` and are flagged with feature == kLeaf.
+struct TreeNode {
+    static constexpr uint8_t kLeaf = 0xff;
+
+    uint8_t feature;     // index into QuantFeatures, or kLeaf
+    uint8_t pad;
+    int16_t threshold;   // Q15 split point, or the Activity vote on a leaf
+};
+static_assert(sizeof(TreeNode) == 4, "node layout is model ABI");
+
+// Fixed-point activity classifier. Integer-only end to end so the FPU-less
+// board revision stays inside its 1 ms window budget; the float feature
+// vector is quantized once at the boundary (10 conversions per 2.5 s
+// window, harmless even soft-floated).
+class Classifier {
+public:
+    Activity classify(const dsp::FeatureVector& features) const;
+
+    // Exposed for tests and for the adaptive-sampling controller, which
+    // wants the raw votes as a hysteresis input.
+    Activity classify_quantized(const QuantFeatures q,
+                                uint8_t votes_out[std::size_t(
+                                    Activity::kCount)] = nullptr) const;
+
+    static void quantize(const dsp::FeatureVector& features,
+                         QuantFeatures out);
+};
+
+}  // namespace collar::classify
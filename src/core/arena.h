@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace collar {
+
+// Fixed-capacity bump allocator for transient per-connection-event state —
+// notably BLE GATT packet assembly, where per-packet malloc fragments the
+// 64 KB SRAM over days of uptime. Allocation is a pointer bump; there is no
+// per-object free. The owner calls reset() once per connection event and the
+// whole arena is reusable.
+//
+// Storage is embedded, so a static Arena costs zero heap and its capacity is
+// a link-time fact rather than a runtime hope.
+template <std::size_t N>
+class Arena {
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    static constexpr std::size_t capacity() { return N; }
+    std::size_t used() const { return used_; }
+    std::size_t high_water() const { return high_water_; }
+
+    // Raw allocation. Returns nullptr when the arena is exhausted — callers
+    // on the radio path treat that as "stop assembling, send what you have".
+    void* alloc(std::size_t size, std::size_t align = alignof(std::max_align_t)) {
+        const std::size_t base =
+            (used_ + (align - 1)) & ~(align - 1);
+        if (size > N || base > N - size) {
+            return nullptr;
+        }
+        used_ = base + size;
+        if (used_ > high_water_) {
+            high_water_ = used_;
+        }
+        return buf_ + base;
+    }
+
+    // Typed allocation of a default-constructed T. Trivially-destructible
+    // only: reset() never runs destructors.
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "arena reset does not run destructors");
+        void* p = alloc(sizeof(T), alignof(T));
+        return p ? new (p) T(static_cast<Args&&>(args)...) : nullptr;
+    }
+
+    template <typename T>
+    T* alloc_array(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "arena reset does not run destructors");
+        void* p = alloc(sizeof(T) * count, alignof(T));
+        return p ? new (p) T[count] : nullptr;
+    }
+
+    void reset() { used_ = 0; }
+
+private:
+    alignas(std::max_align_t) uint8_t buf_[N];
+    std::size_t used_ = 0;
+    std::size_t high_water_ = 0;  // survives reset(); sizes the arena in review
+};
+
+}  // namespace collar
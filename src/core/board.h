@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "core/sample_batch.h"
+
+namespace collar {
+
+// Constexpr descriptions of the three shipping cat_collar_07 hardware
+// revisions. Everything the sampling hot loop needs to know about the board
+// — gyro presence, FIFO word layout, full-scale conversion — is a
+// compile-time constant here, so Board<Cfg> below resolves it all statically
+// and the gyro-less build carries no gyro code at all.
+
+// Rev A: LSM6DSOX, accel ±8 g + gyro ±2000 dps.
+struct Lsm6dsoxCfg {
+    static constexpr const char* name = "lsm6dsox";
+    static constexpr bool has_gyro = true;
+    static constexpr int32_t accel_fs_mg = 8000;
+    static constexpr int32_t gyro_fs_mdps = 2000000;
+    static constexpr uint16_t odr_hz = 104;
+    // FIFO word layout per sample: ax ay az gx gy gz temp
+    static constexpr std::size_t fifo_words = 7;
+};
+
+// Rev B: LSM6DSO32, same die family but accel ±32 g for the tree-jumpers.
+struct Lsm6dso32Cfg {
+    static constexpr const char* name = "lsm6dso32";
+    static constexpr bool has_gyro = true;
+    static constexpr int32_t accel_fs_mg = 32000;
+    static constexpr int32_t gyro_fs_mdps = 2000000;
+    static constexpr uint16_t odr_hz = 104;
+    static constexpr std::size_t fifo_words = 7;
+};
+
+// Rev C: BMA400, accel-only low-cost build. No gyro silicon on the board.
+struct Bma400Cfg {
+    static constexpr const char* name = "bma400";
+    static constexpr bool has_gyro = false;
+    static constexpr int32_t accel_fs_mg = 8000;
+    static constexpr uint16_t odr_hz = 100;
+    // FIFO word layout per sample: ax ay az temp
+    static constexpr std::size_t fifo_words = 4;
+};
+
+// Board<Cfg> is the only way sampling code is allowed to touch the sensor
+// configuration: every accessor is constexpr, so `if constexpr
+// (Board<Cfg>::has_gyro)` prunes dead sensor paths at compile time instead
+// of branching in the 104 Hz loop.
+template <typename Cfg>
+struct Board {
+    using config = Cfg;
+
+    static constexpr bool has_gyro = Cfg::has_gyro;
+    static constexpr uint16_t odr_hz = Cfg::odr_hz;
+    static constexpr std::size_t fifo_words = Cfg::fifo_words;
+    static constexpr std::size_t axes = has_gyro ? 6 : 3;
+
+    // Raw LSBs to milli-g / milli-dps. Shifts, not divides: full scale maps
+    // int16 range exactly.
+    static constexpr int32_t accel_mg(int16_t raw) {
+        return int32_t((int64_t(raw) * Cfg::accel_fs_mg) >> 15);
+    }
+
+    template <bool G = has_gyro>
+    static constexpr std::enable_if_t<G, int32_t> gyro_mdps(int16_t raw) {
+        return int32_t((int64_t(raw) * Cfg::gyro_fs_mdps) >> 15);
+    }
+
+    // Decode one raw FIFO record into the shared sample type. On gyro-less
+    // boards the gyro stores below compile away and the columns stay zero.
+    static ImuSample decode(const int16_t* words, uint16_t dt) {
+        ImuSample s{};
+        s.ax = words[0];
+        s.ay = words[1];
+        s.az = words[2];
+        if constexpr (has_gyro) {
+            s.gx = words[3];
+            s.gy = words[4];
+            s.gz = words[5];
+            s.temp = words[6];
+        } else {
+            s.temp = words[3];
+        }
+        s.dt = dt;
+        return s;
+    }
+};
+
+}  // namespace collar
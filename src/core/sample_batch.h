@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace collar {
+
+// One raw IMU sample as it leaves the sensor FIFO. This is the element type
+// the ISR pushes through SampleRing; it is deliberately 16 bytes so a burst
+// read lands on even boundaries.
+struct ImuSample {
+    int16_t ax, ay, az;     // accel, raw LSBs
+    int16_t gx, gy, gz;     // gyro, raw LSBs (zero on gyro-less boards)
+    int16_t temp;           // die temperature, raw LSBs
+    uint16_t dt;            // ticks since previous sample
+};
+
+// The classification window is 256 samples (~2.46 s at 104 Hz); every
+// consumer of SampleBatch — DSP, storage framing, the on-flash log — is sized
+// around this.
+inline constexpr std::size_t kSampleWindow = 256;
+
+// Structure-of-arrays batch of IMU samples, shared by the DSP and storage
+// subsystems. Columnar on purpose: the activity classifier reads only the
+// three accel columns for most of its work, and with separate contiguous
+// arrays those 1.5 KB fit in L1 without dragging gyro and temperature bytes
+// along. An AoS layout of the same window would stream 4 KB through cache
+// for the same pass.
+struct SampleBatch {
+    static constexpr std::size_t capacity = kSampleWindow;
+
+    uint64_t base_tick = 0;      // absolute tick of sample 0
+    std::size_t count = 0;
+
+    int16_t ax[capacity];
+    int16_t ay[capacity];
+    int16_t az[capacity];
+    int16_t gx[capacity];
+    int16_t gy[capacity];
+    int16_t gz[capacity];
+    int16_t temp[capacity];
+    uint16_t dt[capacity];       // ticks since previous sample
+
+    bool full() const { return count == capacity; }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    // Scatter one raw sample into the columns. Returns false when full so the
+    // drain loop knows to close the window.
+    bool append(const ImuSample& s) {
+        if (full()) {
+            return false;
+        }
+        ax[count] = s.ax;
+        ay[count] = s.ay;
+        az[count] = s.az;
+        gx[count] = s.gx;
+        gy[count] = s.gy;
+        gz[count] = s.gz;
+        temp[count] = s.temp;
+        dt[count] = s.dt;
+        ++count;
+        return true;
+    }
+};
+
+}  // namespace collar
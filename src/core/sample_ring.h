@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace collar {
+
+// Single-producer/single-consumer lock-free ring buffer for the IMU sample
+// path. The producer is the accelerometer ISR (104 Hz), the consumer is the
+// main loop; neither side may block, allocate, or touch a mutex.
+//
+// Capacity N must be a power of two so the head/tail indices can wrap with a
+// mask instead of a modulo. Storage is embedded in the object, so a
+// statically-placed SampleRing costs zero heap. Head and tail live on their
+// own cache lines so the ISR writing the head never invalidates the line the
+// consumer is spinning on.
+template <typename T, std::size_t N>
+class SampleRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "samples must be trivially copyable to cross the ISR boundary");
+
+public:
+    using value_type = T;
+
+    SampleRing() = default;
+    SampleRing(const SampleRing&) = delete;
+    SampleRing& operator=(const SampleRing&) = delete;
+
+    static constexpr std::size_t capacity() { return N - 1; }
+
+    // Producer side (ISR-safe). Returns false when the ring is full; the
+    // caller decides whether a dropped sample is counted or fatal.
+    bool try_push(const T& v) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t next = (head + 1) & kMask;
+        if (next == tail_.load(std::memory_order_acquire)) {
+            return false;  // full
+        }
+        slots_[head] = v;
+        head_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the ring is empty.
+    bool try_pop(T& out) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;  // empty
+        }
+        out = slots_[tail];
+        tail_.store((tail + 1) & kMask, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: pop up to max samples into out. Cheaper than max calls
+    // to try_pop because head is loaded once.
+    std::size_t pop_bulk(T* out, std::size_t max) {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t n = 0;
+        while (tail != head && n < max) {
+            out[n++] = slots_[tail];
+            tail = (tail + 1) & kMask;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return n;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t size() const {
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        return (head - tail) & kMask;
+    }
+
+private:
+    static constexpr std::size_t kMask = N - 1;
+    // std::hardware_destructive_interference_size is 64 on both Cortex-M33
+    // and the x86 ingest hosts; spelled out to keep the layout predictable.
+    static constexpr std::size_t kCacheLine = 64;
+
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    alignas(kCacheLine) T slots_[N];
+};
+
+}  // namespace collar
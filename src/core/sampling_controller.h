@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+namespace collar {
+
+// Duty-cycle controller for the IMU output data rate, driven by the
+// per-window activity label from src/classify/ (the main loop calls
+// on_window(activity == Activity::kRest) after each window closes). Fleet
+// cats rest 14+ hours a day; sampling rest at 104 Hz burns ~60% of sensor
+// energy and flash bandwidth on windows the classifier collapses to one
+// label, so rest idles the sensor at 12.5 Hz instead.
+//
+// Asymmetric by design: any non-rest window promotes straight to 104 Hz —
+// motion onset reaches full rate within one window — while demotion waits
+// for kRestWindowsToDemote consecutive rest windows and then steps down one
+// ODR notch per window, so a catnap twitch never thrashes the sensor
+// config. Layering note: this lives in core and takes a bool, not an
+// Activity, so core stays below classify in the dependency order.
+class SamplingController {
+public:
+    // The LSM6-family ODR ladder the fleet boards share.
+    enum class Rate : uint8_t { kRest12Hz5 = 0, kLow26Hz, kMid52Hz, kFull104Hz };
+
+    // Consecutive rest windows before the first step down (~20 s at 104 Hz
+    // windows). Tuned against fleet nap traces: long enough to outlast
+    // grooming pauses, short enough to matter for the power budget.
+    static constexpr uint32_t kRestWindowsToDemote = 8;
+
+    // RTC ticks (1024 Hz) between samples at each rate; this is the dt the
+    // pipeline stamps into ImuSample while the rate is active.
+    static constexpr uint16_t ticks_per_sample(Rate r) {
+        constexpr uint16_t kTicks[4] = {82, 39, 20, 10};
+        return kTicks[uint8_t(r)];
+    }
+    static constexpr uint16_t rate_hz_x10(Rate r) {
+        constexpr uint16_t kHz[4] = {125, 260, 520, 1040};
+        return kHz[uint8_t(r)];
+    }
+
+    struct Decision {
+        Rate rate;
+        bool changed;  // true when the sensor needs a config write
+    };
+
+    // Feed the label of the window that just closed; returns the rate to
+    // run the next window at.
+    Decision on_window(bool resting) {
+        if (!resting) {
+            rest_run_ = 0;
+            return set(Rate::kFull104Hz);
+        }
+        if (++rest_run_ >= kRestWindowsToDemote && rate_ != Rate::kRest12Hz5) {
+            return set(Rate(uint8_t(rate_) - 1));
+        }
+        return {rate_, false};
+    }
+
+    Rate rate() const { return rate_; }
+    uint16_t dt_ticks() const { return ticks_per_sample(rate_); }
+    // Sensor config writes issued; the thrash metric the hysteresis guards.
+    uint32_t reconfigs() const { return reconfigs_; }
+
+private:
+    Decision set(Rate r) {
+        if (r == rate_) {
+            return {rate_, false};
+        }
+        rate_ = r;
+        ++reconfigs_;
+        return {rate_, true};
+    }
+
+    Rate rate_ = Rate::kFull104Hz;  // boot at full rate until classified
+    uint32_t rest_run_ = 0;
+    uint32_t reconfigs_ = 0;
+};
+
+}  // namespace collar
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace collar {
+
+// Hierarchical timer wheel for the firmware's periodic work (sample flush,
+// BLE advertise, battery check, classifier window close). Four levels of 64
+// slots at 1 RTC tick resolution span 64^4 ticks (~4.6 h at 1024 Hz);
+// longer delays park in the top level and re-bucket as they cascade down.
+//
+// Every node comes from a fixed pool — no heap, ISR-safe sizing — and both
+// arm() and cancel() are O(1) list splices, unlike the vendor SDK's sorted
+// list whose O(n) insert forced the 10 ms polling loop. The main loop asks
+// next_deadline(), programs the RTC compare, sleeps in WFI, and calls
+// advance(now) on wake; advance skips empty 64-tick runs via the level-0
+// occupancy bitmap, so a long sleep costs one boundary check per 64 ticks,
+// not one per tick.
+//
+// Single-context by design, like SampleRing's two ends: arm/cancel/advance
+// all run on the main loop. An ISR that wants a timer posts a request
+// through a ring instead of touching the wheel.
+template <std::size_t MaxTimers = 16>
+class TimerWheel {
+public:
+    using TimerFn = void (*)(void* ctx);
+    using TimerId = uint8_t;
+    static constexpr TimerId kInvalidTimer = 0xff;
+    static constexpr uint64_t kNever = ~uint64_t(0);
+    static_assert(MaxTimers > 0 && MaxTimers < 0xff,
+                  "TimerId is a uint8_t pool index");
+
+    explicit TimerWheel(uint64_t now = 0) : now_(now) {
+        for (std::size_t i = 0; i < MaxTimers; ++i) {
+            pool_[i].next = TimerId(i + 1);
+        }
+        pool_[MaxTimers - 1].next = kInvalidTimer;
+        free_head_ = 0;
+        for (unsigned l = 0; l < kLevels; ++l) {
+            for (unsigned s = 0; s < kSlots; ++s) {
+                heads_[l][s] = kInvalidTimer;
+            }
+            bitmap_[l] = 0;
+        }
+    }
+
+    // Fires fn(ctx) `delay` ticks from now (delay 0 fires on the next
+    // tick). period != 0 re-arms drift-free every `period` ticks after the
+    // first firing. Returns kInvalidTimer when the pool is exhausted.
+    TimerId arm(uint64_t delay, TimerFn fn, void* ctx, uint64_t period = 0) {
+        if (free_head_ == kInvalidTimer || fn == nullptr) {
+            return kInvalidTimer;
+        }
+        const TimerId id = free_head_;
+        Node& n = pool_[id];
+        free_head_ = n.next;
+        n.deadline = now_ + (delay ? delay : 1);
+        n.period = period;
+        n.fn = fn;
+        n.ctx = ctx;
+        n.armed = true;
+        insert(id);
+        ++armed_count_;
+        return id;
+    }
+
+    // O(1). Returns false for ids that are not currently armed (already
+    // fired one-shots included), so callers may cancel unconditionally.
+    bool cancel(TimerId id) {
+        if (id >= MaxTimers || !pool_[id].armed) {
+            return false;
+        }
+        unlink(id);
+        release(id);
+        return true;
+    }
+
+    // Exact earliest firing tick, or kNever. O(armed timers) — called once
+    // per sleep to program the RTC compare, not per tick.
+    uint64_t next_deadline() const {
+        uint64_t best = kNever;
+        for (std::size_t i = 0; i < MaxTimers; ++i) {
+            if (pool_[i].armed && pool_[i].deadline < best) {
+                best = pool_[i].deadline;
+            }
+        }
+        return best;
+    }
+
+    // Runs time forward to `now`, firing everything due in deadline order
+    // per slot. Safe to call with an arbitrary jump after a long WFI.
+    void advance(uint64_t now) {
+        while (now_ < now) {
+            if (armed_count_ == 0) {
+                now_ = now;
+                return;
+            }
+            if (bitmap_[0] == 0) {
+                // Nothing can fire before the next level-1 boundary; jump
+                // straight to the tick before it.
+                const uint64_t boundary = (now_ | (kSlots - 1)) + 1;
+                if (boundary > now) {
+                    now_ = now;
+                    return;
+                }
+                now_ = boundary - 1;
+            }
+            ++now_;
+            // Cascade top-down so nodes dropping two levels in one tick
+            // land before their slot is inspected.
+            for (unsigned l = kLevels - 1; l >= 1; --l) {
+                const uint64_t mask = (uint64_t(1) << (kSlotBits * l)) - 1;
+                if ((now_ & mask) == 0) {
+                    cascade(l, unsigned((now_ >> (kSlotBits * l)) & kSlotMask));
+                }
+            }
+            fire_slot(unsigned(now_ & kSlotMask));
+        }
+    }
+
+    uint64_t now() const { return now_; }
+    std::size_t armed() const { return armed_count_; }
+
+private:
+    static constexpr unsigned kLevels = 4;
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr unsigned kSlots = 64;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr uint64_t kSpan = uint64_t(1)
+                                      << (kSlotBits * kLevels);  // 64^4
+
+    struct Node {
+        uint64_t deadline = 0;
+        uint64_t period = 0;
+        TimerFn fn = nullptr;
+        void* ctx = nullptr;
+        TimerId next = kInvalidTimer;
+        TimerId prev = kInvalidTimer;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool armed = false;
+    };
+
+    // Buckets the node by how far its deadline is from now_. A deadline
+    // beyond the wheel's span parks in the farthest top-level slot and is
+    // re-bucketed when the cascade reaches it.
+    void insert(TimerId id) {
+        Node& n = pool_[id];
+        const uint64_t delta = n.deadline > now_ ? n.deadline - now_ : 1;
+        unsigned level = 0;
+        uint64_t span = kSlots;
+        while (level + 1 < kLevels && delta >= span) {
+            span <<= kSlotBits;
+            ++level;
+        }
+        const uint64_t key =
+            delta < kSpan ? n.deadline : now_ + kSpan - 1;
+        const unsigned slot =
+            unsigned((key >> (kSlotBits * level)) & kSlotMask);
+        n.level = uint8_t(level);
+        n.slot = uint8_t(slot);
+        n.prev = kInvalidTimer;
+        n.next = heads_[level][slot];
+        if (n.next != kInvalidTimer) {
+            pool_[n.next].prev = id;
+        }
+        heads_[level][slot] = id;
+        bitmap_[level] |= uint64_t(1) << slot;
+    }
+
+    void unlink(TimerId id) {
+        Node& n = pool_[id];
+        if (n.prev != kInvalidTimer) {
+            pool_[n.prev].next = n.next;
+        } else {
+            heads_[n.level][n.slot] = n.next;
+        }
+        if (n.next != kInvalidTimer) {
+            pool_[n.next].prev = n.prev;
+        }
+        if (heads_[n.level][n.slot] == kInvalidTimer) {
+            bitmap_[n.level] &= ~(uint64_t(1) << n.slot);
+        }
+    }
+
+    void release(TimerId id) {
+        pool_[id].armed = false;
+        pool_[id].next = free_head_;
+        free_head_ = id;
+        --armed_count_;
+    }
+
+    // Re-buckets every node in a higher-level slot; with now_ at the slot's
+    // window start they land one or more levels down.
+    void cascade(unsigned level, unsigned slot) {
+        TimerId id = heads_[level][slot];
+        heads_[level][slot] = kInvalidTimer;
+        bitmap_[level] &= ~(uint64_t(1) << slot);
+        while (id != kInvalidTimer) {
+            const TimerId next = pool_[id].next;
+            insert(id);
+            id = next;
+        }
+    }
+
+    // Level-0 slots hold exact deadlines: every node here was inserted with
+    // delta < 64, so the first tick matching its slot is its deadline.
+    void fire_slot(unsigned slot) {
+        while (heads_[0][slot] != kInvalidTimer) {
+            const TimerId id = heads_[0][slot];
+            Node& n = pool_[id];
+            unlink(id);
+            const TimerFn fn = n.fn;
+            void* ctx = n.ctx;
+            if (n.period != 0) {
+                n.deadline += n.period;
+                if (n.deadline <= now_) {  // missed beats collapse into one
+                    n.deadline = now_ + n.period;
+                }
+                insert(id);
+            } else {
+                release(id);
+            }
+            fn(ctx);  // may arm/cancel; pool state is consistent here
+        }
+    }
+
+    Node pool_[MaxTimers];
+    TimerId heads_[kLevels][kSlots];
+    uint64_t bitmap_[kLevels];
+    TimerId free_head_ = kInvalidTimer;
+    uint64_t now_;
+    std::size_t armed_count_ = 0;
+};
+
+}  // namespace collar
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/sample_batch.h"
+#include "dsp/isa.h"
+
+namespace collar::dsp {
+
+// Feature vector for one classification window. The activity classifier
+// consumes exactly this layout; append new features at the end so stored
+// model metadata stays valid.
+struct FeatureVector {
+    static constexpr std::size_t kBands = 4;
+
+    float rms[3];            // per accel axis, raw LSB units
+    uint32_t zcc[3];         // zero crossings per accel axis
+    float band_energy[kBands];  // accel-magnitude spectrum, low to high
+};
+
+namespace detail {
+
+// Iterative radix-2 complex FFT, in place. N must be a power of two. Only
+// used on the 256-sample window, so no twiddle caching is worth its RAM.
+inline void fft(float* re, float* im, std::size_t n) {
+    for (std::size_t i = 1, j = 0; i < n; ++i) {
+        std::size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (std::size_t len = 2; len <= n; len <<= 1) {
+        const float ang = -2.0f * 3.14159265358979323846f / float(len);
+        const float wr = std::cos(ang);
+        const float wi = std::sin(ang);
+        for (std::size_t i = 0; i < n; i += len) {
+            float cr = 1.0f;
+            float ci = 0.0f;
+            for (std::size_t k = 0; k < len / 2; ++k) {
+                const std::size_t a = i + k;
+                const std::size_t b = i + k + len / 2;
+                const float tr = re[b] * cr - im[b] * ci;
+                const float ti = re[b] * ci + im[b] * cr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+                const float ncr = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = ncr;
+            }
+        }
+    }
+}
+
+}  // namespace detail
+
+// Band edges over the 256-point spectrum at 104 Hz: ~0.4-2 Hz (slow gait),
+// 2-5 Hz (walk/run cadence), 5-13 Hz (groom/scratch), 13 Hz-Nyquist.
+inline constexpr std::size_t kBandEdges[FeatureVector::kBands + 1] = {
+    1, 5, 13, 33, 128};
+
+// Extract the full feature vector from one window. Isa selects the kernel
+// implementation; pass ScalarIsa in tests to pin down reference values and
+// compare DefaultIsa against it.
+template <typename Isa = DefaultIsa>
+inline void extract_features(const SampleBatch& batch, FeatureVector& out) {
+    const std::size_t n = batch.count;
+    const int16_t* axes[3] = {batch.ax, batch.ay, batch.az};
+
+    for (int a = 0; a < 3; ++a) {
+        const uint64_t ss = Isa::sum_squares(axes[a], n);
+        out.rms[a] = n ? std::sqrt(float(double(ss) / double(n))) : 0.0f;
+        out.zcc[a] = Isa::zero_crossings(axes[a], n);
+    }
+
+    // Accel-magnitude spectrum. DC (gravity plus posture) is removed before
+    // the transform so band 0 measures motion, not orientation.
+    float re[SampleBatch::capacity];
+    float im[SampleBatch::capacity];
+    float mean = 0.0f;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        float m = 0.0f;
+        if (i < n) {
+            const float x = float(batch.ax[i]);
+            const float y = float(batch.ay[i]);
+            const float z = float(batch.az[i]);
+            m = std::sqrt(x * x + y * y + z * z);
+        }
+        re[i] = m;
+        im[i] = 0.0f;
+        mean += m;
+    }
+    mean /= float(SampleBatch::capacity);
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        re[i] -= mean;
+    }
+    detail::fft(re, im, SampleBatch::capacity);
+
+    for (std::size_t b = 0; b < FeatureVector::kBands; ++b) {
+        float e = 0.0f;
+        for (std::size_t k = kBandEdges[b]; k < kBandEdges[b + 1]; ++k) {
+            e += re[k] * re[k] + im[k] * im[k];
+        }
+        out.band_energy[b] = e / float(SampleBatch::capacity);
+    }
+}
+
+}  // namespace collar::dsp
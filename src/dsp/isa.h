@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace collar::dsp {
+
+// ISA policies for the feature-extraction kernels. Each policy implements the
+// same two int16 column primitives; the templates in features.h are
+// instantiated against one of them so the scalar path stays compiled and
+// testable on every build, not just the ones without intrinsics.
+//
+// Selection is compile time: DefaultIsa is NEON on the collar MCU, AVX2 on
+// the ingest hosts, scalar everywhere else.
+
+struct ScalarIsa {
+    static const char* name() { return "scalar"; }
+
+    static uint64_t sum_squares(const int16_t* v, std::size_t n) {
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const int32_t x = v[i];
+            acc += uint64_t(int64_t(x) * x);
+        }
+        return acc;
+    }
+
+    // Sign changes between consecutive samples; zeros inherit the previous
+    // sign so flat stretches do not count as crossings.
+    static uint32_t zero_crossings(const int16_t* v, std::size_t n) {
+        if (n < 2) {
+            return 0;
+        }
+        uint32_t count = 0;
+        int prev = v[0] < 0 ? -1 : 1;
+        for (std::size_t i = 1; i < n; ++i) {
+            if (v[i] == 0) {
+                continue;
+            }
+            const int sign = v[i] < 0 ? -1 : 1;
+            count += uint32_t(sign != prev);
+            prev = sign;
+        }
+        return count;
+    }
+};
+
+#if defined(__AVX2__)
+// 16-wide int16 kernels for the backend replay path. Tails fall back to the
+// scalar policy; the 256-sample window is a multiple of 16, so in practice
+// the tail loop never runs on the hot path.
+struct Avx2Isa {
+    static const char* name() { return "avx2"; }
+
+    static uint64_t sum_squares(const int16_t* v, std::size_t n) {
+        const std::size_t vec_n = n & ~std::size_t(15);
+        __m256i acc = _mm256_setzero_si256();
+        for (std::size_t i = 0; i < vec_n; i += 16) {
+            const __m256i x = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(v + i));
+            // madd pairs 16-bit products into 32-bit lanes; widen to 64 bits
+            // before accumulating so a full-scale window cannot overflow.
+            const __m256i sq = _mm256_madd_epi16(x, x);
+            acc = _mm256_add_epi64(
+                acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(sq)));
+            acc = _mm256_add_epi64(
+                acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(sq, 1)));
+        }
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        return sum + ScalarIsa::sum_squares(v + vec_n, n - vec_n);
+    }
+
+    static uint32_t zero_crossings(const int16_t* v, std::size_t n) {
+        // The sign-carrying rule for zeros makes this inherently serial;
+        // measurements show the scalar loop is already memory-bound at the
+        // window sizes we use, so AVX2 defers to it.
+        return ScalarIsa::zero_crossings(v, n);
+    }
+};
+#endif  // __AVX2__
+
+#if defined(__ARM_NEON)
+// 8-wide int16 kernels for the collar MCU (and aarch64 test hosts).
+struct NeonIsa {
+    static const char* name() { return "neon"; }
+
+    static uint64_t sum_squares(const int16_t* v, std::size_t n) {
+        const std::size_t vec_n = n & ~std::size_t(7);
+        uint64x2_t acc = vdupq_n_u64(0);
+        for (std::size_t i = 0; i < vec_n; i += 8) {
+            const int16x8_t x = vld1q_s16(v + i);
+            const int32x4_t lo = vmull_s16(vget_low_s16(x), vget_low_s16(x));
+            const int32x4_t hi = vmull_s16(vget_high_s16(x), vget_high_s16(x));
+            acc = vaddq_u64(acc, vpaddlq_u32(vreinterpretq_u32_s32(lo)));
+            acc = vaddq_u64(acc, vpaddlq_u32(vreinterpretq_u32_s32(hi)));
+        }
+        uint64_t sum = vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+        return sum + ScalarIsa::sum_squares(v + vec_n, n - vec_n);
+    }
+
+    static uint32_t zero_crossings(const int16_t* v, std::size_t n) {
+        return ScalarIsa::zero_crossings(v, n);
+    }
+};
+#endif  // __ARM_NEON
+
+#if defined(__ARM_NEON)
+using DefaultIsa = NeonIsa;
+#elif defined(__AVX2__)
+using DefaultIsa = Avx2Isa;
+#else
+using DefaultIsa = ScalarIsa;
+#endif
+
+}  // namespace collar::dsp
@@ -0,0 +1,30 @@
+#include "firmware/pipeline.h"
+
+#include "core/imu_fifo.h"
+
+// One translation unit per board target. The COLLAR_BOARD_* definition comes
+// from the build target; explicit instantiation here is what keeps each
+// firmware image down to exactly its own board's code.
+
+namespace collar::fw {
+
+#if defined(COLLAR_BOARD_LSM6DSOX)
+template class SamplePipeline<Lsm6dsoxCfg>;
+using ActivePipeline = SamplePipeline<Lsm6dsoxCfg>;
+using ActiveFifoDriver = ImuFifoDriver<Lsm6dsoxCfg>;
+#elif defined(COLLAR_BOARD_LSM6DSO32)
+template class SamplePipeline<Lsm6dso32Cfg>;
+using ActivePipeline = SamplePipeline<Lsm6dso32Cfg>;
+using ActiveFifoDriver = ImuFifoDriver<Lsm6dso32Cfg>;
+#elif defined(COLLAR_BOARD_BMA400)
+template class SamplePipeline<Bma400Cfg>;
+using ActivePipeline = SamplePipeline<Bma400Cfg>;
+using ActiveFifoDriver = ImuFifoDriver<Bma400Cfg>;
+#else
+#error "firmware target must define exactly one COLLAR_BOARD_* revision"
+#endif
+
+// The ISR-owned pipeline instance for this board image.
+ActivePipeline g_pipeline;
+
+}  // namespace collar::fw
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/board.h"
+#include "core/sample_batch.h"
+#include "core/sample_ring.h"
+
+namespace collar::fw {
+
+// The board-specialized sampling front end: raw FIFO words in, SampleRing
+// out. Instantiated once per hardware revision (one build target per board),
+// so every per-sample decision — word stride, gyro presence, conversion —
+// is baked in at compile time and the gyro-less revision links no gyro code.
+template <typename Cfg, std::size_t RingSize = 512>
+class SamplePipeline {
+public:
+    using board = Board<Cfg>;
+
+    // Called with the burst buffer from one FIFO drain: `records` samples of
+    // board::fifo_words int16 words each, tick_per_sample the ODR period.
+    // Returns how many samples made it into the ring (the rest are drops the
+    // caller must count).
+    std::size_t ingest_fifo(const int16_t* words, std::size_t records,
+                            uint16_t tick_per_sample) {
+        std::size_t pushed = 0;
+        for (std::size_t r = 0; r < records; ++r) {
+            const ImuSample s =
+                board::decode(words + r * board::fifo_words, tick_per_sample);
+            if (!ring_.try_push(s)) {
+                break;
+            }
+            ++pushed;
+        }
+        return pushed;
+    }
+
+    SampleRing<ImuSample, RingSize>& ring() { return ring_; }
+
+private:
+    SampleRing<ImuSample, RingSize> ring_;
+};
+
+}  // namespace collar::fw
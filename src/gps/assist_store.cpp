@@ -0,0 +1,107 @@
+#include "gps/assist_store.h"
+
+#include <cstring>
+
+#include "storage/frame.h"
+
+namespace collar::gps {
+
+namespace {
+
+// One record per flash page: this header, then eph_len ephemeris bytes.
+// CRC-32C covers the whole prefix (header with crc zeroed, plus blob), so
+// a torn program fails validation instead of resurrecting half a record.
+struct AssistRecord {
+    static constexpr uint32_t kMagic = 0x37414743;  // "CGA7"
+
+    uint32_t magic;
+    uint32_t seq;
+    GpsFix fix;
+    uint32_t eph_len;
+    uint32_t crc;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(AssistRecord) == 64, "record layout is on-flash ABI");
+
+uint32_t record_crc(uint8_t* page, std::size_t eph_len) {
+    AssistRecord r;
+    std::memcpy(&r, page, sizeof(r));
+    const uint32_t crc = r.crc;
+    r.crc = 0;
+    std::memcpy(page, &r, sizeof(r));
+    const uint32_t computed =
+        storage::crc32c(page, sizeof(AssistRecord) + eph_len);
+    r.crc = crc;
+    std::memcpy(page, &r, sizeof(r));
+    return computed;
+}
+
+}  // namespace
+
+bool AssistStore::load(Assist& out) {
+    uint8_t page[storage::kFlashPageSize];
+    bool found = false;
+    uint32_t best_seq = 0;
+    next_seq_ = 0;
+    for (std::size_t slot = 0; slot < slot_count(); ++slot) {
+        if (!dev_.read_page(slot, page)) {
+            continue;
+        }
+        AssistRecord r;
+        std::memcpy(&r, page, sizeof(r));
+        if (r.magic != AssistRecord::kMagic || r.eph_len > kEphemerisMax ||
+            r.crc != record_crc(page, r.eph_len)) {
+            continue;
+        }
+        if (r.seq + 1 > next_seq_) {
+            next_seq_ = r.seq + 1;
+        }
+        if (!found || r.seq >= best_seq) {
+            found = true;
+            best_seq = r.seq;
+            out.fix = r.fix;
+            out.eph_len = r.eph_len;
+            std::memcpy(out.ephemeris, page + sizeof(AssistRecord),
+                        r.eph_len);
+        }
+    }
+    scanned_ = true;
+    return found;
+}
+
+bool AssistStore::save(const GpsFix& fix, const uint8_t* ephemeris,
+                       std::size_t eph_len) {
+    if (eph_len > kEphemerisMax ||
+        dev_.page_count() < slot_count()) {
+        return false;
+    }
+    if (!scanned_) {
+        Assist scratch;
+        load(scratch);  // discover next_seq_; a blank store leaves it 0
+    }
+
+    uint8_t page[storage::kFlashPageSize] = {};
+    AssistRecord r{};
+    r.magic = AssistRecord::kMagic;
+    r.seq = next_seq_;
+    r.fix = fix;
+    r.eph_len = uint32_t(eph_len);
+    std::memcpy(page, &r, sizeof(r));
+    std::memcpy(page + sizeof(r), ephemeris, eph_len);
+    r.crc = record_crc(page, eph_len);
+    std::memcpy(page, &r, sizeof(r));
+
+    const std::size_t per = dev_.pages_per_sector();
+    const std::size_t slot = next_seq_ % slot_count();
+    if (slot % per == 0 && !dev_.erase_sector(slot)) {
+        return false;
+    }
+    if (!dev_.program_page(slot, page)) {
+        return false;
+    }
+    ++next_seq_;
+    ++saves_;
+    return true;
+}
+
+}  // namespace collar::gps
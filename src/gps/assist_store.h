@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gps/fix.h"
+#include "storage/flash_log.h"
+
+namespace collar::gps {
+
+// Persistent hot-start state: last known position plus the receiver's
+// ephemeris dump, journaled to flash with the same ping-pong CRC'd record
+// pattern the flash log uses for its metadata — each save programs one
+// fresh page, alternating between two sectors so a brown-out mid-erase
+// always leaves the previous record intact. The device build hands this a
+// dedicated two-sector partition view of the NOR (the log owns its own
+// partition); tests use an in-memory fake.
+//
+// One record per page: header, fix, then the opaque ephemeris blob, all
+// under one CRC. load() picks the highest-sequence valid record, so a torn
+// save costs one assist generation, never a cold boot loop.
+class AssistStore {
+public:
+    explicit AssistStore(storage::FlashDevice& dev) : dev_(dev) {}
+
+    struct Assist {
+        GpsFix fix{};
+        uint8_t ephemeris[kEphemerisMax];
+        uint32_t eph_len = 0;
+    };
+
+    // Scan both sectors for the newest valid record. Returns false on a
+    // blank or corrupt store (first boot) — out is untouched.
+    bool load(Assist& out);
+
+    // Journal a new assist generation. eph_len == 0 is legal (position-only
+    // assist when the receiver refuses an ephemeris dump).
+    bool save(const GpsFix& fix, const uint8_t* ephemeris, std::size_t eph_len);
+
+    uint32_t saves() const { return saves_; }
+
+private:
+    std::size_t slot_count() const { return 2 * dev_.pages_per_sector(); }
+
+    storage::FlashDevice& dev_;
+    uint32_t next_seq_ = 0;  // discovered by the first load()/save()
+    bool scanned_ = false;
+    uint32_t saves_ = 0;
+};
+
+}  // namespace collar::gps
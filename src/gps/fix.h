@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace collar::gps {
+
+// One position fix as the receiver reports it. Coordinates are 1e-7
+// degrees, like the server-side geofence engine, so a fix crosses the
+// upload path without conversion.
+struct GpsFix {
+    uint64_t time_ms;    // uptime when the fix was produced
+    int32_t lat_e7;
+    int32_t lon_e7;
+    int32_t alt_cm;
+    uint16_t hdop_x10;
+    uint8_t sats;
+    uint8_t valid;       // 0 = no fix (timeout callbacks carry this)
+};
+static_assert(sizeof(GpsFix) == 24, "persisted verbatim by the assist store");
+
+// Ceiling for the receiver's opaque ephemeris dump. One flash page minus
+// the assist record header; a full GPS+GLONASS almanac-less dump from the
+// shipping receiver is ~2.2 KB.
+inline constexpr std::size_t kEphemerisMax = 4096 - 64;
+
+}  // namespace collar::gps
@@ -0,0 +1,109 @@
+#include "gps/fix_pipeline.h"
+
+namespace collar::gps {
+
+bool FixPipeline::request_fix(FixFn fn, void* ctx) {
+    if (state_ != State::kIdle || fn == nullptr) {
+        return false;
+    }
+    fn_ = fn;
+    ctx_ = ctx;
+    state_ = State::kStart;
+    return true;
+}
+
+void FixPipeline::service(uint64_t now_ms) {
+    switch (state_) {
+        case State::kIdle:
+            return;
+
+        case State::kStart: {
+            if (!rx_.power_on()) {
+                // Receiver refused to come up; fail the request now rather
+                // than burn the deadline polling a dead part.
+                const GpsFix none{};
+                ++timeouts_;
+                finish(none, now_ms);
+                return;
+            }
+            if (!assist_loaded_) {
+                assist_valid_ = store_.load(assist_);
+                assist_loaded_ = true;
+            }
+            started_ms_ = now_ms;
+            hot_attempt_ = false;
+            fell_back_ = false;
+            const bool pos_fresh =
+                assist_valid_ && assist_.fix.valid != 0 &&
+                now_ms >= assist_.fix.time_ms &&
+                now_ms - assist_.fix.time_ms <= kPositionFreshMs;
+            if (pos_fresh) {
+                const bool eph_fresh =
+                    assist_.eph_len > 0 &&
+                    now_ms - assist_.fix.time_ms <= kEphemerisFreshMs;
+                if (rx_.inject_assist(assist_.fix, assist_.ephemeris,
+                                      eph_fresh ? assist_.eph_len : 0)) {
+                    hot_attempt_ = eph_fresh;
+                }
+            }
+            if (hot_attempt_) {
+                ++hot_starts_;
+                deadline_ms_ = now_ms + kHotDeadlineMs;
+            } else {
+                ++cold_starts_;
+                deadline_ms_ = now_ms + kColdDeadlineMs;
+            }
+            state_ = State::kAcquiring;
+            return;
+        }
+
+        case State::kAcquiring: {
+            GpsFix fix{};
+            if (rx_.poll_fix(fix) && fix.valid != 0) {
+                fix.time_ms = now_ms;
+                // Harvest and journal the new assist generation before the
+                // receiver is gated — the ephemeris dies with the power.
+                assist_.eph_len = uint32_t(
+                    rx_.read_ephemeris(assist_.ephemeris, kEphemerisMax));
+                store_.save(fix, assist_.ephemeris, assist_.eph_len);
+                assist_.fix = fix;
+                assist_valid_ = true;
+                ++fixes_;
+                last_ttf_ms_ = now_ms - started_ms_;
+                finish(fix, now_ms);
+                return;
+            }
+            if (now_ms < deadline_ms_) {
+                return;
+            }
+            if (hot_attempt_ && !fell_back_) {
+                // The journaled ephemeris lied (receiver moved continents,
+                // constellation shifted): keep the receiver up and give the
+                // acquisition a cold-start budget instead of failing.
+                fell_back_ = true;
+                hot_attempt_ = false;
+                ++cold_starts_;
+                deadline_ms_ = now_ms + kColdDeadlineMs;
+                return;
+            }
+            const GpsFix none{};
+            ++timeouts_;
+            finish(none, now_ms);
+            return;
+        }
+    }
+}
+
+void FixPipeline::finish(const GpsFix& fix, uint64_t now_ms) {
+    (void)now_ms;
+    rx_.power_off();
+    state_ = State::kIdle;
+    const FixFn fn = fn_;
+    void* ctx = ctx_;
+    fn_ = nullptr;
+    ctx_ = nullptr;
+    // Callback last: it may immediately queue the next request.
+    fn(ctx, fix);
+}
+
+}  // namespace collar::gps
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gps/assist_store.h"
+#include "gps/fix.h"
+
+namespace collar::gps {
+
+// The vendor receiver boundary. The device build implements this over the
+// vendor library and the receiver's power gate; tests use a scripted fake.
+// All calls run on the main loop — the pipeline never touches the receiver
+// from interrupt context.
+class GpsReceiver {
+public:
+    virtual ~GpsReceiver() = default;
+    virtual bool power_on() = 0;
+    virtual void power_off() = 0;
+    // Hand the receiver its hot-start state before acquisition. eph may be
+    // null/empty for position-and-time-only assist.
+    virtual bool inject_assist(const GpsFix& last, const uint8_t* eph,
+                               std::size_t eph_len) = 0;
+    // Poll acquisition progress; true once a fix is ready.
+    virtual bool poll_fix(GpsFix& out) = 0;
+    // Dump the current ephemeris for persistence. Returns bytes written,
+    // 0 when the receiver has nothing worth saving.
+    virtual std::size_t read_ephemeris(uint8_t* out, std::size_t cap) = 0;
+};
+
+// Deferred fix acquisition with journaled hot-start state. A fix request
+// is asynchronous: request_fix() records the callback, service() (pumped
+// from the main loop) powers the receiver, injects the persisted assist
+// when it is fresh, polls until a fix or the deadline, then powers the
+// receiver back down and journals the new position + ephemeris for next
+// time. With fresh ephemeris the receiver hot-starts in ~2 s instead of
+// the ~28 s cold start the power-gated integration paid on every fix.
+//
+// Freshness is judged on uptime, so the first fix after a reboot is a
+// deliberate cold start — proving assist age across reboots needs the
+// RTC-backed calendar work. A hot start that blows its deadline falls
+// back to a cold-start deadline in place rather than reporting failure;
+// stale-but-plausible ephemeris must never make fixes less reliable than
+// having none.
+class FixPipeline {
+public:
+    using FixFn = void (*)(void* ctx, const GpsFix& fix);
+
+    static constexpr uint64_t kEphemerisFreshMs = 4ull * 3600 * 1000;
+    static constexpr uint64_t kPositionFreshMs = 24ull * 3600 * 1000;
+    static constexpr uint64_t kHotDeadlineMs = 10ull * 1000;
+    static constexpr uint64_t kColdDeadlineMs = 90ull * 1000;
+
+    FixPipeline(GpsReceiver& rx, AssistStore& store)
+        : rx_(rx), store_(store) {}
+    FixPipeline(const FixPipeline&) = delete;
+    FixPipeline& operator=(const FixPipeline&) = delete;
+
+    // Queue one fix request. Returns false while another is in flight —
+    // callers (geofence poll, sync stamping) retry next window.
+    bool request_fix(FixFn fn, void* ctx);
+
+    // Main-loop pump; cheap when idle. Delivers the callback exactly once
+    // per request, with fix.valid == 0 on a hard timeout.
+    void service(uint64_t now_ms);
+
+    bool busy() const { return state_ != State::kIdle; }
+
+    uint32_t fixes() const { return fixes_; }
+    uint32_t timeouts() const { return timeouts_; }
+    uint32_t hot_starts() const { return hot_starts_; }
+    uint32_t cold_starts() const { return cold_starts_; }
+    uint64_t last_ttf_ms() const { return last_ttf_ms_; }
+
+private:
+    enum class State : uint8_t { kIdle, kStart, kAcquiring };
+
+    void finish(const GpsFix& fix, uint64_t now_ms);
+
+    GpsReceiver& rx_;
+    AssistStore& store_;
+    State state_ = State::kIdle;
+    FixFn fn_ = nullptr;
+    void* ctx_ = nullptr;
+    uint64_t started_ms_ = 0;
+    uint64_t deadline_ms_ = 0;
+    bool hot_attempt_ = false;
+    bool fell_back_ = false;
+    bool assist_loaded_ = false;
+    bool assist_valid_ = false;
+    AssistStore::Assist assist_;
+    uint32_t fixes_ = 0;
+    uint32_t timeouts_ = 0;
+    uint32_t hot_starts_ = 0;
+    uint32_t cold_starts_ = 0;
+    uint64_t last_ttf_ms_ = 0;
+};
+
+}  // namespace collar::gps
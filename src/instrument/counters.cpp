@@ -0,0 +1,100 @@
+#include "instrument/counters.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace collar::instrument {
+
+namespace {
+
+// Label values, in Stage order. snake_case because they become Prometheus
+// label values and dashboard legends verbatim.
+constexpr const char* kStageNames[kStageCount] = {
+    "isr_to_ring",  "ring_to_flash", "flash_to_ble",
+    "ingest_decode", "anomaly",       "archive_write",
+};
+
+struct Field {
+    const char* metric;
+    uint64_t StageSnapshot::*value;
+};
+
+constexpr Field kFields[] = {
+    {"collar_stage_samples_in_total", &StageSnapshot::samples_in},
+    {"collar_stage_samples_out_total", &StageSnapshot::samples_out},
+    {"collar_stage_drops_total", &StageSnapshot::drops},
+    {"collar_stage_stalls_total", &StageSnapshot::stalls},
+    {"collar_stage_bytes_total", &StageSnapshot::bytes},
+};
+
+void put_u64_le(uint64_t v, uint8_t* out) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = uint8_t(v >> (8 * i));
+    }
+}
+
+}  // namespace
+
+const char* stage_name(Stage s) { return kStageNames[std::size_t(s)]; }
+
+void reset_stage_counters() {
+    for (std::size_t s = 0; s < kStageCount; ++s) {
+        StageCounters& c = g_stage_counters[s];
+        c.samples_in.store(0, std::memory_order_relaxed);
+        c.samples_out.store(0, std::memory_order_relaxed);
+        c.drops.store(0, std::memory_order_relaxed);
+        c.stalls.store(0, std::memory_order_relaxed);
+        c.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::size_t counters_gatt_read(uint8_t* out, std::size_t cap) {
+    if (cap < kCountersBlobSize) {
+        return 0;
+    }
+    out[0] = kCountersBlobVersion;
+    out[1] = uint8_t(kStageCount);
+    out[2] = 0;
+    out[3] = 0;
+    uint8_t* p = out + 4;
+    for (std::size_t s = 0; s < kStageCount; ++s) {
+        const StageSnapshot snap = snapshot_counters(Stage(s));
+        put_u64_le(snap.samples_in, p);
+        put_u64_le(snap.samples_out, p + 8);
+        put_u64_le(snap.drops, p + 16);
+        put_u64_le(snap.stalls, p + 24);
+        put_u64_le(snap.bytes, p + 32);
+        p += 40;
+    }
+    return kCountersBlobSize;
+}
+
+std::size_t counters_prometheus(char* out, std::size_t cap) {
+    StageSnapshot snaps[kStageCount];
+    for (std::size_t s = 0; s < kStageCount; ++s) {
+        snaps[s] = snapshot_counters(Stage(s));
+    }
+    std::size_t off = 0;
+    for (const Field& f : kFields) {
+        int n = std::snprintf(out + off, cap - off, "# TYPE %s counter\n",
+                              f.metric);
+        if (n < 0 || std::size_t(n) >= cap - off) {
+            return 0;
+        }
+        off += std::size_t(n);
+        for (std::size_t s = 0; s < kStageCount; ++s) {
+            n = std::snprintf(out + off, cap - off,
+                              "%s{stage=\"%s\"} %llu\n", f.metric,
+                              kStageNames[s],
+                              static_cast<unsigned long long>(
+                                  snaps[s].*(f.value)));
+            if (n < 0 || std::size_t(n) >= cap - off) {
+                return 0;
+            }
+            off += std::size_t(n);
+        }
+    }
+    return off;
+}
+
+}  // namespace collar::instrument
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Per-stage conservation counters. Every stage the sample path flows
+// through — FIFO drain into the ring, ring into flash, flash out over BLE,
+// ingest decode, the anomaly pass, the archive write — owns one fixed slot
+// of monotonic counters: samples in, samples out, drops, stalls, bytes.
+// When a customer reports a gap, the stage whose in/out stops balancing is
+// the answer; no log greps.
+//
+// The table is a fixed array of cache-line-sized slots, so two stages
+// updating from different cores (or the radio ISR and the main loop) never
+// share a line. All updates are relaxed atomics: on the single-core
+// Cortex-M builds they compile to plain load/store pairs, and on the
+// backend the counters are statistics, not synchronization.
+//
+// Readout: counters_gatt_read() packs the table into one ≤244-byte blob
+// (the debug GATT characteristic's read handler calls it — it fits a
+// single 247-MTU read), and counters_prometheus() renders the Prometheus
+// text format collar_ingestd serves on its metrics port.
+
+namespace collar::instrument {
+
+enum class Stage : uint8_t {
+    kIsrToRing = 0,   // IMU FIFO drain -> SampleRing
+    kRingToFlash,     // SampleRing -> FlashLog windows
+    kFlashToBle,      // FlashLog pages -> BLE notifications
+    kIngestDecode,    // wire pages -> decoded SampleBatch
+    kAnomaly,         // health monitor pass
+    kArchiveWrite,    // group commit -> archive segments
+};
+inline constexpr std::size_t kStageCount = 6;
+
+const char* stage_name(Stage s);
+
+struct alignas(64) StageCounters {
+    std::atomic<uint64_t> samples_in{0};
+    std::atomic<uint64_t> samples_out{0};
+    std::atomic<uint64_t> drops{0};
+    std::atomic<uint64_t> stalls{0};
+    std::atomic<uint64_t> bytes{0};
+
+    void add_in(uint64_t n) {
+        samples_in.fetch_add(n, std::memory_order_relaxed);
+    }
+    void add_out(uint64_t n) {
+        samples_out.fetch_add(n, std::memory_order_relaxed);
+    }
+    void add_drops(uint64_t n) {
+        drops.fetch_add(n, std::memory_order_relaxed);
+    }
+    void add_stalls(uint64_t n) {
+        stalls.fetch_add(n, std::memory_order_relaxed);
+    }
+    void add_bytes(uint64_t n) {
+        bytes.fetch_add(n, std::memory_order_relaxed);
+    }
+};
+static_assert(sizeof(StageCounters) == 64,
+              "one slot per cache line, no false sharing between stages");
+
+// The table itself is an inline global so the firmware libraries can
+// increment through the header alone; only the formatters below need the
+// instrument library linked.
+inline StageCounters g_stage_counters[kStageCount];
+
+inline StageCounters& stage_counters(Stage s) {
+    return g_stage_counters[std::size_t(s)];
+}
+
+// Coherent-enough copy of one slot (fields are read independently; exact
+// cross-field consistency is not promised, same as any scrape).
+struct StageSnapshot {
+    uint64_t samples_in;
+    uint64_t samples_out;
+    uint64_t drops;
+    uint64_t stalls;
+    uint64_t bytes;
+};
+
+inline StageSnapshot snapshot_counters(Stage s) {
+    const StageCounters& c = stage_counters(s);
+    return {c.samples_in.load(std::memory_order_relaxed),
+            c.samples_out.load(std::memory_order_relaxed),
+            c.drops.load(std::memory_order_relaxed),
+            c.stalls.load(std::memory_order_relaxed),
+            c.bytes.load(std::memory_order_relaxed)};
+}
+
+// Zero the whole table. Tests only — production counters are monotonic by
+// contract so rate() and increase() work on the scraped series.
+void reset_stage_counters();
+
+// Debug GATT characteristic payload: a 4-byte header {version, stage
+// count, reserved} followed by five little-endian u64 per stage, in Stage
+// order. Returns the bytes written, 0 if cap is too small for the table.
+inline constexpr uint8_t kCountersBlobVersion = 1;
+inline constexpr std::size_t kCountersBlobSize = 4 + kStageCount * 5 * 8;
+std::size_t counters_gatt_read(uint8_t* out, std::size_t cap);
+
+// Prometheus text exposition (one counter family per field, stage as a
+// label). Returns the bytes written, 0 if cap is too small.
+std::size_t counters_prometheus(char* out, std::size_t cap);
+
+}  // namespace collar::instrument
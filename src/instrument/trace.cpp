@@ -0,0 +1,76 @@
+#include "instrument/trace.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if !defined(__ARM_ARCH) && !defined(__x86_64__)
+#include <chrono>
+#endif
+
+namespace collar::instrument {
+
+#if !defined(__ARM_ARCH) && !defined(__x86_64__)
+uint64_t cycles_now() {
+    return uint64_t(std::chrono::steady_clock::now().time_since_epoch() /
+                    std::chrono::nanoseconds(1));
+}
+#endif
+
+namespace {
+TraceStat g_slots[kMaxTraceScopes];
+std::size_t g_used = 0;
+TraceStat g_overflow{"<overflow>"};
+}  // namespace
+
+TraceStat& acquire_trace_slot(const char* name) {
+    if (g_used >= kMaxTraceScopes) {
+        // Table full: fold extra scopes into one bucket rather than faulting
+        // in a path that exists to debug other faults.
+        return g_overflow;
+    }
+    TraceStat& s = g_slots[g_used++];
+    s.name = name;
+    return s;
+}
+
+std::size_t visit_traces(void (*fn)(const TraceStat&, void*), void* ctx) {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < g_used; ++i) {
+        if (g_slots[i].count) {
+            fn(g_slots[i], ctx);
+            ++n;
+        }
+    }
+    return n;
+}
+
+void reset_traces() {
+    for (std::size_t i = 0; i < g_used; ++i) {
+        const char* name = g_slots[i].name;
+        g_slots[i] = TraceStat{};
+        g_slots[i].name = name;
+    }
+    const char* name = g_overflow.name;
+    g_overflow = TraceStat{};
+    g_overflow.name = name;
+}
+
+void dump_traces(void (*putline)(const char*, void*), void* ctx) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-24s %10s %12s %12s %12s", "scope",
+                  "count", "mean", "min", "max");
+    putline(line, ctx);
+    for (std::size_t i = 0; i < g_used; ++i) {
+        const TraceStat& s = g_slots[i];
+        if (!s.count) {
+            continue;
+        }
+        std::snprintf(line, sizeof(line),
+                      "%-24s %10llu %12llu %12llu %12llu", s.name,
+                      (unsigned long long)s.count, (unsigned long long)s.mean(),
+                      (unsigned long long)s.min, (unsigned long long)s.max);
+        putline(line, ctx);
+    }
+}
+
+}  // namespace collar::instrument
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Hot-path scope timing. Drop COLLAR_TRACE_SCOPE("name") at the top of a
+// block and the registry accumulates count/min/max/total cycles for it;
+// dump_traces() formats the table for the debug UART (or stderr on host).
+//
+// Timebase: DWT->CYCCNT on the Cortex-M builds, rdtsc on x86 hosts,
+// steady_clock nanoseconds elsewhere. Values are only compared against the
+// same scope on the same build, so the unit mismatch is fine.
+//
+// Builds with -DCOLLAR_TRACE=0 compile the macro to nothing at all — no
+// registry, no statics, no branch; shipping firmware pays zero for this.
+
+#ifndef COLLAR_TRACE
+#define COLLAR_TRACE 1
+#endif
+
+namespace collar::instrument {
+
+#if defined(__ARM_ARCH) && !defined(__aarch64__)
+// DWT cycle counter; CYCCNT must have been enabled by startup code.
+inline uint64_t cycles_now() {
+    return *reinterpret_cast<volatile uint32_t*>(0xE0001004);  // DWT->CYCCNT
+}
+#elif defined(__x86_64__)
+inline uint64_t cycles_now() {
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return (uint64_t(hi) << 32) | lo;
+}
+#else
+uint64_t cycles_now();  // steady_clock fallback, in trace.cpp
+#endif
+
+struct TraceStat {
+    const char* name = nullptr;
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t min = ~uint64_t(0);
+    uint64_t max = 0;
+
+    uint64_t mean() const { return count ? total / count : 0; }
+};
+
+// Fixed-size table of scopes; a slot is claimed once per scope via a
+// function-local static, so steady state is a pointer-indexed accumulate
+// with no lookup. Single writer per scope (ISR or main loop, not both).
+inline constexpr std::size_t kMaxTraceScopes = 64;
+
+TraceStat& acquire_trace_slot(const char* name);
+
+// Iterate non-empty slots; returns the number visited.
+std::size_t visit_traces(void (*fn)(const TraceStat&, void*), void* ctx);
+
+// Zero all accumulators (slot names stay claimed).
+void reset_traces();
+
+// Format the table through a line sink — the debug UART putline on device,
+// stderr-backed in the host tools.
+void dump_traces(void (*putline)(const char*, void*), void* ctx);
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(TraceStat& stat)
+        : stat_(stat), start_(cycles_now()) {}
+    ~ScopedTimer() {
+        const uint64_t dt = cycles_now() - start_;
+        ++stat_.count;
+        stat_.total += dt;
+        if (dt < stat_.min) stat_.min = dt;
+        if (dt > stat_.max) stat_.max = dt;
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    TraceStat& stat_;
+    uint64_t start_;
+};
+
+}  // namespace collar::instrument
+
+#if COLLAR_TRACE
+#define COLLAR_TRACE_CONCAT2(a, b) a##b
+#define COLLAR_TRACE_CONCAT(a, b) COLLAR_TRACE_CONCAT2(a, b)
+#define COLLAR_TRACE_SCOPE(name)                                             \
+    static ::collar::instrument::TraceStat& COLLAR_TRACE_CONCAT(             \
+        collar_trace_slot_, __LINE__) =                                      \
+        ::collar::instrument::acquire_trace_slot(name);                      \
+    ::collar::instrument::ScopedTimer COLLAR_TRACE_CONCAT(                   \
+        collar_trace_timer_, __LINE__)(COLLAR_TRACE_CONCAT(                  \
+        collar_trace_slot_, __LINE__))
+#else
+#define COLLAR_TRACE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,87 @@
+#include "ota/ota_client.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "storage/frame.h"  // crc32c
+
+namespace collar::ota {
+
+void OtaClient::begin(uint32_t release_id, uint32_t resume_offset,
+                      ChunkSink sink, void* sink_ctx) {
+    state_ = State::kTransfer;
+    release_id_ = release_id;
+    offset_ = resume_offset;
+    image_size_ = 0;
+    sink_ = sink;
+    sink_ctx_ = sink_ctx;
+    hdr_got_ = 0;
+    payload_got_ = 0;
+}
+
+std::size_t OtaClient::next_request(uint8_t* buf) const {
+    if (state_ != State::kTransfer) {
+        return 0;
+    }
+    OtaRequest req{};
+    req.magic = OtaRequest::kMagic;
+    req.release_id = release_id_;
+    req.offset = offset_;
+    req.max_len = kOtaChunkSize;
+    std::memcpy(buf, &req, sizeof(req));
+    return sizeof(req);
+}
+
+bool OtaClient::on_bytes(const uint8_t* data, std::size_t len) {
+    while (len > 0) {
+        if (state_ != State::kTransfer) {
+            return state_ != State::kFailed;
+        }
+        if (hdr_got_ < sizeof(hdr_buf_)) {
+            const std::size_t take =
+                std::min(len, sizeof(hdr_buf_) - hdr_got_);
+            std::memcpy(hdr_buf_ + hdr_got_, data, take);
+            hdr_got_ += take;
+            data += take;
+            len -= take;
+            if (hdr_got_ < sizeof(hdr_buf_)) {
+                return true;
+            }
+            std::memcpy(&hdr_, hdr_buf_, sizeof(hdr_));
+            if (hdr_.magic != OtaChunkHeader::kMagic ||
+                hdr_.release_id != release_id_ ||
+                hdr_.offset != offset_ || hdr_.len == 0 ||
+                hdr_.len > kOtaChunkSize) {
+                fail();
+                return false;
+            }
+            image_size_ = hdr_.image_size;
+            payload_got_ = 0;
+            continue;
+        }
+
+        const std::size_t take = std::min(len, hdr_.len - payload_got_);
+        std::memcpy(payload_ + payload_got_, data, take);
+        payload_got_ += take;
+        data += take;
+        len -= take;
+        if (payload_got_ < hdr_.len) {
+            return true;
+        }
+
+        // Full chunk assembled: verify before a single byte hits flash.
+        if (storage::crc32c(payload_, hdr_.len) != hdr_.crc ||
+            !sink_(sink_ctx_, offset_, payload_, hdr_.len)) {
+            fail();
+            return false;
+        }
+        offset_ += hdr_.len;
+        hdr_got_ = 0;
+        if (offset_ >= image_size_) {
+            state_ = State::kDone;
+        }
+    }
+    return true;
+}
+
+}  // namespace collar::ota
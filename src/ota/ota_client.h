@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ota/protocol.h"
+
+namespace collar::ota {
+
+// Collar-side OTA updater state machine. Transport-agnostic: the caller
+// owns the link (BLE relay through the phone, or TCP on the bench rig),
+// pumps next_request() bytes out and feeds response bytes back in through
+// on_bytes(). Verified chunks are handed to a sink callback — on device,
+// the staging-slot flash writer. Progress is a single offset, so resuming
+// after a reboot is begin() at the journaled offset.
+class OtaClient {
+public:
+    // sink receives (offset, data, len) for each CRC-verified chunk; it
+    // returns false to abort (flash write failure).
+    using ChunkSink = bool (*)(void* ctx, uint32_t offset,
+                               const uint8_t* data, uint32_t len);
+
+    void begin(uint32_t release_id, uint32_t resume_offset, ChunkSink sink,
+               void* sink_ctx);
+
+    // Serialize the next request into buf (>= sizeof(OtaRequest) bytes).
+    // Returns 0 when the update is complete or failed.
+    std::size_t next_request(uint8_t* buf) const;
+
+    // Feed raw response bytes (any framing the transport delivers).
+    // Returns false once the update has failed; idle otherwise-complete
+    // clients ignore trailing bytes.
+    bool on_bytes(const uint8_t* data, std::size_t len);
+
+    bool done() const { return state_ == State::kDone; }
+    bool failed() const { return state_ == State::kFailed; }
+    uint32_t offset() const { return offset_; }
+    uint32_t image_size() const { return image_size_; }
+
+private:
+    enum class State : uint8_t { kIdle, kTransfer, kDone, kFailed };
+
+    void fail() { state_ = State::kFailed; }
+
+    State state_ = State::kIdle;
+    uint32_t release_id_ = 0;
+    uint32_t offset_ = 0;
+    uint32_t image_size_ = 0;   // 0 until the first header arrives
+    ChunkSink sink_ = nullptr;
+    void* sink_ctx_ = nullptr;
+
+    // Response reassembly: header, then payload, across arbitrary
+    // transport fragmentation.
+    uint8_t hdr_buf_[sizeof(OtaChunkHeader)];
+    std::size_t hdr_got_ = 0;
+    uint8_t payload_[kOtaChunkSize];
+    std::size_t payload_got_ = 0;
+    OtaChunkHeader hdr_{};
+};
+
+}  // namespace collar::ota
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace collar::ota {
+
+// OTA transfer protocol, shared between the collar-side updater and the
+// distribution server. Resumable by construction: every request names an
+// absolute (release, offset) pair, so a collar that reboots mid-update just
+// asks for the offset its journal says it last committed.
+
+inline constexpr uint32_t kOtaChunkSize = 4096;  // one flash page per chunk
+
+struct OtaRequest {
+    static constexpr uint32_t kMagic = 0x41544f37;  // "7OTA"
+
+    uint32_t magic;
+    uint32_t release_id;
+    uint32_t offset;      // byte offset into the image, chunk-aligned
+    uint32_t max_len;     // largest chunk the link can take this round
+};
+static_assert(sizeof(OtaRequest) == 16, "wire ABI");
+
+struct OtaChunkHeader {
+    static constexpr uint32_t kMagic = 0x4b484f37;  // "7OHK"
+
+    uint32_t magic;
+    uint32_t release_id;
+    uint32_t offset;
+    uint32_t len;         // payload bytes following this header; 0 = EOF/error
+    uint32_t crc;         // CRC-32C of the payload
+    uint32_t image_size;  // total image bytes, lets the client size progress
+    uint32_t image_crc;   // release signature surrogate: CRC-32C of the image
+    uint32_t pad;
+};
+static_assert(sizeof(OtaChunkHeader) == 32, "wire ABI");
+
+}  // namespace collar::ota
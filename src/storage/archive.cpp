@@ -0,0 +1,481 @@
+#include "storage/archive.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "storage/varint.h"
+
+namespace collar::storage {
+
+namespace {
+
+const int16_t* signed_column(const SampleBatch& b, ColumnId c) {
+    switch (c) {
+        case ColumnId::kAx: return b.ax;
+        case ColumnId::kAy: return b.ay;
+        case ColumnId::kAz: return b.az;
+        case ColumnId::kGx: return b.gx;
+        case ColumnId::kGy: return b.gy;
+        case ColumnId::kGz: return b.gz;
+        default: return b.temp;
+    }
+}
+
+// FOR block size: small enough that one noisy stretch cannot widen a whole
+// segment, large enough that the per-block width byte is noise.
+constexpr std::size_t kForBlock = 128;
+
+bool decode_for_packed(const uint8_t* p, std::size_t bytes, std::size_t n,
+                       int16_t* out) {
+    const uint8_t* end = p + bytes;
+    int32_t prev = 0;
+    std::size_t i = 0;
+    while (i < n) {
+        const std::size_t cnt = n - i < kForBlock ? n - i : kForBlock;
+        if (p >= end) {
+            return false;
+        }
+        const uint8_t bw = *p++;
+        if (bw > 17 || std::size_t(end - p) < (cnt * bw + 7) / 8) {
+            return false;
+        }
+        uint64_t acc = 0;
+        int avail = 0;
+        for (std::size_t k = 0; k < cnt; ++k) {
+            while (avail < bw) {
+                acc |= uint64_t(*p++) << avail;
+                avail += 8;
+            }
+            const uint32_t zz =
+                uint32_t(acc & ((uint64_t(1) << bw) - 1));
+            acc >>= bw;
+            avail -= bw;
+            prev += unzigzag32(zz);
+            out[i + k] = int16_t(prev);
+        }
+        i += cnt;
+    }
+    return p == end;
+}
+
+// Header of the <path>.meta sidecar journal; raw SegmentMeta records
+// follow. The record size is the torn-write unit: recovery only trusts
+// whole records whose extents fit the data actually on disk.
+struct MetaJournalHeader {
+    static constexpr uint32_t kMagic = 0x4c4a4137;  // "7AJL"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t pad;
+};
+static_assert(sizeof(MetaJournalHeader) == 16, "journal layout is on-disk ABI");
+
+bool write_all(int fd, uint64_t off, const void* data, std::size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (len > 0) {
+        const ssize_t n = ::pwrite(fd, p, len, off_t(off));
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        off += uint64_t(n);
+        len -= std::size_t(n);
+    }
+    return true;
+}
+
+}  // namespace
+
+std::size_t encode_column_signed(const int16_t* col, std::size_t n,
+                                 uint8_t* out) {
+    uint8_t* p = out;
+    int32_t prev = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        p += put_varint32(p, zigzag32(int32_t(col[i]) - prev));
+        prev = col[i];
+    }
+    return std::size_t(p - out);
+}
+
+std::size_t encode_column_dt(const uint16_t* col, std::size_t n,
+                             uint8_t* out) {
+    uint8_t* p = out;
+    for (std::size_t i = 0; i < n; ++i) {
+        p += put_varint32(p, col[i]);
+    }
+    return std::size_t(p - out);
+}
+
+std::size_t encode_column_for_packed(const int16_t* col, std::size_t n,
+                                     uint8_t* out) {
+    uint8_t* p = out;
+    int32_t prev = 0;
+    std::size_t i = 0;
+    uint32_t zz[kForBlock];
+    while (i < n) {
+        const std::size_t cnt = n - i < kForBlock ? n - i : kForBlock;
+        uint32_t maxv = 0;
+        for (std::size_t k = 0; k < cnt; ++k) {
+            zz[k] = zigzag32(int32_t(col[i + k]) - prev);
+            prev = col[i + k];
+            maxv |= zz[k];
+        }
+        uint8_t bw = 0;
+        while (maxv >> bw) {
+            ++bw;
+        }
+        *p++ = bw;
+        uint64_t acc = 0;
+        int bits = 0;
+        for (std::size_t k = 0; k < cnt; ++k) {
+            acc |= uint64_t(zz[k]) << bits;
+            bits += bw;
+            while (bits >= 8) {
+                *p++ = uint8_t(acc & 0xff);
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        if (bits > 0) {
+            *p++ = uint8_t(acc & 0xff);
+        }
+        i += cnt;
+    }
+    return std::size_t(p - out);
+}
+
+ArchiveWriter::~ArchiveWriter() {
+    if (fd_ >= 0) {
+        close();
+    }
+}
+
+bool ArchiveWriter::open(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        return false;
+    }
+    journal_path_ = path + ".meta";
+    jfd_ = ::open(journal_path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (jfd_ < 0) {
+        return false;
+    }
+    if (st.st_size == 0) {
+        write_off_ = 0;
+        return reseed_journal();
+    }
+    // Existing archive: recover the footer, then truncate it away — data
+    // stays, the footer is rewritten on close.
+    ArchiveTrailer tr;
+    // Same subtraction-form bounds as the reader: the additive check can
+    // wrap uint64 on a corrupt trailer.
+    if (std::size_t(st.st_size) >= sizeof(tr) &&
+        ::pread(fd_, &tr, sizeof(tr),
+                off_t(st.st_size - off_t(sizeof(tr)))) == ssize_t(sizeof(tr)) &&
+        tr.magic == ArchiveTrailer::kMagic &&
+        tr.version == ArchiveTrailer::kVersion &&
+        tr.footer_offset <= uint64_t(st.st_size) - sizeof(tr) &&
+        tr.segment_count <= (uint64_t(st.st_size) - sizeof(tr) -
+                             tr.footer_offset) /
+                                sizeof(SegmentMeta)) {
+        metas_.resize(tr.segment_count);
+        const std::size_t footer_bytes =
+            tr.segment_count * sizeof(SegmentMeta);
+        if (::pread(fd_, metas_.data(), footer_bytes,
+                    off_t(tr.footer_offset)) != ssize_t(footer_bytes)) {
+            return false;
+        }
+        write_off_ = tr.footer_offset;
+        return ::ftruncate(fd_, off_t(write_off_)) == 0 && reseed_journal();
+    }
+    // No footer: the writer died between sync() and close(). Everything
+    // the journal lists was fdatasynced before its meta was journaled, so
+    // rebuild the index from there and drop the torn tail.
+    return recover_from_journal(uint64_t(st.st_size));
+}
+
+bool ArchiveWriter::reseed_journal() {
+    // The journal mirrors metas_ from the first sync on; seeding it with
+    // the recovered footer keeps that invariant across reopen-for-append.
+    MetaJournalHeader hdr{MetaJournalHeader::kMagic,
+                          MetaJournalHeader::kVersion, 0};
+    journaled_ = metas_.size();
+    return ::ftruncate(jfd_, 0) == 0 && write_all(jfd_, 0, &hdr, sizeof(hdr)) &&
+           (metas_.empty() ||
+            write_all(jfd_, sizeof(hdr), metas_.data(),
+                      metas_.size() * sizeof(SegmentMeta))) &&
+           ::fsync(jfd_) == 0;
+}
+
+bool ArchiveWriter::recover_from_journal(uint64_t data_size) {
+    struct stat jst;
+    if (::fstat(jfd_, &jst) != 0 ||
+        std::size_t(jst.st_size) < sizeof(MetaJournalHeader)) {
+        return false;
+    }
+    MetaJournalHeader hdr;
+    if (::pread(jfd_, &hdr, sizeof(hdr), 0) != ssize_t(sizeof(hdr)) ||
+        hdr.magic != MetaJournalHeader::kMagic ||
+        hdr.version != MetaJournalHeader::kVersion) {
+        return false;
+    }
+    const std::size_t records =
+        (std::size_t(jst.st_size) - sizeof(hdr)) / sizeof(SegmentMeta);
+    metas_.clear();
+    write_off_ = 0;
+    for (std::size_t i = 0; i < records; ++i) {
+        SegmentMeta m;
+        if (::pread(jfd_, &m, sizeof(m),
+                    off_t(sizeof(hdr) + i * sizeof(m))) !=
+            ssize_t(sizeof(m))) {
+            return false;
+        }
+        // Every journaled extent must lie inside the data actually on
+        // disk; a record failing that is the tail of a dying write and
+        // ends the recovery.
+        bool sane =
+            m.sample_count != 0 && m.sample_count <= kArchiveMaxSegmentSamples;
+        uint64_t end = write_off_;
+        for (std::size_t c = 0; c < kArchiveColumns; ++c) {
+            sane = sane && m.col[c].codec <= kCodecForPacked &&
+                   m.col[c].offset + m.col[c].bytes <= data_size;
+            if (m.col[c].offset + m.col[c].bytes > end) {
+                end = m.col[c].offset + m.col[c].bytes;
+            }
+        }
+        if (!sane) {
+            break;
+        }
+        metas_.push_back(m);
+        write_off_ = end;
+    }
+    // Truncate both files back to the recovered state: the data file loses
+    // its torn tail, the journal any partial record.
+    journaled_ = metas_.size();
+    return ::ftruncate(fd_, off_t(write_off_)) == 0 &&
+           ::ftruncate(jfd_, off_t(sizeof(hdr) +
+                                   journaled_ * sizeof(SegmentMeta))) == 0;
+}
+
+bool ArchiveWriter::append(uint64_t collar_id, const SampleBatch& batch) {
+    if (fd_ < 0 || batch.empty()) {
+        return false;
+    }
+    std::vector<uint8_t> buf(column_codec_bound(batch.count));
+
+    SegmentMeta meta{};
+    meta.collar_id = collar_id;
+    meta.base_tick = batch.base_tick;
+    meta.sample_count = uint32_t(batch.count);
+    for (std::size_t c = 0; c < kArchiveColumns; ++c) {
+        std::size_t bytes;
+        uint8_t codec;
+        if (ColumnId(c) == ColumnId::kDt) {
+            bytes = encode_column_dt(batch.dt, batch.count, buf.data());
+            codec = kCodecVarint;
+        } else {
+            bytes = encode_column_signed(signed_column(batch, ColumnId(c)),
+                                         batch.count, buf.data());
+            codec = kCodecDeltaVarint;
+        }
+        if (!write_all(fd_, write_off_, buf.data(), bytes)) {
+            return false;
+        }
+        meta.col[c] = {write_off_, uint32_t(bytes), codec, {}};
+        write_off_ += bytes;
+    }
+    metas_.push_back(meta);
+    return true;
+}
+
+bool ArchiveWriter::append_encoded(uint64_t collar_id, uint64_t base_tick,
+                                   uint32_t sample_count,
+                                   const EncodedColumn cols[kArchiveColumns]) {
+    if (fd_ < 0 || sample_count == 0 ||
+        sample_count > kArchiveMaxSegmentSamples) {
+        return false;
+    }
+    SegmentMeta meta{};
+    meta.collar_id = collar_id;
+    meta.base_tick = base_tick;
+    meta.sample_count = sample_count;
+    for (std::size_t c = 0; c < kArchiveColumns; ++c) {
+        if (!write_all(fd_, write_off_, cols[c].data, cols[c].bytes)) {
+            return false;
+        }
+        meta.col[c] = {write_off_, cols[c].bytes, cols[c].codec, {}};
+        write_off_ += cols[c].bytes;
+    }
+    metas_.push_back(meta);
+    return true;
+}
+
+bool ArchiveWriter::sync() {
+    if (fd_ < 0 || ::fdatasync(fd_) != 0) {
+        return false;
+    }
+    // Journal the new row groups only after their data is durable, so a
+    // journaled meta is always backed by real bytes.
+    if (journaled_ < metas_.size()) {
+        const uint64_t off =
+            sizeof(MetaJournalHeader) + journaled_ * sizeof(SegmentMeta);
+        if (!write_all(jfd_, off, metas_.data() + journaled_,
+                       (metas_.size() - journaled_) * sizeof(SegmentMeta)) ||
+            ::fdatasync(jfd_) != 0) {
+            return false;
+        }
+        journaled_ = metas_.size();
+    }
+    return true;
+}
+
+bool ArchiveWriter::close() {
+    if (fd_ < 0) {
+        return false;
+    }
+    ArchiveTrailer tr{};
+    tr.footer_offset = write_off_;
+    tr.segment_count = uint32_t(metas_.size());
+    tr.version = ArchiveTrailer::kVersion;
+    tr.magic = ArchiveTrailer::kMagic;
+
+    const std::size_t footer_bytes = metas_.size() * sizeof(SegmentMeta);
+    bool ok = write_all(fd_, write_off_, metas_.data(), footer_bytes) &&
+              write_all(fd_, write_off_ + footer_bytes, &tr, sizeof(tr)) &&
+              ::fsync(fd_) == 0;
+    ok = (::close(fd_) == 0) && ok;
+    fd_ = -1;
+    if (jfd_ >= 0) {
+        ::close(jfd_);
+        jfd_ = -1;
+        if (ok) {
+            ::unlink(journal_path_.c_str());  // the footer supersedes it
+        }
+    }
+    metas_.clear();
+    write_off_ = 0;
+    journaled_ = 0;
+    return ok;
+}
+
+ArchiveReader::~ArchiveReader() {
+    if (map_) {
+        ::munmap(const_cast<uint8_t*>(map_), map_len_);
+    }
+}
+
+bool ArchiveReader::open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 ||
+        std::size_t(st.st_size) < sizeof(ArchiveTrailer)) {
+        ::close(fd);
+        return false;
+    }
+    map_len_ = std::size_t(st.st_size);
+    void* m = ::mmap(nullptr, map_len_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file alive
+    if (m == MAP_FAILED) {
+        return false;
+    }
+    map_ = static_cast<const uint8_t*>(m);
+
+    ArchiveTrailer tr;
+    std::memcpy(&tr, map_ + map_len_ - sizeof(tr), sizeof(tr));
+    // Subtraction form only: summing footer_offset and the footer size can
+    // wrap uint64 on a hostile trailer and sail past the bound.
+    const uint64_t avail = map_len_ - sizeof(tr);
+    if (tr.magic != ArchiveTrailer::kMagic ||
+        tr.version != ArchiveTrailer::kVersion || tr.footer_offset > avail ||
+        tr.segment_count >
+            (avail - tr.footer_offset) / sizeof(SegmentMeta)) {
+        return false;
+    }
+    metas_ = reinterpret_cast<const SegmentMeta*>(map_ + tr.footer_offset);
+    seg_count_ = tr.segment_count;
+    // Readers size scratch buffers from sample_count, so a corrupt footer
+    // must not smuggle an absurd value past open().
+    for (std::size_t i = 0; i < seg_count_; ++i) {
+        if (metas_[i].sample_count > kArchiveMaxSegmentSamples) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const uint8_t* ArchiveReader::segment_data(std::size_t i, ColumnId col,
+                                           std::size_t& bytes) const {
+    if (i >= seg_count_) {
+        return nullptr;
+    }
+    const SegmentColumn& c = metas_[i].col[std::size_t(col)];
+    // offset + bytes can wrap on a corrupt footer row; check by
+    // subtraction.
+    if (c.offset > map_len_ || c.bytes > map_len_ - c.offset) {
+        return nullptr;
+    }
+    bytes = c.bytes;
+    return map_ + c.offset;
+}
+
+bool ArchiveReader::read_column(std::size_t i, ColumnId col,
+                                int16_t* out) const {
+    std::size_t bytes;
+    const uint8_t* p = segment_data(i, col, bytes);
+    if (!p) {
+        return false;
+    }
+    const uint8_t codec = metas_[i].col[std::size_t(col)].codec;
+    if (codec == kCodecForPacked) {
+        return decode_for_packed(p, bytes, metas_[i].sample_count, out);
+    }
+    if (codec != kCodecDeltaVarint) {
+        return false;
+    }
+    const uint8_t* end = p + bytes;
+    int32_t prev = 0;
+    for (std::size_t k = 0; k < metas_[i].sample_count; ++k) {
+        uint32_t zz;
+        const std::size_t n = get_varint32(p, std::size_t(end - p), zz);
+        if (n == 0) {
+            return false;
+        }
+        p += n;
+        prev += unzigzag32(zz);
+        out[k] = int16_t(prev);
+    }
+    return p == end;
+}
+
+bool ArchiveReader::read_dt(std::size_t i, uint16_t* out) const {
+    std::size_t bytes;
+    const uint8_t* p = segment_data(i, ColumnId::kDt, bytes);
+    if (!p || metas_[i].col[std::size_t(ColumnId::kDt)].codec != kCodecVarint) {
+        return false;
+    }
+    const uint8_t* end = p + bytes;
+    for (std::size_t k = 0; k < metas_[i].sample_count; ++k) {
+        uint32_t v;
+        const std::size_t n = get_varint32(p, std::size_t(end - p), v);
+        if (n == 0) {
+            return false;
+        }
+        p += n;
+        out[k] = uint16_t(v);
+    }
+    return p == end;
+}
+
+}  // namespace collar::storage
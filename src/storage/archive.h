@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/sample_batch.h"
+
+namespace collar::storage {
+
+// Host-side columnar archive for historical sensor data.
+//
+// File layout:
+//
+//     [column segments ...][footer: SegmentMeta x N][ArchiveTrailer]
+//
+// Every ingested window becomes one row group: eight independently
+// compressed column segments plus a SegmentMeta row in the footer. Readers
+// mmap the file read-only, jump to the trailer, and walk the footer index —
+// a one-column scan touches only that column's bytes and the OS page cache
+// is the caching layer, shared across every concurrent reader.
+//
+// Appending re-opens an existing file, truncates the old footer and
+// continues after the last data byte; readers opened before an append keep
+// their consistent mapping.
+//
+// The writer keeps a sidecar journal at <path>.meta: one SegmentMeta per
+// row group, appended and fsynced by sync() after the data itself is
+// durable. The footer at close() supersedes it (close unlinks the
+// journal), but if the writer dies between sync() and close() — the
+// group-commit daemon acking collars that then erase their flash — open()
+// rebuilds the index from the journal and drops the torn tail, so every
+// synced row group survives a crash without a clean close.
+
+enum class ColumnId : uint8_t {
+    kAx = 0, kAy, kAz, kGx, kGy, kGz, kTemp, kDt,
+};
+inline constexpr std::size_t kArchiveColumns = 8;
+
+// Hard ceiling on samples per row group, enforced on both ends: the writer
+// refuses to produce a bigger segment and the reader refuses a footer
+// claiming one. Scan paths size per-segment scratch from sample_count, so
+// an unchecked value out of a corrupt (or hostile) footer would be an
+// arbitrary allocation or overflow. 1M samples is 16x the compactor's
+// default merge target.
+inline constexpr uint32_t kArchiveMaxSegmentSamples = 1u << 20;
+
+// Per-column codecs. Cold-tier recompression rewrites segments with the
+// heavier bit-packed codec; readers dispatch on this byte per segment.
+enum : uint8_t {
+    kCodecRaw = 0,          // int16 little-endian, uncompressed
+    kCodecDeltaVarint = 1,  // zigzag(delta) varint, signed columns
+    kCodecVarint = 2,       // plain varint, unsigned columns (dt)
+    kCodecForPacked = 3,    // zigzag(delta) bit-packed per 128-value block
+};
+
+struct SegmentColumn {
+    uint64_t offset;   // absolute file offset
+    uint32_t bytes;    // encoded length
+    uint8_t codec;
+    uint8_t pad[3];
+};
+
+struct SegmentMeta {
+    uint64_t collar_id;
+    uint64_t base_tick;
+    uint32_t sample_count;
+    uint32_t pad;
+    SegmentColumn col[kArchiveColumns];
+};
+static_assert(sizeof(SegmentMeta) == 24 + kArchiveColumns * 16,
+              "footer layout is on-disk ABI");
+
+struct ArchiveTrailer {
+    static constexpr uint32_t kMagic = 0x43524137;  // "7ARC"
+    static constexpr uint32_t kVersion = 1;
+
+    uint64_t footer_offset;
+    uint32_t segment_count;
+    uint32_t version;
+    uint32_t magic;
+    uint32_t pad;
+};
+
+// Column encoders, shared between the writer's append path and the
+// compactor's merge path. Each returns the encoded byte count; out must
+// hold column_codec_bound(n) bytes.
+std::size_t encode_column_signed(const int16_t* col, std::size_t n,
+                                 uint8_t* out);
+std::size_t encode_column_dt(const uint16_t* col, std::size_t n,
+                             uint8_t* out);
+std::size_t encode_column_for_packed(const int16_t* col, std::size_t n,
+                                     uint8_t* out);
+inline constexpr std::size_t column_codec_bound(std::size_t n) {
+    // Varint: 3 bytes/value worst case. FOR: 17-bit deltas plus one
+    // bit-width byte per 128-value block — under the same bound.
+    return 8 + n * 3;
+}
+
+// One pre-encoded column, handed to ArchiveWriter::append_encoded by the
+// compactor. The writer assigns file offsets; the caller owns the bytes.
+struct EncodedColumn {
+    const uint8_t* data;
+    uint32_t bytes;
+    uint8_t codec;
+};
+
+class ArchiveWriter {
+public:
+    ArchiveWriter() = default;
+    ~ArchiveWriter();
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    // Creates the file, or re-opens an existing archive for append.
+    bool open(const std::string& path);
+
+    // Append one window as a row group. Data is buffered by the OS; the
+    // footer is not durable until close().
+    bool append(uint64_t collar_id, const SampleBatch& batch);
+
+    // Append one row group whose columns are already encoded (compaction:
+    // merged segments arrive re-encoded off the worker threads).
+    bool append_encoded(uint64_t collar_id, uint64_t base_tick,
+                        uint32_t sample_count,
+                        const EncodedColumn cols[kArchiveColumns]);
+
+    // Make every appended segment durable and recoverable: fdatasync the
+    // data, then journal the new row groups' metas to the <path>.meta
+    // sidecar and fdatasync that too — in that order, so a journaled meta
+    // is always backed by real bytes. This is the group-commit writer's
+    // ack barrier; after it returns, the row groups survive a crash
+    // without close().
+    bool sync();
+
+    // Write footer + trailer, unlink the journal and close. The file is
+    // not a valid archive for readers until this succeeds (a crashed file
+    // needs one writer open()/close() pass to regain its footer).
+    bool close();
+
+    std::size_t segment_count() const { return metas_.size(); }
+
+private:
+    bool reseed_journal();
+    bool recover_from_journal(uint64_t data_size);
+
+    int fd_ = -1;
+    int jfd_ = -1;  // sidecar segment-meta journal
+    uint64_t write_off_ = 0;
+    std::size_t journaled_ = 0;  // prefix of metas_ already in the journal
+    std::string journal_path_;
+    std::vector<SegmentMeta> metas_;
+};
+
+class ArchiveReader {
+public:
+    ArchiveReader() = default;
+    ~ArchiveReader();
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+    bool open(const std::string& path);
+
+    std::size_t segment_count() const { return seg_count_; }
+    const SegmentMeta& meta(std::size_t i) const { return metas_[i]; }
+
+    // Decode one signed column of one row group; out must hold
+    // meta(i).sample_count values. Touches only that segment's pages.
+    bool read_column(std::size_t i, ColumnId col, int16_t* out) const;
+
+    // The dt column is unsigned and has its own accessor.
+    bool read_dt(std::size_t i, uint16_t* out) const;
+
+    // Raw mapped bytes of one segment, for scan paths that decode with the
+    // vectorized kernels instead of this scalar fallback.
+    const uint8_t* segment_data(std::size_t i, ColumnId col,
+                                std::size_t& bytes) const;
+
+private:
+    const uint8_t* map_ = nullptr;
+    std::size_t map_len_ = 0;
+    const SegmentMeta* metas_ = nullptr;
+    std::size_t seg_count_ = 0;
+};
+
+}  // namespace collar::storage
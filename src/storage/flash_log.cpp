@@ -0,0 +1,237 @@
+#include "storage/flash_log.h"
+
+#include <cstring>
+
+namespace collar::storage {
+
+namespace {
+
+bool header_valid(const uint8_t* page, FrameHeader& hdr) {
+    std::memcpy(&hdr, page, sizeof(hdr));
+    return hdr.magic == FrameHeader::kMagic &&
+           hdr.version == FrameHeader::kVersion &&
+           hdr.payload_bytes <= kFramePayloadMax;
+}
+
+// One metadata commit as it sits at the start of a journal page; the rest
+// of the page stays 0xff. commit_seq orders records across the two journal
+// sectors, CRC rejects the torn record of a mid-program brown-out.
+struct JournalRecord {
+    static constexpr uint32_t kMagic = 0x374a4c43;  // "CLJ7"
+
+    uint32_t magic;
+    uint32_t commit_seq;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t frames;
+    uint32_t next_seq;
+    uint32_t reserved;
+    uint32_t crc;  // crc32c of the preceding 28 bytes
+};
+static_assert(sizeof(JournalRecord) == 32, "journal record layout is ABI");
+
+bool record_valid(const uint8_t* page, JournalRecord& rec) {
+    std::memcpy(&rec, page, sizeof(rec));
+    return rec.magic == JournalRecord::kMagic &&
+           rec.crc == crc32c(page, sizeof(JournalRecord) - sizeof(uint32_t));
+}
+
+}  // namespace
+
+bool FlashLog::mount() {
+    uint8_t page[kFlashPageSize];
+
+    // Newest valid journal record wins; commit_seq wraps like frame seq.
+    bool have = false;
+    JournalRecord best{};
+    for (std::size_t p = 0; p < data_base(); ++p) {
+        JournalRecord rec;
+        if (!dev_.read_page(p, page) || !record_valid(page, rec)) {
+            continue;
+        }
+        if (!have || int32_t(rec.commit_seq - best.commit_seq) > 0) {
+            best = rec;
+            have = true;
+        }
+    }
+    if (have && best.head < data_pages() && best.tail < data_pages() &&
+        best.frames <= data_pages()) {
+        head_ = best.head;
+        tail_ = best.tail;
+        frames_ = best.frames;
+        next_seq_ = best.next_seq;
+        commit_seq_ = best.commit_seq + 1;
+        roll_forward();
+        return frames_since_commit_ == 0 || sync_metadata();
+    }
+
+    // No journal yet (first mount, or pre-journal flash): one-time full
+    // scan of the data region, exactly the old recovery path. Valid pages
+    // carry monotonically increasing seq, so the head is the page after
+    // the highest seq.
+    const std::size_t pages = data_pages();
+    bool found = false;
+    uint32_t best_seq = 0;
+    std::size_t best_page = 0;
+    std::size_t valid = 0;
+    for (std::size_t p = 0; p < pages; ++p) {
+        FrameHeader hdr;
+        if (!dev_.read_page(data_base() + p, page) ||
+            !header_valid(page, hdr)) {
+            continue;
+        }
+        ++valid;
+        if (!found || int32_t(hdr.seq - best_seq) > 0) {
+            best_seq = hdr.seq;
+            best_page = p;
+            found = true;
+        }
+    }
+    if (!found) {
+        head_ = tail_ = 0;
+        frames_ = 0;
+        next_seq_ = 0;
+    } else {
+        head_ = (best_page + 1) % pages;
+        frames_ = valid;
+        tail_ = (head_ + pages - valid) % pages;
+        next_seq_ = best_seq + 1;
+    }
+    // Seed the journal so every later mount takes the fast path.
+    return sync_metadata();
+}
+
+void FlashLog::roll_forward() {
+    // Frames appended after the last commit sit at the journaled head with
+    // consecutive seq. Replay append_page's bookkeeping — including the
+    // erase-ahead tail retirement — until the chain breaks.
+    uint8_t page[kFlashPageSize];
+    const std::size_t pages = data_pages();
+    const std::size_t per_sector = dev_.pages_per_sector();
+    std::size_t scanned = 0;
+    while (scanned < pages) {
+        FrameHeader hdr;
+        if (!dev_.read_page(data_base() + head_, page) ||
+            !header_valid(page, hdr) || hdr.seq != next_seq_) {
+            break;
+        }
+        if (head_ % per_sector == 0) {
+            for (std::size_t q = head_; q < head_ + per_sector; ++q) {
+                if (frames_ > 0 && q % pages == tail_) {
+                    tail_ = (tail_ + 1) % pages;
+                    --frames_;
+                }
+            }
+        }
+        head_ = (head_ + 1) % pages;
+        ++frames_;
+        ++next_seq_;
+        ++frames_since_commit_;
+        ++scanned;
+    }
+
+    // A brown-out between erase-ahead and the first program leaves a blank
+    // sector holding what the journal still thinks are tail frames. Retire
+    // anything at the tail that no longer carries its expected seq.
+    while (frames_ > 0) {
+        FrameHeader hdr;
+        if (dev_.read_page(data_base() + tail_, page) &&
+            header_valid(page, hdr) &&
+            hdr.seq == next_seq_ - uint32_t(frames_)) {
+            break;
+        }
+        tail_ = (tail_ + 1) % pages;
+        --frames_;
+        frames_since_commit_ = 1;  // force a commit of the repaired state
+    }
+}
+
+bool FlashLog::sync_metadata() {
+    const std::size_t slot = commit_seq_ % data_base();
+    // Entering the other journal sector: erase it while the newest record
+    // stays intact in this one.
+    if (slot % dev_.pages_per_sector() == 0 && !dev_.erase_sector(slot)) {
+        return false;
+    }
+    uint8_t page[kFlashPageSize];
+    std::memset(page, 0xff, sizeof(page));
+    JournalRecord rec{JournalRecord::kMagic, commit_seq_, uint32_t(head_),
+                      uint32_t(tail_),       uint32_t(frames_), next_seq_,
+                      0,                     0};
+    rec.crc = crc32c(reinterpret_cast<const uint8_t*>(&rec),
+                     sizeof(rec) - sizeof(uint32_t));
+    std::memcpy(page, &rec, sizeof(rec));
+    if (!dev_.program_page(slot, page)) {
+        return false;
+    }
+    ++commit_seq_;
+    frames_since_commit_ = 0;
+    ++commits_;
+    return true;
+}
+
+bool FlashLog::append(const SampleBatch& batch) {
+    uint8_t page[kFlashPageSize];
+    std::size_t first = 0;
+    while (first < batch.count) {
+        const std::size_t n = encode_frame(batch, first, next_seq_, page);
+        if (n == 0 || !append_page(page)) {
+            return false;
+        }
+        first += n;
+    }
+    return true;
+}
+
+bool FlashLog::flush() {
+    if (!staging_.empty()) {
+        if (!append(staging_)) {
+            return false;
+        }
+        staging_.clear();
+    }
+    return frames_since_commit_ == 0 || sync_metadata();
+}
+
+bool FlashLog::append_page(const uint8_t* page) {
+    const std::size_t pages = data_pages();
+    const std::size_t per_sector = dev_.pages_per_sector();
+
+    // Erase ahead: when the head enters a sector boundary the sector must be
+    // blank, which may retire the oldest frames still living there.
+    if (head_ % per_sector == 0) {
+        if (!dev_.erase_sector(data_base() + head_)) {
+            return false;
+        }
+        for (std::size_t q = head_; q < head_ + per_sector; ++q) {
+            if (frames_ > 0 && q % pages == tail_) {
+                tail_ = (tail_ + 1) % pages;
+                --frames_;
+            }
+        }
+    }
+    if (!dev_.program_page(data_base() + head_, page)) {
+        return false;
+    }
+    head_ = (head_ + 1) % pages;
+    ++frames_;
+    ++next_seq_;
+    if (++frames_since_commit_ >= kCommitInterval) {
+        return sync_metadata();
+    }
+    return true;
+}
+
+bool FlashLog::read_frame(std::size_t idx, SampleBatch& batch) {
+    uint8_t page[kFlashPageSize];
+    return read_frame_raw(idx, page) && decode_frame(page, batch);
+}
+
+bool FlashLog::read_frame_raw(std::size_t idx, uint8_t* page) {
+    if (idx >= frames_) {
+        return false;
+    }
+    return dev_.read_page(phys_page(idx), page);
+}
+
+}  // namespace collar::storage
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/sample_batch.h"
+#include "core/sample_ring.h"
+#include "instrument/counters.h"
+#include "storage/frame.h"
+
+namespace collar::storage {
+
+// Minimal NOR-flash abstraction. Pages are kFlashPageSize bytes; erase works
+// on whole sectors of pages_per_sector pages. The device build implements
+// this over the QSPI controller; tests use an in-memory fake.
+class FlashDevice {
+public:
+    virtual ~FlashDevice() = default;
+    virtual std::size_t page_count() const = 0;
+    virtual std::size_t pages_per_sector() const = 0;
+    virtual bool read_page(std::size_t page, uint8_t* out) = 0;
+    virtual bool program_page(std::size_t page, const uint8_t* data) = 0;
+    virtual bool erase_sector(std::size_t first_page) = 0;
+};
+
+// Append-only circular sample log over raw flash. One frame per page, O(1)
+// append (program one page; erase one sector ahead of the head when it is
+// about to be reused). Oldest frames are sacrificed when the log wraps —
+// a collar that cannot sync for days keeps the newest data.
+//
+// Metadata (head/tail, frame count, next seq) is journaled in the first two
+// sectors of the device: each commit programs one fresh journal page with a
+// CRC'd record, ping-ponging between the sectors so the previous record
+// survives the erase of a brown-out mid-commit. Commits are batched once
+// per kCommitInterval frames (~2% write overhead), so mount() replays the
+// newest record and then rolls forward over at most kCommitInterval page
+// headers instead of scanning the whole device — and a battery dying
+// mid-append can no longer orphan the log.
+class FlashLog {
+public:
+    // Data frames between metadata commits. Frames appended after the last
+    // commit are recovered by the mount-time roll-forward, never lost.
+    static constexpr std::size_t kCommitInterval = 16;
+
+    explicit FlashLog(FlashDevice& dev) : dev_(dev) {}
+
+    bool mount();
+
+    // Force a metadata commit now (sync start, shutdown). append() calls
+    // this automatically every kCommitInterval frames.
+    bool sync_metadata();
+
+    // Encode and append one window. Emits as many frames as the window
+    // needs; returns false on a flash programming error.
+    bool append(const SampleBatch& batch);
+
+    // Drain a sample ring into an internal staging batch and append each
+    // window as it closes — the ISR-to-flash path with no intermediate copy
+    // beyond the staging window itself.
+    template <std::size_t N>
+    bool drain(SampleRing<ImuSample, N>& ring, uint64_t now_tick) {
+        auto& ctr = instrument::stage_counters(
+            instrument::Stage::kRingToFlash);
+        ImuSample s;
+        while (ring.try_pop(s)) {
+            ctr.add_in(1);
+            if (staging_.empty()) {
+                staging_.base_tick = now_tick;
+            }
+            staging_.append(s);
+            if (staging_.full()) {
+                const std::size_t window = staging_.count;
+                if (!append(staging_)) {
+                    // Samples stay staged for the retry; a stall, not a
+                    // drop, until the log itself wraps over them.
+                    ctr.add_stalls(1);
+                    return false;
+                }
+                ctr.add_out(window);
+                ctr.add_bytes(kFlashPageSize);
+                staging_.clear();
+            }
+        }
+        return true;
+    }
+
+    // Flush a partially-filled staging window (sync start, shutdown).
+    bool flush();
+
+    std::size_t frame_count() const { return frames_; }
+    uint32_t next_seq() const { return next_seq_; }
+    uint32_t metadata_commits() const { return commits_; }
+
+    // Read the idx-th oldest frame into batch. Used by the BLE transfer
+    // engine and by tests; idx must be < frame_count().
+    bool read_frame(std::size_t idx, SampleBatch& batch);
+
+    // Raw page of the idx-th oldest frame, for zero-copy transfer paths
+    // that ship the page as-is.
+    bool read_frame_raw(std::size_t idx, uint8_t* page);
+
+private:
+    bool append_page(const uint8_t* page);
+    void roll_forward();
+    // The journal owns the first two device sectors; head_/tail_ index the
+    // data region that follows.
+    std::size_t data_base() const { return 2 * dev_.pages_per_sector(); }
+    std::size_t data_pages() const { return dev_.page_count() - data_base(); }
+    std::size_t phys_page(std::size_t idx) const {
+        return data_base() + (tail_ + idx) % data_pages();
+    }
+
+    FlashDevice& dev_;
+    SampleBatch staging_{};
+    std::size_t head_ = 0;   // next data page to program (region-relative)
+    std::size_t tail_ = 0;   // oldest valid data page (region-relative)
+    std::size_t frames_ = 0;
+    uint32_t next_seq_ = 0;
+    uint32_t commit_seq_ = 0;         // next journal record number
+    std::size_t frames_since_commit_ = 0;
+    uint32_t commits_ = 0;
+};
+
+}  // namespace collar::storage
@@ -0,0 +1,210 @@
+#include "storage/frame.h"
+
+#include <cstring>
+
+#include "storage/varint.h"
+
+namespace collar::storage {
+
+namespace {
+
+// CRC-32C (Castagnoli), bytewise table. The table costs 1 KB of flash; the
+// hardware CRC unit replaces this on device builds once the HAL lands.
+struct Crc32cTable {
+    uint32_t t[256];
+    constexpr Crc32cTable() : t{} {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c >> 1) ^ ((c & 1) ? 0x82f63b78u : 0u);
+            }
+            t[i] = c;
+        }
+    }
+};
+constexpr Crc32cTable kCrcTable;
+
+constexpr std::size_t kColumns = 8;
+
+// Column accessors in on-flash order. dt is last and is encoded without
+// zigzag because it is already an unsigned delta stream.
+const int16_t* signed_column(const SampleBatch& b, std::size_t c) {
+    switch (c) {
+        case 0: return b.ax;
+        case 1: return b.ay;
+        case 2: return b.az;
+        case 3: return b.gx;
+        case 4: return b.gy;
+        case 5: return b.gz;
+        default: return b.temp;
+    }
+}
+
+std::size_t varint32_size(uint32_t v) {
+    std::size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+// Encoded size of sample i of one signed column, given the previous value.
+std::size_t delta_size(const int16_t* col, std::size_t first, std::size_t i) {
+    const int32_t prev = (i == first) ? 0 : col[i - 1];
+    return varint32_size(zigzag32(int32_t(col[i]) - prev));
+}
+
+}  // namespace
+
+uint32_t crc32c(const uint8_t* data, std::size_t len) {
+    uint32_t c = ~0u;
+    for (std::size_t i = 0; i < len; ++i) {
+        c = (c >> 8) ^ kCrcTable.t[(c ^ data[i]) & 0xff];
+    }
+    return ~c;
+}
+
+std::size_t encode_frame(const SampleBatch& batch, std::size_t first,
+                         uint32_t seq, uint8_t* page) {
+    if (first >= batch.count) {
+        return 0;
+    }
+
+    // Payload layout: a fixed table of per-column byte lengths, then the
+    // eight column streams back to back. The table is what lets the decoder
+    // (and the server's batch decoder) find every column start without
+    // walking varints.
+    constexpr std::size_t kLenTable = kColumns * sizeof(uint16_t);
+
+    // Pass 1: how many whole samples fit.
+    std::size_t budget = kFramePayloadMax - kLenTable;
+    std::size_t count = 0;
+    for (std::size_t i = first; i < batch.count; ++i) {
+        std::size_t bytes = varint32_size(batch.dt[i]);
+        for (std::size_t c = 0; c < kColumns - 1; ++c) {
+            bytes += delta_size(signed_column(batch, c), first, i);
+        }
+        if (bytes > budget) {
+            break;
+        }
+        budget -= bytes;
+        ++count;
+    }
+
+    // Pass 2: write the column streams.
+    uint8_t* const payload = page + sizeof(FrameHeader);
+    uint16_t col_len[kColumns];
+    uint8_t* p = payload + kLenTable;
+    for (std::size_t c = 0; c < kColumns - 1; ++c) {
+        const int16_t* col = signed_column(batch, c);
+        uint8_t* start = p;
+        int32_t prev = 0;
+        for (std::size_t i = first; i < first + count; ++i) {
+            p += put_varint32(p, zigzag32(int32_t(col[i]) - prev));
+            prev = col[i];
+        }
+        col_len[c] = uint16_t(p - start);
+    }
+    uint8_t* start = p;
+    for (std::size_t i = first; i < first + count; ++i) {
+        p += put_varint32(p, batch.dt[i]);
+    }
+    col_len[kColumns - 1] = uint16_t(p - start);
+    std::memcpy(payload, col_len, kLenTable);
+
+    const std::size_t payload_bytes = std::size_t(p - payload);
+
+    // base_tick is the absolute tick of the frame's first sample, so a
+    // continuation frame of a split window advances past the chunk the
+    // previous frame carried.
+    uint64_t base_tick = batch.base_tick;
+    for (std::size_t i = 0; i < first; ++i) {
+        base_tick += batch.dt[i];
+    }
+
+    FrameHeader hdr{};
+    hdr.magic = FrameHeader::kMagic;
+    hdr.version = FrameHeader::kVersion;
+    hdr.sample_count = uint16_t(count);
+    hdr.base_tick = base_tick;
+    hdr.seq = seq;
+    hdr.payload_bytes = uint32_t(payload_bytes);
+    hdr.payload_crc = crc32c(payload, payload_bytes);
+    std::memcpy(page, &hdr, sizeof(hdr));
+    std::memset(page + sizeof(hdr) + payload_bytes, 0,
+                kFramePayloadMax - payload_bytes);
+    return count;
+}
+
+bool decode_frame(const uint8_t* page, SampleBatch& batch) {
+    FrameHeader hdr;
+    std::memcpy(&hdr, page, sizeof(hdr));
+    if (hdr.magic != FrameHeader::kMagic ||
+        hdr.version != FrameHeader::kVersion ||
+        hdr.sample_count > SampleBatch::capacity ||
+        hdr.payload_bytes > kFramePayloadMax) {
+        return false;
+    }
+    const uint8_t* payload = page + sizeof(FrameHeader);
+    if (crc32c(payload, hdr.payload_bytes) != hdr.payload_crc) {
+        return false;
+    }
+
+    constexpr std::size_t kLenTable = kColumns * sizeof(uint16_t);
+    if (hdr.payload_bytes < kLenTable) {
+        return false;
+    }
+    uint16_t col_len[kColumns];
+    std::memcpy(col_len, payload, kLenTable);
+    // The length table is payload data, so the CRC does not vouch for it:
+    // a self-consistent frame with oversized entries would pass the CRC
+    // and then walk the decoder off the page. The columns must tile the
+    // payload exactly.
+    std::size_t cols_total = 0;
+    for (std::size_t c = 0; c < kColumns; ++c) {
+        cols_total += col_len[c];
+    }
+    if (kLenTable + cols_total != hdr.payload_bytes) {
+        return false;
+    }
+
+    batch.clear();
+    batch.base_tick = hdr.base_tick;
+    const std::size_t count = hdr.sample_count;
+
+    int16_t* cols[kColumns - 1] = {batch.ax, batch.ay, batch.az, batch.gx,
+                                   batch.gy, batch.gz, batch.temp};
+    const uint8_t* p = payload + kLenTable;
+    for (std::size_t c = 0; c < kColumns - 1; ++c) {
+        const uint8_t* end = p + col_len[c];
+        int32_t prev = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            uint32_t zz;
+            const std::size_t n = get_varint32(p, std::size_t(end - p), zz);
+            if (n == 0) {
+                return false;
+            }
+            p += n;
+            prev += unzigzag32(zz);
+            cols[c][i] = int16_t(prev);
+        }
+        if (p != end) {
+            return false;
+        }
+    }
+    const uint8_t* end = p + col_len[kColumns - 1];
+    for (std::size_t i = 0; i < count; ++i) {
+        uint32_t v;
+        const std::size_t n = get_varint32(p, std::size_t(end - p), v);
+        if (n == 0) {
+            return false;
+        }
+        p += n;
+        batch.dt[i] = uint16_t(v);
+    }
+    batch.count = count;
+    return p == end;
+}
+
+}  // namespace collar::storage
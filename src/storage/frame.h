@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/sample_batch.h"
+
+namespace collar::storage {
+
+// On-flash frame format. Every frame occupies exactly one 4 KB flash page:
+// a fixed little-endian header followed by delta+varint column payload and
+// zero padding to the page boundary. Fixed-size page framing is what lets
+// the backend mmap a dumped log and binary-search frame headers by offset
+// instead of parsing from the start, and keeps flash writes page-aligned so
+// the controller never read-modify-writes.
+inline constexpr std::size_t kFlashPageSize = 4096;
+
+struct FrameHeader {
+    static constexpr uint32_t kMagic = 0x37474c43;  // "CLG7"
+    static constexpr uint16_t kVersion = 1;
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sample_count;   // samples encoded in this frame
+    uint64_t base_tick;      // absolute tick of the frame's first sample
+    uint32_t seq;            // monotonically increasing frame number
+    uint32_t payload_bytes;  // encoded bytes following the header
+    uint32_t payload_crc;    // CRC-32C of the payload
+    uint32_t reserved;
+};
+static_assert(sizeof(FrameHeader) == 32, "header layout is on-flash ABI");
+
+inline constexpr std::size_t kFramePayloadMax =
+    kFlashPageSize - sizeof(FrameHeader);
+
+uint32_t crc32c(const uint8_t* data, std::size_t len);
+
+// Encode samples [first, batch.count) of a SampleBatch into one page-sized
+// frame. Columns are encoded independently: first value zigzag+varint, then
+// zigzag+varint deltas (dt is already a delta stream and is encoded raw).
+// Worst-case noise may not fit 256 samples in one page; the encoder packs as
+// many whole samples as fit and returns how many it consumed, so the caller
+// loops until the window is flushed. Returns 0 only when first is past the
+// end of the batch.
+std::size_t encode_frame(const SampleBatch& batch, std::size_t first,
+                         uint32_t seq, uint8_t* page);
+
+// Decode one page-sized frame into batch (which is cleared first). Returns
+// false when the magic, version, bounds or CRC do not check out.
+bool decode_frame(const uint8_t* page, SampleBatch& batch);
+
+}  // namespace collar::storage
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace collar::storage {
+
+// LEB128 varints plus zigzag, shared by the on-flash log frames and the
+// upload wire format. Encoders return the number of bytes written; decoders
+// return the number consumed, or 0 on truncated input.
+
+inline uint32_t zigzag32(int32_t v) {
+    return (uint32_t(v) << 1) ^ uint32_t(v >> 31);
+}
+
+inline int32_t unzigzag32(uint32_t v) {
+    return int32_t(v >> 1) ^ -int32_t(v & 1);
+}
+
+inline std::size_t put_varint32(uint8_t* out, uint32_t v) {
+    std::size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = uint8_t(v) | 0x80;
+        v >>= 7;
+    }
+    out[n++] = uint8_t(v);
+    return n;
+}
+
+inline std::size_t put_varint64(uint8_t* out, uint64_t v) {
+    std::size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = uint8_t(v) | 0x80;
+        v >>= 7;
+    }
+    out[n++] = uint8_t(v);
+    return n;
+}
+
+inline std::size_t get_varint32(const uint8_t* in, std::size_t avail,
+                                uint32_t& out) {
+    uint32_t v = 0;
+    for (std::size_t n = 0; n < avail && n < 5; ++n) {
+        v |= uint32_t(in[n] & 0x7f) << (7 * n);
+        if ((in[n] & 0x80) == 0) {
+            out = v;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+inline std::size_t get_varint64(const uint8_t* in, std::size_t avail,
+                                uint64_t& out) {
+    uint64_t v = 0;
+    for (std::size_t n = 0; n < avail && n < 10; ++n) {
+        v |= uint64_t(in[n] & 0x7f) << (7 * n);
+        if ((in[n] & 0x80) == 0) {
+            out = v;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+}  // namespace collar::storage
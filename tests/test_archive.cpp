@@ -0,0 +1,254 @@
+#include "storage/archive.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::storage;
+
+std::string temp_path() {
+    static int n = 0;
+    return "/tmp/collar_archive_test_" + std::to_string(getpid()) + "_" +
+           std::to_string(n++) + ".arc";
+}
+
+SampleBatch make_batch(uint64_t base_tick, int16_t temp_base) {
+    SampleBatch b;
+    b.base_tick = base_tick;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        ImuSample s{};
+        s.ax = int16_t(i % 40);
+        s.ay = int16_t(-(int(i) % 17));
+        s.az = 16384;
+        s.temp = int16_t(temp_base + int(i % 3));
+        s.dt = 10;
+        b.append(s);
+    }
+    return b;
+}
+
+void test_write_read_roundtrip() {
+    const std::string path = temp_path();
+    {
+        ArchiveWriter w;
+        CHECK(w.open(path));
+        CHECK(w.append(1001, make_batch(0, 500)));
+        CHECK(w.append(1002, make_batch(100, 600)));
+        CHECK(w.append(1001, make_batch(2560, 510)));
+        CHECK_EQ(w.segment_count(), 3u);
+        CHECK(w.close());
+    }
+
+    ArchiveReader r;
+    CHECK(r.open(path));
+    CHECK_EQ(r.segment_count(), 3u);
+    CHECK_EQ(r.meta(0).collar_id, 1001u);
+    CHECK_EQ(r.meta(1).collar_id, 1002u);
+    CHECK_EQ(r.meta(2).base_tick, 2560u);
+
+    // One-column scan: only temperature for collar 1001.
+    std::vector<int16_t> temp(SampleBatch::capacity);
+    for (std::size_t i = 0; i < r.segment_count(); ++i) {
+        if (r.meta(i).collar_id != 1001) {
+            continue;
+        }
+        CHECK(r.read_column(i, ColumnId::kTemp, temp.data()));
+    }
+    CHECK_EQ(temp[0], 510);
+    CHECK_EQ(temp[1], 511);
+
+    std::vector<int16_t> ax(SampleBatch::capacity);
+    CHECK(r.read_column(0, ColumnId::kAx, ax.data()));
+    CHECK_EQ(ax[39], 39);
+    CHECK_EQ(ax[40], 0);
+
+    std::vector<uint16_t> dt(SampleBatch::capacity);
+    CHECK(r.read_dt(0, dt.data()));
+    CHECK_EQ(dt[100], 10u);
+
+    std::remove(path.c_str());
+}
+
+void test_reopen_appends() {
+    const std::string path = temp_path();
+    {
+        ArchiveWriter w;
+        CHECK(w.open(path));
+        CHECK(w.append(7, make_batch(0, 500)));
+        CHECK(w.close());
+    }
+    {
+        ArchiveWriter w;
+        CHECK(w.open(path));
+        CHECK_EQ(w.segment_count(), 1u);  // recovered existing footer
+        CHECK(w.append(8, make_batch(999, 520)));
+        CHECK(w.close());
+    }
+    ArchiveReader r;
+    CHECK(r.open(path));
+    CHECK_EQ(r.segment_count(), 2u);
+    CHECK_EQ(r.meta(0).collar_id, 7u);
+    CHECK_EQ(r.meta(1).collar_id, 8u);
+    std::vector<int16_t> temp(SampleBatch::capacity);
+    CHECK(r.read_column(1, ColumnId::kTemp, temp.data()));
+    CHECK_EQ(temp[0], 520);
+    std::remove(path.c_str());
+}
+
+void test_compression_beats_raw() {
+    const std::string path = temp_path();
+    ArchiveWriter w;
+    CHECK(w.open(path));
+    CHECK(w.append(1, make_batch(0, 500)));
+    CHECK(w.close());
+
+    ArchiveReader r;
+    CHECK(r.open(path));
+    std::size_t total = 0;
+    for (std::size_t c = 0; c < kArchiveColumns; ++c) {
+        total += r.meta(0).col[c].bytes;
+    }
+    // Raw would be 256 samples * 16 bytes; smooth data encodes at about one
+    // byte per value, so anything near or above half raw is a codec bug.
+    CHECK(total < SampleBatch::capacity * 16 / 2 + 128);
+    std::remove(path.c_str());
+}
+
+void copy_file(const std::string& from, const std::string& to) {
+    FILE* in = fopen(from.c_str(), "rb");
+    FILE* out = fopen(to.c_str(), "wb");
+    CHECK(in != nullptr && out != nullptr);
+    char buf[4096];
+    std::size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        CHECK(fwrite(buf, 1, n, out) == n);
+    }
+    fclose(in);
+    fclose(out);
+}
+
+void test_crash_recovery_via_journal() {
+    const std::string path = temp_path();
+    const std::string crash = temp_path();
+    {
+        ArchiveWriter w;
+        CHECK(w.open(path));
+        CHECK(w.append(21, make_batch(0, 500)));
+        CHECK(w.append(22, make_batch(100, 600)));
+        CHECK(w.sync());  // the group-commit ack barrier for these two
+        // One more window appended but not yet synced, then snapshot the
+        // on-disk state exactly as a crash would leave it: two journaled
+        // row groups, a torn third, no footer.
+        CHECK(w.append(23, make_batch(200, 700)));
+        copy_file(path, crash);
+        copy_file(path + ".meta", crash + ".meta");
+        CHECK(w.close());
+    }
+
+    // A plain reader refuses the footerless crash image...
+    ArchiveReader nope;
+    CHECK(!nope.open(crash));
+
+    // ...but reopening for append recovers exactly the synced (acked) row
+    // groups and drops the torn tail.
+    {
+        ArchiveWriter w;
+        CHECK(w.open(crash));
+        CHECK_EQ(w.segment_count(), 2u);
+        CHECK(w.append(24, make_batch(300, 800)));
+        CHECK(w.close());
+    }
+    ArchiveReader r;
+    CHECK(r.open(crash));
+    CHECK_EQ(r.segment_count(), 3u);
+    CHECK_EQ(r.meta(0).collar_id, 21u);
+    CHECK_EQ(r.meta(1).collar_id, 22u);
+    CHECK_EQ(r.meta(2).collar_id, 24u);
+    std::vector<int16_t> temp(SampleBatch::capacity);
+    CHECK(r.read_column(1, ColumnId::kTemp, temp.data()));
+    CHECK_EQ(temp[0], 600);
+    CHECK(r.read_column(2, ColumnId::kTemp, temp.data()));
+    CHECK_EQ(temp[0], 800);
+
+    std::remove(path.c_str());
+    std::remove(crash.c_str());
+}
+
+void test_open_rejects_garbage() {
+    const std::string path = temp_path();
+    FILE* f = fopen(path.c_str(), "wb");
+    fputs("definitely not an archive, just vibes", f);
+    fclose(f);
+    ArchiveReader r;
+    CHECK(!r.open(path));
+    std::remove(path.c_str());
+}
+
+void test_rejects_wrapping_offsets() {
+    // Bounds checks written as additions wrap uint64 on hostile values and
+    // wave the dereference through; both the trailer and the per-column
+    // extents must refuse by subtraction.
+    const std::string path = temp_path();
+    {
+        ArchiveWriter w;
+        CHECK(w.open(path));
+        CHECK(w.append(5, make_batch(0, 500)));
+        CHECK(w.close());
+    }
+
+    FILE* f = fopen(path.c_str(), "rb+");
+    CHECK(f != nullptr);
+    fseek(f, 0, SEEK_END);
+    const long size = ftell(f);
+    ArchiveTrailer tr;
+    fseek(f, size - long(sizeof(tr)), SEEK_SET);
+    CHECK(fread(&tr, 1, sizeof(tr), f) == sizeof(tr));
+    const uint64_t good_footer = tr.footer_offset;
+
+    // footer_offset chosen so offset + footer + trailer wraps past zero.
+    tr.footer_offset = ~uint64_t(0) - sizeof(SegmentMeta);
+    fseek(f, size - long(sizeof(tr)), SEEK_SET);
+    CHECK(fwrite(&tr, 1, sizeof(tr), f) == sizeof(tr));
+    fflush(f);
+    {
+        ArchiveReader r;
+        CHECK(!r.open(path));
+    }
+
+    // Restore the trailer, then poison the first column's extent the same
+    // way: open() passes (the row is otherwise sane) but the read must
+    // refuse rather than dereference map_ + huge_offset.
+    tr.footer_offset = good_footer;
+    fseek(f, size - long(sizeof(tr)), SEEK_SET);
+    CHECK(fwrite(&tr, 1, sizeof(tr), f) == sizeof(tr));
+    const uint64_t evil_off = ~uint64_t(0) - 4;
+    fseek(f, long(good_footer) + 24, SEEK_SET);  // SegmentMeta::col[0].offset
+    CHECK(fwrite(&evil_off, 1, sizeof(evil_off), f) == sizeof(evil_off));
+    fclose(f);
+    {
+        ArchiveReader r;
+        CHECK(r.open(path));
+        std::vector<int16_t> col(SampleBatch::capacity);
+        CHECK(!r.read_column(0, ColumnId::kAx, col.data()));
+    }
+    std::remove(path.c_str());
+}
+
+}  // namespace
+
+int main() {
+    test_write_read_roundtrip();
+    test_reopen_appends();
+    test_compression_beats_raw();
+    test_crash_recovery_via_journal();
+    test_open_rejects_garbage();
+    test_rejects_wrapping_offsets();
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "core/arena.h"
+
+#include <cstdint>
+
+#include "test_util.h"
+
+namespace {
+
+void test_bump_and_alignment() {
+    collar::Arena<256> arena;
+    CHECK_EQ(arena.used(), 0u);
+
+    uint8_t* a = static_cast<uint8_t*>(arena.alloc(3, 1));
+    CHECK(a != nullptr);
+    uint64_t* b = arena.create<uint64_t>(42u);
+    CHECK(b != nullptr);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(b) % alignof(uint64_t), 0u);
+    CHECK_EQ(*b, 42u);
+}
+
+void test_exhaustion_and_reset() {
+    collar::Arena<64> arena;
+    CHECK(arena.alloc(48, 1) != nullptr);
+    CHECK(arena.alloc(32, 1) == nullptr);  // would overflow
+    CHECK(arena.alloc(16, 1) != nullptr);
+    CHECK_EQ(arena.used(), 64u);
+
+    arena.reset();
+    CHECK_EQ(arena.used(), 0u);
+    CHECK_EQ(arena.high_water(), 64u);  // survives reset
+    CHECK(arena.alloc(64, 1) != nullptr);
+}
+
+// The packet-assembly usage pattern: many small allocations per connection
+// event, reset between events, no growth over time.
+void test_per_event_reuse() {
+    static collar::Arena<1024> arena;
+    for (int event = 0; event < 1000; ++event) {
+        for (int pkt = 0; pkt < 6; ++pkt) {
+            uint8_t* p = arena.alloc_array<uint8_t>(150);
+            CHECK(p != nullptr);
+            p[0] = uint8_t(pkt);
+        }
+        CHECK(arena.alloc_array<uint8_t>(150) == nullptr);
+        arena.reset();
+    }
+    CHECK_EQ(arena.high_water(), 900u);
+}
+
+}  // namespace
+
+int main() {
+    test_bump_and_alignment();
+    test_exhaustion_and_reset();
+    test_per_event_reuse();
+    return 0;
+}
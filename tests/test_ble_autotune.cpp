@@ -0,0 +1,261 @@
+#include "ble/autotune.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "ble/transfer.h"
+#include "proto/wire_parser.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::storage;
+
+class FakeFlash : public FlashDevice {
+public:
+    static constexpr std::size_t kPages = 32;
+    FakeFlash() : mem_(kPages * kFlashPageSize, 0xff) {}
+
+    std::size_t page_count() const override { return kPages; }
+    std::size_t pages_per_sector() const override { return 4; }
+    bool read_page(std::size_t page, uint8_t* out) override {
+        std::memcpy(out, &mem_[page * kFlashPageSize], kFlashPageSize);
+        return true;
+    }
+    bool program_page(std::size_t page, const uint8_t* data) override {
+        std::memcpy(&mem_[page * kFlashPageSize], data, kFlashPageSize);
+        return true;
+    }
+    bool erase_sector(std::size_t first_page) override {
+        std::memset(&mem_[first_page * kFlashPageSize], 0xff,
+                    4 * kFlashPageSize);
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> mem_;
+};
+
+// Phone-side fake: negotiation requests hit configurable caps, and
+// run_event() models one connection event draining at most a capability-
+// dependent number of notifications — 2M PHY is what buys event capacity.
+class FakePhoneLink : public ble::BleLink, public ble::BleLinkControl {
+public:
+    // Caps this "phone" imposes.
+    uint16_t mtu_cap = 247;
+    bool allows_2m = true;
+    uint16_t interval_floor = 12;
+    std::size_t notifs_per_event_1m = 2;
+    std::size_t notifs_per_event_2m = 10;
+
+    // Some centrals raise the MTU on their own before any tuning runs;
+    // tests use this to model an untuned-but-usable link.
+    void set_payload(std::size_t p) { payload_ = p; }
+
+    std::size_t payload_size() const override { return payload_; }
+    bool notify(const uint8_t* data, std::size_t len) override {
+        if (queue_.size() >= 32) {
+            return false;
+        }
+        queue_.push_back({data, len});
+        return true;
+    }
+    std::size_t in_flight() const override { return queue_.size(); }
+
+    bool request_mtu(uint16_t mtu) override {
+        const uint16_t granted = mtu < mtu_cap ? mtu : mtu_cap;
+        payload_ = std::size_t(granted) - 3;
+        return granted == mtu;
+    }
+    bool request_phy_2m() override {
+        phy_2m_ = allows_2m;
+        return allows_2m;
+    }
+    bool request_interval(uint16_t interval) override {
+        interval_ = interval > interval_floor ? interval : interval_floor;
+        return interval_ == interval;
+    }
+    bool phy_2m_active() const override { return phy_2m_; }
+    uint16_t interval_1_25ms() const override { return interval_; }
+    uint64_t conn_events() const override { return events_; }
+    uint64_t bytes_drained() const override { return drained_; }
+
+    void run_event() {
+        ++events_;
+        std::size_t budget =
+            phy_2m_ ? notifs_per_event_2m : notifs_per_event_1m;
+        while (budget-- && !queue_.empty()) {
+            auto [data, len] = queue_.front();
+            queue_.erase(queue_.begin());
+            captured_.insert(captured_.end(), data, data + len);
+            drained_ += len;
+        }
+    }
+
+    const std::vector<uint8_t>& captured() const { return captured_; }
+
+private:
+    std::size_t payload_ = 20;  // unnegotiated 23-byte MTU
+    bool phy_2m_ = false;
+    uint16_t interval_ = 48;    // 60 ms default
+    uint64_t events_ = 0;
+    uint64_t drained_ = 0;
+    std::vector<std::pair<const uint8_t*, std::size_t>> queue_;
+    std::vector<uint8_t> captured_;
+};
+
+SampleBatch make_batch(int w) {
+    SampleBatch b;
+    b.base_tick = uint64_t(w) * 2560;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        ImuSample s{};
+        s.ax = int16_t(w + int(i % 5));
+        s.az = 16384;
+        s.dt = 10;
+        b.append(s);
+    }
+    return b;
+}
+
+void fill_log(FlashLog& log, int frames) {
+    CHECK(log.mount());
+    for (int w = 0; w < frames; ++w) {
+        CHECK(log.append(make_batch(w)));
+    }
+}
+
+// Runs a sync to completion; returns connection events consumed.
+uint64_t run_sync(ble::TransferEngine& eng, FakePhoneLink& phone) {
+    const uint64_t start_events = phone.conn_events();
+    int guard = 100000;
+    while (eng.service() || phone.in_flight() > 0) {
+        phone.run_event();
+        CHECK(--guard > 0);
+    }
+    return phone.conn_events() - start_events;
+}
+
+void check_stream(const FakePhoneLink& phone, std::size_t frames) {
+    std::size_t pages = 0;
+    proto::WireParser parser([&](const proto::WireHeader& h,
+                                 const uint8_t* p, std::size_t n) {
+        CHECK_EQ(h.kind, proto::kPages);
+        CHECK_EQ(n, kFlashPageSize);
+        SampleBatch out;
+        CHECK(decode_frame(p, out));
+        CHECK_EQ(out.base_tick, uint64_t(pages) * 2560);
+        ++pages;
+    });
+    CHECK(parser.feed(phone.captured().data(), phone.captured().size()));
+    CHECK_EQ(pages, frames);
+}
+
+void test_tuned_sync_beats_default() {
+    FakeFlash flash;
+    FlashLog log(flash);
+    fill_log(log, 6);
+
+    // Tuned: a cooperative phone grants everything.
+    FakePhoneLink fast;
+    ble::Autotuner tuner(fast, fast);
+    ble::TransferEngine eng(log, fast, 0xC0117);
+    eng.set_tuner(&tuner);
+    CHECK(eng.start(0));
+    CHECK_EQ(tuner.payload(), 244u);
+    CHECK(tuner.phy_2m());
+    CHECK_EQ(tuner.interval_1_25ms(), ble::Autotuner::kRequestInterval);
+    CHECK_EQ(eng.chunk_size(), 128u);
+    const uint64_t tuned_events = run_sync(eng, fast);
+    CHECK(eng.done());
+    check_stream(fast, 6);
+
+    // The quota ladder must have climbed off its cold-start value toward
+    // the 10-notification events the 2M link carries.
+    CHECK(tuner.quota() > 4);
+    CHECK(tuner.raises() > 0);
+    CHECK(tuner.goodput_bytes_per_event() > 0);
+
+    // Untuned baseline: same hardware, nobody negotiates — the central
+    // nudged the MTU just enough to be usable and left 1M PHY alone.
+    FakeFlash flash2;
+    FlashLog log2(flash2);
+    fill_log(log2, 6);
+    FakePhoneLink slow;
+    slow.set_payload(40);
+    ble::TransferEngine eng2(log2, slow, 0xC0117);
+    CHECK(eng2.start(0));
+    CHECK_EQ(eng2.chunk_size(), 32u);
+    const uint64_t default_events = run_sync(eng2, slow);
+
+    // The whole point: the tuned sync spends several times fewer radio
+    // events on the same data.
+    CHECK(tuned_events * 4 < default_events);
+}
+
+void test_capped_phone_falls_back() {
+    FakeFlash flash;
+    FlashLog log(flash);
+    fill_log(log, 3);
+
+    FakePhoneLink phone;
+    phone.mtu_cap = 43;
+    phone.allows_2m = false;
+    phone.interval_floor = 36;
+
+    ble::Autotuner tuner(phone, phone);
+    ble::TransferEngine eng(log, phone, 0xC0117);
+    eng.set_tuner(&tuner);
+    CHECK(eng.start(0));
+    // Every request was capped; the tuner reads back actuals and carries on.
+    CHECK_EQ(tuner.payload(), 40u);
+    CHECK(!tuner.phy_2m());
+    CHECK_EQ(tuner.interval_1_25ms(), 36u);
+    CHECK_EQ(eng.chunk_size(), 32u);
+
+    run_sync(eng, phone);
+    CHECK(eng.done());
+    check_stream(phone, 3);
+    CHECK(tuner.quota() >= ble::Autotuner::kMinQuota);
+    CHECK(tuner.quota() <= ble::Autotuner::kMaxQuota);
+
+    // A phone pinned at the 23-byte default MTU cannot carry the wire
+    // header; the engine refuses the sync instead of stalling.
+    FakePhoneLink hard_capped;
+    hard_capped.mtu_cap = 23;
+    ble::Autotuner tuner2(hard_capped, hard_capped);
+    ble::TransferEngine eng2(log, hard_capped, 0xC0117);
+    eng2.set_tuner(&tuner2);
+    CHECK(!eng2.start(0));
+}
+
+void test_quota_shrinks_to_event_capacity() {
+    FakeFlash flash;
+    FlashLog log(flash);
+    fill_log(log, 6);
+
+    // A link that carries one notification per event: holding four in
+    // flight just parks pages in stack buffers, so the ladder steps down.
+    FakePhoneLink phone;
+    phone.allows_2m = true;
+    phone.notifs_per_event_2m = 1;
+
+    ble::Autotuner tuner(phone, phone);
+    ble::TransferEngine eng(log, phone, 0xC0117);
+    eng.set_tuner(&tuner);
+    CHECK(eng.start(0));
+    run_sync(eng, phone);
+    CHECK(eng.done());
+    CHECK(tuner.shrinks() > 0);
+    CHECK_EQ(tuner.quota(), ble::Autotuner::kMinQuota + 1);
+}
+
+}  // namespace
+
+int main() {
+    test_tuned_sync_beats_default();
+    test_capped_phone_falls_back();
+    test_quota_shrinks_to_event_capacity();
+    return 0;
+}
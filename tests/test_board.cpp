@@ -0,0 +1,74 @@
+#include "core/board.h"
+
+#include "firmware/pipeline.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+
+void test_full_scale_conversion() {
+    using RevA = Board<Lsm6dsoxCfg>;
+    using RevB = Board<Lsm6dso32Cfg>;
+    static_assert(RevA::has_gyro && RevB::has_gyro);
+
+    // Full positive scale maps to (almost) the configured range.
+    CHECK_EQ(RevA::accel_mg(32767), 7999);
+    CHECK_EQ(RevB::accel_mg(32767), 31999);
+    CHECK_EQ(RevA::accel_mg(0), 0);
+    CHECK_EQ(RevA::accel_mg(-32768), -8000);
+    CHECK_EQ(RevA::gyro_mdps(16384), 1000000);
+}
+
+void test_decode_with_gyro() {
+    using RevA = Board<Lsm6dsoxCfg>;
+    static_assert(RevA::fifo_words == 7);
+    const int16_t words[7] = {1, 2, 3, 4, 5, 6, 520};
+    const ImuSample s = RevA::decode(words, 10);
+    CHECK_EQ(s.ax, 1);
+    CHECK_EQ(s.gz, 6);
+    CHECK_EQ(s.temp, 520);
+    CHECK_EQ(s.dt, 10u);
+}
+
+void test_decode_gyroless() {
+    using RevC = Board<Bma400Cfg>;
+    static_assert(!RevC::has_gyro);
+    static_assert(RevC::fifo_words == 4);
+    static_assert(RevC::axes == 3);
+    const int16_t words[4] = {7, 8, 9, 480};
+    const ImuSample s = RevC::decode(words, 10);
+    CHECK_EQ(s.az, 9);
+    CHECK_EQ(s.temp, 480);
+    CHECK_EQ(s.gx, 0);  // gyro columns stay zeroed, not garbage
+    CHECK_EQ(s.gz, 0);
+}
+
+void test_pipeline_ingest() {
+    fw::SamplePipeline<Bma400Cfg, 64> pipe;
+    int16_t burst[4 * 32];
+    for (int r = 0; r < 32; ++r) {
+        burst[r * 4 + 0] = int16_t(r);
+        burst[r * 4 + 1] = int16_t(-r);
+        burst[r * 4 + 2] = 16384;
+        burst[r * 4 + 3] = 500;
+    }
+    CHECK_EQ(pipe.ingest_fifo(burst, 32, 10), 32u);
+    CHECK_EQ(pipe.ring().size(), 32u);
+
+    ImuSample s;
+    CHECK(pipe.ring().try_pop(s));
+    CHECK_EQ(s.ax, 0);
+    CHECK(pipe.ring().try_pop(s));
+    CHECK_EQ(s.ay, -1);
+}
+
+}  // namespace
+
+int main() {
+    test_full_scale_conversion();
+    test_decode_with_gyro();
+    test_decode_gyroless();
+    test_pipeline_ingest();
+    return 0;
+}
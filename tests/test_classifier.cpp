@@ -0,0 +1,94 @@
+#include "classify/classifier.h"
+
+#include <cstring>
+
+#include "test_util.h"
+
+namespace {
+
+using collar::classify::Activity;
+using collar::classify::Classifier;
+
+collar::dsp::FeatureVector make_features(float band0, float band1,
+                                         float band2, float band3,
+                                         uint32_t zcc_ax = 10) {
+    collar::dsp::FeatureVector f{};
+    f.rms[0] = f.rms[1] = 200.0f;
+    f.rms[2] = 16000.0f;  // gravity-dominated z
+    f.zcc[0] = zcc_ax;
+    f.zcc[1] = f.zcc[2] = 10;
+    f.band_energy[0] = band0;
+    f.band_energy[1] = band1;
+    f.band_energy[2] = band2;
+    f.band_energy[3] = band3;
+    return f;
+}
+
+void test_quantize_scales_and_saturates() {
+    collar::dsp::FeatureVector f = make_features(16.0f, 32.0f, 0.0f, 0.0f);
+    f.rms[0] = 1e9f;  // must clamp, not wrap
+    f.zcc[0] = 255;
+    collar::classify::QuantFeatures q;
+    Classifier::quantize(f, q);
+    CHECK_EQ(q[0], 32767);        // clamped rms
+    CHECK_EQ(q[3], 255 << 6);     // zcc scaled up
+    CHECK_EQ(q[6], 1);            // band energy >> 4
+    CHECK_EQ(q[7], 2);
+
+    // Band energies past INT32_MAX (a few thousand LSB of amplitude) must
+    // saturate to full scale, not wrap to zero and classify as rest.
+    collar::dsp::FeatureVector hot = make_features(3e9f, 3e9f, 3e9f, 3e9f);
+    Classifier::quantize(hot, q);
+    CHECK_EQ(q[6], 32767);
+    CHECK_EQ(q[7], 32767);
+    CHECK_EQ(q[8], 32767);
+    CHECK_EQ(q[9], 32767);
+    CHECK(Classifier().classify(hot) != Activity::kRest);
+}
+
+void test_activity_classes() {
+    const Classifier c;
+
+    // Rest: no motion energy anywhere.
+    CHECK(c.classify(make_features(50, 50, 50, 50)) == Activity::kRest);
+
+    // Walk: moderate gait-band energy.
+    CHECK(c.classify(make_features(1000, 60000, 2000, 500)) ==
+          Activity::kWalk);
+
+    // Run: strong gait-band energy.
+    CHECK(c.classify(make_features(2000, 400000, 8000, 1000)) ==
+          Activity::kRun);
+
+    // Groom: mid-band energy without gait cadence, slow paw rate.
+    CHECK(c.classify(make_features(3000, 10000, 40000, 5000, 30)) ==
+          Activity::kGroom);
+
+    // Scratch: high-band energy and fast paw flicks.
+    CHECK(c.classify(make_features(1000, 10000, 20000, 50000, 220)) ==
+          Activity::kScratch);
+}
+
+void test_votes_are_unanimous_on_clear_cases() {
+    const Classifier c;
+    collar::classify::QuantFeatures q;
+    Classifier::quantize(make_features(2000, 400000, 8000, 1000), q);
+    uint8_t votes[std::size_t(Activity::kCount)];
+    CHECK(c.classify_quantized(q, votes) == Activity::kRun);
+    CHECK_EQ(votes[std::size_t(Activity::kRun)], 3u);
+}
+
+void test_names() {
+    CHECK(std::strcmp(collar::classify::activity_name(Activity::kGroom),
+                      "groom") == 0);
+}
+
+}  // namespace
+
+int main() {
+    test_quantize_scales_and_saturates();
+    test_activity_classes();
+    test_votes_are_unanimous_on_clear_cases();
+    test_names();
+    return 0;
+}
@@ -0,0 +1,321 @@
+#include "server/compact/compactor.h"
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "core/sample_batch.h"
+#include "storage/archive.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::server::compact;
+
+std::string tmp_path(const char* tag) {
+    return std::string("/tmp/collar_compact_") + tag + "_" +
+           std::to_string(getpid()) + ".arc";
+}
+
+int16_t sample_value(uint64_t collar, uint32_t window, std::size_t i) {
+    return int16_t((collar * 131 + window * 17 + i * 3) % 4001 - 2000);
+}
+
+// Interleaved per-flush sprawl: `windows` row groups per collar, appended
+// round-robin the way group commit lands them.
+void build_input(const std::string& path, std::size_t collars,
+                 uint32_t windows) {
+    storage::ArchiveWriter w;
+    CHECK(w.open(path));
+    for (uint32_t win = 0; win < windows; ++win) {
+        for (std::size_t c = 1; c <= collars; ++c) {
+            SampleBatch b;
+            b.base_tick = uint64_t(win) * 2560;
+            for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+                const int16_t v = sample_value(c, win, i);
+                b.append({v, int16_t(-v), 16384, v, 0, int16_t(v / 2),
+                          int16_t(2100 + (v & 15)), 10});
+            }
+            CHECK(w.append(c, b));
+        }
+    }
+    CHECK(w.close());
+}
+
+void check_output(const std::string& path, std::size_t collars,
+                  uint32_t windows, std::size_t target_samples,
+                  uint64_t cold_before_tick) {
+    storage::ArchiveReader r;
+    CHECK(r.open(path));
+
+    const std::size_t windows_per_seg =
+        target_samples / SampleBatch::capacity;
+    uint64_t prev_collar = 0;
+    uint64_t prev_tick = 0;
+    std::size_t seen_samples = 0;
+    for (std::size_t s = 0; s < r.segment_count(); ++s) {
+        const auto& m = r.meta(s);
+        // Sorted by (collar, time), with no small-segment stragglers
+        // except each collar's tail.
+        CHECK(m.collar_id >= prev_collar);
+        if (m.collar_id == prev_collar) {
+            CHECK(m.base_tick > prev_tick);
+        }
+        prev_collar = m.collar_id;
+        prev_tick = m.base_tick;
+        seen_samples += m.sample_count;
+
+        const uint32_t first_win = uint32_t(m.base_tick / 2560);
+        std::vector<int16_t> col(m.sample_count);
+        CHECK(r.read_column(s, storage::ColumnId::kAx, col.data()));
+        for (std::size_t i = 0; i < m.sample_count; ++i) {
+            const uint32_t win = first_win + uint32_t(i / SampleBatch::capacity);
+            CHECK_EQ(col[i], sample_value(m.collar_id, win,
+                                          i % SampleBatch::capacity));
+        }
+        std::vector<uint16_t> dt(m.sample_count);
+        CHECK(r.read_dt(s, dt.data()));
+        CHECK_EQ(dt[0], 10u);
+
+        // Tiering: wholly-cold segments carry the packed codec on signed
+        // columns, dt stays varint everywhere.
+        const uint64_t newest_tick =
+            m.base_tick + (uint64_t(m.sample_count / SampleBatch::capacity) -
+                           1) * 2560;
+        const uint8_t ax_codec =
+            m.col[std::size_t(storage::ColumnId::kAx)].codec;
+        if (cold_before_tick > 0 && newest_tick < cold_before_tick) {
+            CHECK_EQ(ax_codec, storage::kCodecForPacked);
+        } else {
+            CHECK_EQ(ax_codec, storage::kCodecDeltaVarint);
+        }
+        CHECK_EQ(m.col[std::size_t(storage::ColumnId::kDt)].codec,
+                 storage::kCodecVarint);
+    }
+    CHECK_EQ(seen_samples, collars * windows * SampleBatch::capacity);
+    const std::size_t segs_per_collar =
+        (windows + uint32_t(windows_per_seg) - 1) / windows_per_seg;
+    CHECK_EQ(r.segment_count(), collars * segs_per_collar);
+}
+
+void test_merge_sort_and_tier() {
+    const std::string in_path = tmp_path("in");
+    const std::string out_path = tmp_path("out");
+    const std::size_t kCollars = 3;
+    const uint32_t kWindows = 40;
+    build_input(in_path, kCollars, kWindows);
+
+    storage::ArchiveReader in;
+    CHECK(in.open(in_path));
+    CHECK_EQ(in.segment_count(), kCollars * kWindows);
+
+    Compactor::Options opt;
+    opt.workers = 4;
+    opt.target_samples = 8 * SampleBatch::capacity;
+    opt.cold_before_tick = 20 * 2560;  // first half of the day is cold
+    Compactor compactor(in, opt);
+    storage::ArchiveWriter out;
+    CHECK(out.open(out_path));
+    CHECK(compactor.run(out));
+    CHECK(out.close());
+
+    const auto& s = compactor.stats();
+    CHECK_EQ(s.input_segments, kCollars * kWindows);
+    CHECK_EQ(s.output_segments, uint64_t(kCollars * 5));
+    CHECK(s.cold_segments > 0);
+    CHECK(s.output_bytes < s.input_bytes);  // packed cold tier must pay off
+
+    check_output(out_path, kCollars, kWindows, opt.target_samples,
+                 opt.cold_before_tick);
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+}
+
+void test_parallel_matches_serial() {
+    const std::string in_path = tmp_path("ps_in");
+    build_input(in_path, 5, 16);
+    storage::ArchiveReader in;
+    CHECK(in.open(in_path));
+
+    Compactor::Options opt;
+    opt.target_samples = 4 * SampleBatch::capacity;
+    std::string paths[2];
+    for (int v = 0; v < 2; ++v) {
+        opt.workers = v == 0 ? 1 : 4;
+        paths[v] = tmp_path(v == 0 ? "serial" : "parallel");
+        Compactor compactor(in, opt);
+        storage::ArchiveWriter out;
+        CHECK(out.open(paths[v]));
+        CHECK(compactor.run(out));
+        CHECK(out.close());
+    }
+
+    // Identical plans must yield byte-identical archives regardless of
+    // worker count — the writer orders appends, not the scheduler.
+    std::FILE* a = std::fopen(paths[0].c_str(), "rb");
+    std::FILE* b = std::fopen(paths[1].c_str(), "rb");
+    CHECK(a != nullptr && b != nullptr);
+    int ca;
+    int cb;
+    do {
+        ca = std::fgetc(a);
+        cb = std::fgetc(b);
+        CHECK_EQ(ca, cb);
+    } while (ca != EOF);
+    std::fclose(a);
+    std::fclose(b);
+    std::remove(in_path.c_str());
+    std::remove(paths[0].c_str());
+    std::remove(paths[1].c_str());
+}
+
+void test_gap_splits_merge() {
+    // Four contiguous windows, then a long silence (collar slept through
+    // the night), then two more. Merging across the gap would keep only
+    // the first base_tick and re-timestamp everything after the junction,
+    // so the plan must split there.
+    const std::string in_path = tmp_path("gap_in");
+    const std::string out_path = tmp_path("gap_out");
+    const uint64_t kGapBase = 1000000;
+    {
+        storage::ArchiveWriter w;
+        CHECK(w.open(in_path));
+        for (uint32_t win = 0; win < 6; ++win) {
+            SampleBatch b;
+            b.base_tick = (win < 4 ? 0 : kGapBase) +
+                          uint64_t(win < 4 ? win : win - 4) * 2560;
+            for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+                const int16_t v = sample_value(1, win, i);
+                b.append({v, 0, 16384, 0, 0, 0, 2100, 10});
+            }
+            CHECK(w.append(1, b));
+        }
+        CHECK(w.close());
+    }
+
+    storage::ArchiveReader in;
+    CHECK(in.open(in_path));
+    Compactor::Options opt;
+    opt.workers = 1;
+    opt.target_samples = 8 * SampleBatch::capacity;  // would fit all six
+    Compactor compactor(in, opt);
+    storage::ArchiveWriter out;
+    CHECK(out.open(out_path));
+    CHECK(compactor.run(out));
+    CHECK(out.close());
+
+    storage::ArchiveReader r;
+    CHECK(r.open(out_path));
+    CHECK_EQ(r.segment_count(), 2u);
+    CHECK_EQ(r.meta(0).base_tick, 0u);
+    CHECK_EQ(r.meta(0).sample_count, 4 * SampleBatch::capacity);
+    CHECK_EQ(r.meta(1).base_tick, kGapBase);
+    CHECK_EQ(r.meta(1).sample_count, 2 * SampleBatch::capacity);
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+}
+
+void test_plan_respects_segment_ceiling() {
+    // Two already-large contiguous inputs whose total tops the archive's
+    // per-segment ceiling: the plan must split rather than hand
+    // append_encoded a job it will reject after the merge is done.
+    const std::string in_path = tmp_path("cap_in");
+    const std::string out_path = tmp_path("cap_out");
+    const uint32_t kBig = storage::kArchiveMaxSegmentSamples / 2 + 1024;
+    {
+        storage::ArchiveWriter w;
+        CHECK(w.open(in_path));
+        std::vector<int16_t> zeros(kBig, 0);
+        std::vector<uint16_t> dt(kBig, 10);
+        std::vector<uint8_t> bufs[storage::kArchiveColumns];
+        storage::EncodedColumn cols[storage::kArchiveColumns];
+        for (std::size_t c = 0; c < storage::kArchiveColumns; ++c) {
+            bufs[c].resize(storage::column_codec_bound(kBig));
+            if (c == storage::kArchiveColumns - 1) {
+                cols[c] = {bufs[c].data(),
+                           uint32_t(storage::encode_column_dt(
+                               dt.data(), kBig, bufs[c].data())),
+                           storage::kCodecVarint};
+            } else {
+                cols[c] = {bufs[c].data(),
+                           uint32_t(storage::encode_column_signed(
+                               zeros.data(), kBig, bufs[c].data())),
+                           storage::kCodecDeltaVarint};
+            }
+        }
+        CHECK(w.append_encoded(4, 0, kBig, cols));
+        CHECK(w.append_encoded(4, uint64_t(kBig) * 10, kBig, cols));
+        CHECK(w.close());
+    }
+
+    storage::ArchiveReader in;
+    CHECK(in.open(in_path));
+    Compactor::Options opt;
+    opt.workers = 1;
+    opt.target_samples = 4u * storage::kArchiveMaxSegmentSamples;
+    Compactor compactor(in, opt);
+    storage::ArchiveWriter out;
+    CHECK(out.open(out_path));
+    CHECK(compactor.run(out));
+    CHECK(out.close());
+
+    storage::ArchiveReader r;
+    CHECK(r.open(out_path));
+    CHECK_EQ(r.segment_count(), 2u);
+    CHECK_EQ(r.meta(0).sample_count, kBig);
+    CHECK_EQ(r.meta(1).sample_count, kBig);
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+}
+
+void test_for_packed_extremes() {
+    // Full-range swings: 17-bit zigzag deltas, the codec's worst case.
+    const std::string path = tmp_path("extreme");
+    storage::ArchiveWriter w;
+    CHECK(w.open(path));
+    SampleBatch b;
+    b.base_tick = 0;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        const int16_t v = (i & 1) ? int16_t(32767) : int16_t(-32768);
+        b.append({v, v, v, v, v, v, v, 10});
+    }
+    CHECK(w.append(7, b));
+    CHECK(w.close());
+
+    storage::ArchiveReader in;
+    CHECK(in.open(path));
+    Compactor::Options opt;
+    opt.workers = 1;
+    opt.cold_before_tick = UINT64_MAX;  // force the packed codec
+    Compactor compactor(in, opt);
+    const std::string out_path = tmp_path("extreme_out");
+    storage::ArchiveWriter out;
+    CHECK(out.open(out_path));
+    CHECK(compactor.run(out));
+    CHECK(out.close());
+
+    storage::ArchiveReader r;
+    CHECK(r.open(out_path));
+    CHECK_EQ(r.segment_count(), 1u);
+    CHECK_EQ(r.meta(0).col[0].codec, storage::kCodecForPacked);
+    std::vector<int16_t> col(SampleBatch::capacity);
+    CHECK(r.read_column(0, storage::ColumnId::kAx, col.data()));
+    for (std::size_t i = 0; i < col.size(); ++i) {
+        CHECK_EQ(col[i], (i & 1) ? int16_t(32767) : int16_t(-32768));
+    }
+    std::remove(path.c_str());
+    std::remove(out_path.c_str());
+}
+
+}  // namespace
+
+int main() {
+    test_merge_sort_and_tier();
+    test_parallel_matches_serial();
+    test_gap_splits_merge();
+    test_plan_respects_segment_ceiling();
+    test_for_packed_extremes();
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include "proto/dict.h"
+
+#include <cstring>
+#include <vector>
+
+#include "core/sample_batch.h"
+#include "proto/wire_parser.h"
+#include "server/executor.h"
+#include "server/ingest.h"
+#include "storage/frame.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+
+// Habitual signal: deltas cycle through a small fixed set, the way a
+// sleeping cat's accel trace does.
+SampleBatch habitual_batch(uint64_t base_tick) {
+    static const int16_t kDeltas[] = {0, 1, -1, 2, 0, 0, -2, 1};
+    SampleBatch b;
+    b.base_tick = base_tick;
+    int16_t ax = 100, ay = -50, az = 16384;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        const int16_t d = kDeltas[i % 8];
+        ax = int16_t(ax + d);
+        ay = int16_t(ay - d);
+        az = int16_t(az + kDeltas[(i + 3) % 8]);
+        b.append({ax, ay, az, 0, 0, 0, 2100, 10});
+    }
+    return b;
+}
+
+std::vector<int16_t> column_deltas(const int16_t* col, std::size_t n) {
+    std::vector<int16_t> d(n);
+    int16_t prev = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        d[i] = int16_t(col[i] - prev);
+        prev = col[i];
+    }
+    return d;
+}
+
+std::size_t varint_bytes(const std::vector<int16_t>& deltas) {
+    uint8_t buf[8];
+    std::size_t total = 0;
+    for (int16_t d : deltas) {
+        total += storage::put_varint32(buf, storage::zigzag32(d));
+    }
+    return total;
+}
+
+void test_roundtrip_and_ratio() {
+    server::DictTrainer trainer;
+    for (uint32_t w = 0; w < server::DictTrainer::kTrainWindows; ++w) {
+        trainer.observe(habitual_batch(w * 2560));
+    }
+    CHECK(trainer.ready());
+    const proto::DeltaDict dict = trainer.build(1);
+    CHECK_EQ(dict.version, 1u);
+
+    const SampleBatch b = habitual_batch(999);
+    const auto deltas = column_deltas(b.ax, b.count);
+    uint8_t enc[1024];
+    const std::size_t n =
+        proto::dict_encode(dict.col[0], deltas.data(), deltas.size(), enc,
+                           sizeof(enc));
+    CHECK(n > 0);
+
+    // Exact roundtrip.
+    int16_t out[SampleBatch::capacity];
+    std::size_t out_n = 0;
+    CHECK(proto::dict_decode(dict.col[0], enc, n, out,
+                             SampleBatch::capacity, out_n));
+    CHECK_EQ(out_n, deltas.size());
+    for (std::size_t i = 0; i < out_n; ++i) {
+        CHECK_EQ(out[i], deltas[i]);
+    }
+
+    // The corpus claim: ≥30% under the generic varint encoding on
+    // habitual data.
+    const std::size_t baseline = varint_bytes(deltas);
+    CHECK(n * 10 <= baseline * 7);
+
+    // Truncated input must fail cleanly, not misdecode.
+    CHECK(!proto::dict_decode(dict.col[0], enc, n / 2, out,
+                              SampleBatch::capacity, out_n));
+}
+
+void test_escape_heavy_data_still_roundtrips() {
+    // A dictionary that matches nothing: every value escapes.
+    proto::ColumnDict dict;
+    for (std::size_t k = 0; k < proto::kDictSlots; ++k) {
+        dict.values[k] = int16_t(30000 - int(k));
+    }
+    std::vector<int16_t> deltas;
+    uint32_t s = 7;
+    for (int i = 0; i < 100; ++i) {
+        s = s * 1664525u + 1013904223u;
+        deltas.push_back(int16_t(s % 4001) - 2000);
+    }
+    uint8_t enc[2048];
+    const std::size_t n = proto::dict_encode(dict, deltas.data(),
+                                             deltas.size(), enc, sizeof(enc));
+    CHECK(n > 0);
+    int16_t out[128];
+    std::size_t out_n = 0;
+    CHECK(proto::dict_decode(dict, enc, n, out, 128, out_n));
+    CHECK_EQ(out_n, deltas.size());
+    for (std::size_t i = 0; i < out_n; ++i) {
+        CHECK_EQ(out[i], deltas[i]);
+    }
+}
+
+void test_window_roundtrip() {
+    server::DictTrainer trainer;
+    for (uint32_t w = 0; w < server::DictTrainer::kTrainWindows; ++w) {
+        trainer.observe(habitual_batch(w * 2560));
+    }
+    const proto::DeltaDict dict = trainer.build(1);
+
+    const SampleBatch b = habitual_batch(424242);
+    uint8_t enc[proto::kDictWindowMax];
+    const std::size_t n = proto::dict_window_encode(dict, b, enc, sizeof(enc));
+    CHECK(n > 0);
+    // Whole-window gain: well under the flash page the same window fills.
+    CHECK(n < storage::kFlashPageSize / 2);
+
+    SampleBatch out;
+    CHECK(proto::dict_window_decode(dict, enc, n, out));
+    CHECK_EQ(out.count, b.count);
+    CHECK_EQ(out.base_tick, b.base_tick);
+    for (std::size_t i = 0; i < b.count; ++i) {
+        CHECK_EQ(out.ax[i], b.ax[i]);
+        CHECK_EQ(out.ay[i], b.ay[i]);
+        CHECK_EQ(out.az[i], b.az[i]);
+        CHECK_EQ(out.temp[i], b.temp[i]);
+        CHECK_EQ(out.dt[i], b.dt[i]);
+    }
+
+    // A receiver holding a different dictionary version must refuse the
+    // window rather than decode garbage through the wrong table.
+    proto::DeltaDict stale = dict;
+    stale.version = 2;
+    CHECK(!proto::dict_window_decode(stale, enc, n, out));
+    // Truncation anywhere fails cleanly.
+    CHECK(!proto::dict_window_decode(dict, enc, n - 1, out));
+    CHECK(!proto::dict_window_decode(dict, enc, proto::kDictWindowHeader, out));
+    // An untrained dictionary cannot encode at all.
+    proto::DeltaDict untrained{};
+    CHECK_EQ(proto::dict_window_encode(untrained, b, enc, sizeof(enc)), 0u);
+}
+
+void test_pipeline_trains_and_ships_dict() {
+    server::ShardedExecutor exec(2);
+    server::IngestPipeline pipe(exec);
+
+    uint8_t page[storage::kFlashPageSize];
+    for (uint32_t w = 0; w < server::DictTrainer::kTrainWindows; ++w) {
+        const SampleBatch b = habitual_batch(uint64_t(w) * 2560);
+        CHECK_EQ(storage::encode_frame(b, 0, w, page), b.count);
+        pipe.on_upload(31337, page, sizeof(page));
+    }
+    exec.drain();
+
+    const server::CollarSession s = pipe.session(31337);
+    CHECK_EQ(s.dict.version, 1u);
+    // The listener ships dict(), the seqlocked read; with the shard
+    // drained it must match the session's copy exactly, and an unknown
+    // collar reads back untrained.
+    const proto::DeltaDict stable = pipe.dict(31337);
+    CHECK_EQ(std::memcmp(&stable, &s.dict, sizeof(stable)), 0);
+    CHECK_EQ(pipe.dict(404).version, 0u);
+    // The habitual deltas must have made the ax table.
+    bool found_zero = false;
+    for (int16_t v : s.dict.col[0].values) {
+        found_zero = found_zero || v == 0;
+    }
+    CHECK(found_zero);
+
+    // Sync-time shipping: the kDict frame parses back to the same dict.
+    uint8_t hdr[proto::kWireHeaderSize];
+    proto::SgSpan iov[2];
+    CHECK_EQ(proto::dict_frame_sg(hdr, 31337, s.dict, iov), 2u);
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 2; ++i) {
+        stream.insert(stream.end(), iov[i].data, iov[i].data + iov[i].len);
+    }
+    proto::DeltaDict received{};
+    proto::WireParser parser([&](const proto::WireHeader& h,
+                                 const uint8_t* p, std::size_t n) {
+        CHECK_EQ(h.kind, proto::kDict);
+        CHECK_EQ(n, sizeof(proto::DeltaDict));
+        std::memcpy(&received, p, n);
+    });
+    CHECK(parser.feed(stream.data(), stream.size()));
+    CHECK_EQ(received.version, 1u);
+    CHECK_EQ(std::memcmp(&received, &s.dict, sizeof(received)), 0);
+
+    // Return leg: a kDictPages upload encoded against the shipped dict is
+    // accepted by the pipeline like any page frame.
+    const SampleBatch b = habitual_batch(777777);
+    uint8_t enc[proto::kDictWindowMax];
+    const std::size_t n =
+        proto::dict_window_encode(received, b, enc, sizeof(enc));
+    CHECK(n > 0);
+    uint8_t dp_hdr[proto::kWireHeaderSize];
+    proto::SgSpan dp_iov[2];
+    CHECK_EQ(proto::dict_pages_frame_sg(dp_hdr, 31337, enc, n, dp_iov), 2u);
+    proto::WireHeader h;
+    CHECK(proto::parse_header(dp_hdr, h));
+    CHECK_EQ(h.kind, uint16_t(proto::kDictPages));
+    pipe.on_wire_frame(h, enc, n);
+    exec.drain();
+    const server::CollarSession after = pipe.session(31337);
+    CHECK_EQ(after.frames, s.frames + 1);
+    CHECK_EQ(after.samples, s.samples + b.count);
+    CHECK_EQ(after.last_base_tick, b.base_tick);
+
+    // A window against a version the server no longer holds is a bad
+    // frame, not a silent misdecode.
+    proto::DeltaDict stale = received;
+    stale.version = 9;
+    const std::size_t sn =
+        proto::dict_window_encode(stale, b, enc, sizeof(enc));
+    CHECK(sn > 0);
+    pipe.on_wire_frame(h, enc, sn);
+    exec.drain();
+    CHECK_EQ(pipe.session(31337).bad_frames, after.bad_frames + 1);
+}
+
+}  // namespace
+
+int main() {
+    test_roundtrip_and_ratio();
+    test_escape_heavy_data_still_roundtrips();
+    test_window_roundtrip();
+    test_pipeline_trains_and_ships_dict();
+    return 0;
+}
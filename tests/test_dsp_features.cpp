@@ -0,0 +1,91 @@
+#include "dsp/features.h"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "test_util.h"
+
+namespace {
+
+// Fixed-seed LCG so the SIMD-vs-scalar comparison is reproducible.
+uint32_t lcg(uint32_t& s) {
+    s = s * 1664525u + 1013904223u;
+    return s;
+}
+
+collar::SampleBatch make_noise_batch(uint32_t seed) {
+    collar::SampleBatch b;
+    for (std::size_t i = 0; i < collar::SampleBatch::capacity; ++i) {
+        collar::ImuSample s{};
+        s.ax = int16_t(lcg(seed) >> 17) - 16384;
+        s.ay = int16_t(lcg(seed) >> 17) - 16384;
+        s.az = int16_t(lcg(seed) >> 17) - 16384;
+        s.dt = 10;
+        b.append(s);
+    }
+    return b;
+}
+
+void test_rms_and_zcc_known_values() {
+    collar::SampleBatch b;
+    // Square wave on ax: +100/-100 alternating -> rms 100, 255 crossings.
+    for (std::size_t i = 0; i < collar::SampleBatch::capacity; ++i) {
+        collar::ImuSample s{};
+        s.ax = (i & 1) ? int16_t(-100) : int16_t(100);
+        s.az = 1000;  // constant -> 0 crossings
+        b.append(s);
+    }
+    collar::dsp::FeatureVector f{};
+    collar::dsp::extract_features<collar::dsp::ScalarIsa>(b, f);
+    CHECK_NEAR(f.rms[0], 100.0f, 0.01);
+    CHECK_EQ(f.zcc[0], 255u);
+    CHECK_EQ(f.zcc[2], 0u);
+    CHECK_NEAR(f.rms[2], 1000.0f, 0.01);
+}
+
+void test_band_energy_tracks_tone_frequency() {
+    // A 3 Hz tone at 104 Hz sampling should land in band 1 (2-5 Hz).
+    collar::SampleBatch b;
+    for (std::size_t i = 0; i < collar::SampleBatch::capacity; ++i) {
+        collar::ImuSample s{};
+        const double t = double(i) / 104.0;
+        s.az = int16_t(2000.0 + 500.0 * std::sin(2.0 * 3.14159265 * 3.0 * t));
+        b.append(s);
+    }
+    collar::dsp::FeatureVector f{};
+    collar::dsp::extract_features<collar::dsp::ScalarIsa>(b, f);
+    for (std::size_t band = 0; band < collar::dsp::FeatureVector::kBands;
+         ++band) {
+        if (band != 1) {
+            CHECK(f.band_energy[1] > 10.0f * f.band_energy[band]);
+        }
+    }
+}
+
+// Whatever ISA the build selected must agree with the scalar reference.
+void test_default_isa_matches_scalar() {
+    for (uint32_t seed = 1; seed <= 8; ++seed) {
+        const collar::SampleBatch b = make_noise_batch(seed);
+        collar::dsp::FeatureVector ref{};
+        collar::dsp::FeatureVector got{};
+        collar::dsp::extract_features<collar::dsp::ScalarIsa>(b, ref);
+        collar::dsp::extract_features<>(b, got);
+        for (int a = 0; a < 3; ++a) {
+            CHECK_NEAR(got.rms[a], ref.rms[a], 1e-3);
+            CHECK_EQ(got.zcc[a], ref.zcc[a]);
+        }
+        for (std::size_t band = 0; band < collar::dsp::FeatureVector::kBands;
+             ++band) {
+            CHECK_NEAR(got.band_energy[band], ref.band_energy[band], 1e-3);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_rms_and_zcc_known_values();
+    test_band_energy_tracks_tone_frequency();
+    test_default_isa_matches_scalar();
+    return 0;
+}
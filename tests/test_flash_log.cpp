@@ -0,0 +1,315 @@
+#include "storage/flash_log.h"
+
+#include <cstring>
+#include <vector>
+
+#include "storage/frame.h"
+#include "storage/varint.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::storage;
+
+// In-memory flash fake: 64 pages, 4 pages per sector, enforces
+// program-after-erase like real NOR. Counts page reads so tests can prove
+// mount() takes the journaled fast path instead of a full scan.
+class FakeFlash : public FlashDevice {
+public:
+    static constexpr std::size_t kPages = 64;
+    static constexpr std::size_t kPerSector = 4;
+    // First two sectors are the metadata journal; the rest hold frames.
+    static constexpr std::size_t kDataPages = kPages - 2 * kPerSector;
+
+    FakeFlash() : mem_(kPages * kFlashPageSize, 0xff), programmed_(kPages) {}
+
+    std::size_t page_count() const override { return kPages; }
+    std::size_t pages_per_sector() const override { return kPerSector; }
+
+    bool read_page(std::size_t page, uint8_t* out) override {
+        ++reads_;
+        std::memcpy(out, &mem_[page * kFlashPageSize], kFlashPageSize);
+        return true;
+    }
+    bool program_page(std::size_t page, const uint8_t* data) override {
+        CHECK(!programmed_[page]);  // program without erase is a bug
+        std::memcpy(&mem_[page * kFlashPageSize], data, kFlashPageSize);
+        programmed_[page] = true;
+        ++writes_;
+        return true;
+    }
+    bool erase_sector(std::size_t first_page) override {
+        CHECK_EQ(first_page % kPerSector, 0u);
+        for (std::size_t p = first_page; p < first_page + kPerSector; ++p) {
+            std::memset(&mem_[p * kFlashPageSize], 0xff, kFlashPageSize);
+            programmed_[p] = false;
+        }
+        return true;
+    }
+
+    std::size_t reads() const { return reads_; }
+    std::size_t writes() const { return writes_; }
+
+private:
+    std::vector<uint8_t> mem_;
+    std::vector<bool> programmed_;
+    std::size_t reads_ = 0;
+    std::size_t writes_ = 0;
+};
+
+SampleBatch make_batch(uint64_t base_tick, int bias) {
+    SampleBatch b;
+    b.base_tick = base_tick;
+    uint32_t s = uint32_t(bias) * 2654435761u + 1;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        ImuSample smp{};
+        s = s * 1664525u + 1013904223u;
+        // Smooth-ish signal so deltas stay small, like real accel data.
+        smp.ax = int16_t(bias + int(s >> 28));
+        smp.ay = int16_t(-bias - int(s >> 29));
+        smp.az = int16_t(16384 + int(s >> 28));
+        smp.temp = int16_t(500 + bias);
+        smp.dt = 10;
+        b.append(smp);
+    }
+    return b;
+}
+
+void test_varint_roundtrip() {
+    uint8_t buf[8];
+    const int32_t vals[] = {0, 1, -1, 300, -300, 32767, -32768};
+    for (int32_t v : vals) {
+        const std::size_t n = put_varint32(buf, zigzag32(v));
+        uint32_t zz = 0;
+        CHECK_EQ(get_varint32(buf, n, zz), n);
+        CHECK_EQ(unzigzag32(zz), v);
+    }
+    uint32_t zz = 0;
+    CHECK_EQ(get_varint32(buf, 0, zz), 0u);  // truncated
+}
+
+void test_frame_roundtrip() {
+    const SampleBatch in = make_batch(123456, 40);
+    uint8_t page[kFlashPageSize];
+    const std::size_t consumed = encode_frame(in, 0, 7, page);
+    CHECK_EQ(consumed, in.count);  // smooth data fits in one page
+
+    SampleBatch out;
+    CHECK(decode_frame(page, out));
+    CHECK_EQ(out.count, in.count);
+    CHECK_EQ(out.base_tick, in.base_tick);
+    for (std::size_t i = 0; i < in.count; ++i) {
+        CHECK_EQ(out.ax[i], in.ax[i]);
+        CHECK_EQ(out.az[i], in.az[i]);
+        CHECK_EQ(out.temp[i], in.temp[i]);
+        CHECK_EQ(out.dt[i], in.dt[i]);
+    }
+
+    // Corruption must not decode.
+    page[sizeof(FrameHeader) + 5] ^= 0x40;
+    CHECK(!decode_frame(page, out));
+}
+
+// Full-range noise: ~3 varint bytes per delta, so a 256-sample window
+// cannot fit one page and encode_frame must split it.
+SampleBatch make_noisy_batch(uint64_t base_tick) {
+    SampleBatch b;
+    b.base_tick = base_tick;
+    uint32_t s = 0x12345678;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        ImuSample smp{};
+        s = s * 1664525u + 1013904223u;
+        smp.ax = int16_t(s);
+        smp.ay = int16_t(s >> 8);
+        smp.az = int16_t(s >> 16);
+        smp.gx = int16_t(~s);
+        smp.gy = int16_t(s >> 4);
+        smp.gz = int16_t(s >> 12);
+        smp.temp = int16_t(s >> 20);
+        smp.dt = uint16_t(10 + (s & 7));
+        b.append(smp);
+    }
+    return b;
+}
+
+void test_split_window_roundtrip() {
+    const SampleBatch in = make_noisy_batch(5000);
+    uint8_t page[kFlashPageSize];
+    std::size_t first = 0;
+    uint64_t expect_tick = in.base_tick;
+    std::size_t frames = 0;
+    while (first < in.count) {
+        const std::size_t n = encode_frame(in, first, uint32_t(frames), page);
+        CHECK(n > 0);
+        SampleBatch out;
+        CHECK(decode_frame(page, out));
+        CHECK_EQ(out.count, n);
+        // A continuation frame's base_tick is the absolute tick of its own
+        // first sample, not the window's.
+        CHECK_EQ(out.base_tick, expect_tick);
+        for (std::size_t i = 0; i < n; ++i) {
+            CHECK_EQ(out.ax[i], in.ax[first + i]);
+            CHECK_EQ(out.gz[i], in.gz[first + i]);
+            CHECK_EQ(out.dt[i], in.dt[first + i]);
+            expect_tick += in.dt[first + i];
+        }
+        first += n;
+        ++frames;
+    }
+    CHECK(frames >= 2);  // noise really did split the window
+}
+
+void test_crafted_len_table_rejected() {
+    const SampleBatch in = make_batch(0, 7);
+    uint8_t page[kFlashPageSize];
+    CHECK_EQ(encode_frame(in, 0, 0, page), in.count);
+
+    // Inflate one column length and re-CRC: the payload is self-consistent,
+    // so only the length-table tiling check stands between the decoder and
+    // a read past the page.
+    FrameHeader hdr;
+    std::memcpy(&hdr, page, sizeof(hdr));
+    uint8_t* payload = page + sizeof(FrameHeader);
+    const uint16_t huge = 0x4000;
+    std::memcpy(payload, &huge, sizeof(huge));
+    hdr.payload_crc = crc32c(payload, hdr.payload_bytes);
+    std::memcpy(page, &hdr, sizeof(hdr));
+    SampleBatch out;
+    CHECK(!decode_frame(page, out));
+
+    // Reviewer-style minimal frame: payload is just the table, every entry
+    // pointing past it.
+    std::memset(page, 0, sizeof(page));
+    FrameHeader tiny{};
+    tiny.magic = FrameHeader::kMagic;
+    tiny.version = FrameHeader::kVersion;
+    tiny.sample_count = 4;
+    tiny.payload_bytes = 16;  // the length table alone
+    payload = page + sizeof(FrameHeader);
+    for (std::size_t c = 0; c < 8; ++c) {
+        const uint16_t len = 0x2000;
+        std::memcpy(payload + 2 * c, &len, sizeof(len));
+    }
+    tiny.payload_crc = crc32c(payload, tiny.payload_bytes);
+    std::memcpy(page, &tiny, sizeof(tiny));
+    CHECK(!decode_frame(page, out));
+}
+
+void test_log_append_and_wrap() {
+    FakeFlash flash;
+    FlashLog log(flash);
+    CHECK(log.mount());
+    CHECK_EQ(log.frame_count(), 0u);
+
+    // Append far more windows than the data region holds.
+    for (int w = 0; w < 100; ++w) {
+        CHECK(log.append(make_batch(uint64_t(w) * 2560, w)));
+    }
+    CHECK(log.frame_count() <= FakeFlash::kDataPages);
+    CHECK(log.frame_count() >= FakeFlash::kDataPages - FakeFlash::kPerSector);
+
+    // Oldest surviving frame decodes and frames are in seq order.
+    SampleBatch b;
+    uint64_t prev_tick = 0;
+    for (std::size_t i = 0; i < log.frame_count(); ++i) {
+        CHECK(log.read_frame(i, b));
+        CHECK(b.base_tick >= prev_tick);
+        prev_tick = b.base_tick;
+    }
+}
+
+void test_mount_recovers_after_remount() {
+    FakeFlash flash;
+    {
+        FlashLog log(flash);
+        CHECK(log.mount());
+        for (int w = 0; w < 10; ++w) {
+            CHECK(log.append(make_batch(uint64_t(w) * 2560, w)));
+        }
+    }
+    FlashLog log2(flash);
+    CHECK(log2.mount());
+    CHECK_EQ(log2.frame_count(), 10u);
+    CHECK_EQ(log2.next_seq(), 10u);
+    SampleBatch b;
+    CHECK(log2.read_frame(9, b));
+    CHECK_EQ(b.base_tick, 9u * 2560);
+}
+
+void test_journal_fast_mount() {
+    FakeFlash flash;
+    {
+        FlashLog log(flash);
+        CHECK(log.mount());
+        // 20 frames: one batched commit at 16, four uncommitted after it.
+        for (int w = 0; w < 20; ++w) {
+            CHECK(log.append(make_batch(uint64_t(w) * 2560, w)));
+        }
+        CHECK_EQ(log.metadata_commits(), 2u);  // mount seed + frame 16
+    }
+
+    FlashLog log2(flash);
+    const std::size_t before = flash.reads();
+    CHECK(log2.mount());
+    // Fast path: journal pages + roll-forward over the uncommitted tail,
+    // nowhere near the 56-page full scan.
+    CHECK(flash.reads() - before <= 2 * FakeFlash::kPerSector +
+                                        FlashLog::kCommitInterval + 2);
+    CHECK_EQ(log2.frame_count(), 20u);
+    CHECK_EQ(log2.next_seq(), 20u);
+    SampleBatch b;
+    CHECK(log2.read_frame(19, b));
+    CHECK_EQ(b.base_tick, 19u * 2560);
+}
+
+void test_commit_write_overhead() {
+    FakeFlash flash;
+    FlashLog log(flash);
+    CHECK(log.mount());
+    const std::size_t before = flash.writes();
+    for (int w = 0; w < 64; ++w) {
+        CHECK(log.append(make_batch(uint64_t(w) * 2560, w)));
+    }
+    // 64 data pages plus one journal page per kCommitInterval frames.
+    CHECK_EQ(flash.writes() - before,
+             64 + 64 / FlashLog::kCommitInterval);
+}
+
+void test_drain_from_ring() {
+    FakeFlash flash;
+    FlashLog log(flash);
+    CHECK(log.mount());
+
+    SampleRing<ImuSample, 512> ring;
+    const SampleBatch src = make_batch(0, 3);
+    for (std::size_t i = 0; i < src.count; ++i) {
+        ImuSample s{};
+        s.ax = src.ax[i];
+        s.az = src.az[i];
+        s.dt = src.dt[i];
+        CHECK(ring.try_push(s));
+    }
+    CHECK(log.drain(ring, 999));
+    CHECK(log.flush());
+    CHECK_EQ(log.frame_count(), 1u);
+    SampleBatch out;
+    CHECK(log.read_frame(0, out));
+    CHECK_EQ(out.count, src.count);
+    CHECK_EQ(out.base_tick, 999u);
+}
+
+}  // namespace
+
+int main() {
+    test_varint_roundtrip();
+    test_frame_roundtrip();
+    test_split_window_roundtrip();
+    test_crafted_len_table_rejected();
+    test_log_append_and_wrap();
+    test_mount_recovers_after_remount();
+    test_journal_fast_mount();
+    test_commit_write_overhead();
+    test_drain_from_ring();
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "server/geo/geofence.h"
+
+#include <vector>
+
+#include "test_util.h"
+
+namespace {
+
+using namespace collar::server::geo;
+
+// Square fence centered at (lat, lon), half-size h, all in 1e7 units.
+Fence square(uint64_t id, int32_t lat, int32_t lon, int32_t h) {
+    return {id,
+            {{lat - h, lon - h},
+             {lat - h, lon + h},
+             {lat + h, lon + h},
+             {lat + h, lon - h}}};
+}
+
+void test_point_in_ring() {
+    const Fence f = square(1, 0, 0, 1000);
+    CHECK(GeofenceEngine::point_in_ring({0, 0}, f.ring));
+    CHECK(GeofenceEngine::point_in_ring({999, 999}, f.ring));
+    CHECK(!GeofenceEngine::point_in_ring({1001, 0}, f.ring));
+    CHECK(!GeofenceEngine::point_in_ring({0, -1001}, f.ring));
+}
+
+void test_rtree_matches_brute_force() {
+    // A grid of disjoint boxes plus some overlapping ones.
+    std::vector<BBox> boxes;
+    for (int r = 0; r < 30; ++r) {
+        for (int c = 0; c < 30; ++c) {
+            const int32_t lat = r * 10000;
+            const int32_t lon = c * 10000;
+            boxes.push_back({lat, lon, lat + 8000, lon + 8000});
+        }
+    }
+    boxes.push_back({0, 0, 300000, 300000});  // big overlapping box
+
+    PackedRTree tree;
+    tree.build(boxes);
+
+    uint32_t s = 123;
+    for (int q = 0; q < 2000; ++q) {
+        s = s * 1664525u + 1013904223u;
+        const GeoPoint p{int32_t(s % 320000), int32_t((s >> 8) % 320000)};
+        std::vector<uint32_t> got;
+        tree.query(p, [&](uint32_t i) { got.push_back(i); });
+        std::size_t expect = 0;
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].contains(p)) {
+                ++expect;
+                bool found = false;
+                for (uint32_t g : got) {
+                    found = found || g == i;
+                }
+                CHECK(found);
+            }
+        }
+        CHECK_EQ(got.size(), expect);
+    }
+}
+
+void test_transitions_and_alerts() {
+    GeofenceEngine eng;
+    eng.add_fence(square(100, 0, 0, 10000));
+    eng.add_fence(square(200, 0, 50000, 10000));
+    eng.build();
+
+    // Enter fence 100.
+    auto r = eng.evaluate(1, {0, 0});
+    CHECK_EQ(r.fence_id, 100u);
+    CHECK(r.changed);
+
+    // Wander inside: no change.
+    r = eng.evaluate(1, {5000, 5000});
+    CHECK_EQ(r.fence_id, 100u);
+    CHECK(!r.changed);
+
+    // Escape! Outside everything.
+    r = eng.evaluate(1, {0, 30000});
+    CHECK_EQ(r.fence_id, GeofenceEngine::kNoFence);
+    CHECK(r.changed);
+
+    // Reappear inside the neighbour fence.
+    r = eng.evaluate(1, {0, 50000});
+    CHECK_EQ(r.fence_id, 200u);
+    CHECK(r.changed);
+}
+
+void test_fast_path_dominates_stationary_cat() {
+    GeofenceEngine eng;
+    for (int i = 0; i < 500; ++i) {
+        eng.add_fence(square(uint64_t(1000 + i), i * 30000, 0, 10000));
+    }
+    eng.build();
+
+    // First fix pays the full query...
+    CHECK_EQ(eng.evaluate(7, {0, 0}).fence_id, 1000u);
+    const uint64_t full_after_first = eng.full_evaluations();
+
+    // ...then 1000 jittery fixes inside the same garden stay on the
+    // cached-bbox path.
+    uint32_t s = 9;
+    for (int i = 0; i < 1000; ++i) {
+        s = s * 1664525u + 1013904223u;
+        const GeoPoint jitter{int32_t(s % 8000) - 4000,
+                              int32_t((s >> 8) % 8000) - 4000};
+        const auto r = eng.evaluate(7, jitter);
+        CHECK_EQ(r.fence_id, 1000u);
+        CHECK(!r.changed);
+    }
+    CHECK_EQ(eng.full_evaluations(), full_after_first);
+    CHECK_EQ(eng.fast_path_hits(), 1000u);
+}
+
+}  // namespace
+
+int main() {
+    test_point_in_ring();
+    test_rtree_matches_brute_force();
+    test_transitions_and_alerts();
+    test_fast_path_dominates_stationary_cat();
+    return 0;
+}
@@ -0,0 +1,251 @@
+#include "gps/fix_pipeline.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gps/assist_store.h"
+#include "storage/flash_log.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::gps;
+
+// Two-sector assist partition, 4 pages per sector.
+struct FakeFlash : storage::FlashDevice {
+    static constexpr std::size_t kPages = 8;
+    static constexpr std::size_t kPerSector = 4;
+
+    std::vector<uint8_t> mem =
+        std::vector<uint8_t>(kPages * storage::kFlashPageSize, 0xff);
+
+    std::size_t page_count() const override { return kPages; }
+    std::size_t pages_per_sector() const override { return kPerSector; }
+    bool read_page(std::size_t page, uint8_t* out) override {
+        std::memcpy(out, &mem[page * storage::kFlashPageSize],
+                    storage::kFlashPageSize);
+        return true;
+    }
+    bool program_page(std::size_t page, const uint8_t* data) override {
+        std::memcpy(&mem[page * storage::kFlashPageSize], data,
+                    storage::kFlashPageSize);
+        return true;
+    }
+    bool erase_sector(std::size_t first_page) override {
+        std::memset(&mem[first_page * storage::kFlashPageSize], 0xff,
+                    kPerSector * storage::kFlashPageSize);
+        return true;
+    }
+};
+
+// Scripted receiver: acquisition takes hot_polls service() calls when
+// assist with ephemeris was injected, cold_polls otherwise.
+struct FakeReceiver : GpsReceiver {
+    int hot_polls = 2;
+    int cold_polls = 28;
+    int polls_left = -1;
+    bool powered = false;
+    bool got_eph_assist = false;
+    GpsFix injected{};
+    GpsFix next_fix{0, 100000000, 200000000, 1500, 12, 9, 1};
+    std::vector<uint8_t> eph_dump;
+    bool never_fix = false;
+
+    bool power_on() override {
+        powered = true;
+        got_eph_assist = false;
+        polls_left = cold_polls;
+        return true;
+    }
+    void power_off() override { powered = false; }
+    bool inject_assist(const GpsFix& last, const uint8_t* eph,
+                       std::size_t eph_len) override {
+        injected = last;
+        if (eph_len > 0) {
+            got_eph_assist = true;
+            polls_left = hot_polls;
+        }
+        (void)eph;
+        return true;
+    }
+    bool poll_fix(GpsFix& out) override {
+        if (never_fix || polls_left-- > 0) {
+            return false;
+        }
+        out = next_fix;
+        return true;
+    }
+    std::size_t read_ephemeris(uint8_t* out, std::size_t cap) override {
+        const std::size_t n = eph_dump.size() < cap ? eph_dump.size() : cap;
+        std::memcpy(out, eph_dump.data(), n);
+        return n;
+    }
+};
+
+struct Capture {
+    GpsFix fix{};
+    int calls = 0;
+    static void on_fix(void* ctx, const GpsFix& fix) {
+        auto* self = static_cast<Capture*>(ctx);
+        self->fix = fix;
+        ++self->calls;
+    }
+};
+
+void test_assist_store_roundtrip() {
+    FakeFlash flash;
+    AssistStore store(flash);
+    AssistStore::Assist a;
+    CHECK(!store.load(a));  // blank part
+
+    GpsFix fix{1000, 1, 2, 3, 15, 7, 1};
+    std::vector<uint8_t> eph(2200);
+    for (std::size_t i = 0; i < eph.size(); ++i) {
+        eph[i] = uint8_t(i * 31);
+    }
+    CHECK(store.save(fix, eph.data(), eph.size()));
+    fix.lat_e7 = 42;
+    fix.time_ms = 2000;
+    CHECK(store.save(fix, eph.data(), eph.size()));
+
+    // A fresh mount sees the newest generation.
+    AssistStore store2(flash);
+    CHECK(store2.load(a));
+    CHECK_EQ(a.fix.lat_e7, 42);
+    CHECK_EQ(a.fix.time_ms, 2000u);
+    CHECK_EQ(a.eph_len, eph.size());
+    CHECK(std::memcmp(a.ephemeris, eph.data(), eph.size()) == 0);
+
+    // Saves keep journaling forward across the sector boundary and wrap.
+    for (int i = 0; i < 10; ++i) {
+        fix.time_ms = 3000 + uint64_t(i);
+        CHECK(store2.save(fix, eph.data(), eph.size()));
+    }
+    AssistStore store3(flash);
+    CHECK(store3.load(a));
+    CHECK_EQ(a.fix.time_ms, 3009u);
+
+    // A corrupted newest record falls back to the previous generation.
+    const std::size_t newest_slot = 11 % FakeFlash::kPages;
+    flash.mem[newest_slot * storage::kFlashPageSize + 70] ^= 0xff;
+    AssistStore store4(flash);
+    CHECK(store4.load(a));
+    CHECK_EQ(a.fix.time_ms, 3008u);
+}
+
+void test_cold_then_hot_start() {
+    FakeFlash flash;
+    AssistStore store(flash);
+    FakeReceiver rx;
+    rx.eph_dump.assign(1800, 0x5a);
+
+    // First fix ever: nothing journaled, full cold start.
+    FixPipeline pipe(rx, store);
+    Capture cap;
+    CHECK(pipe.request_fix(Capture::on_fix, &cap));
+    CHECK(!pipe.request_fix(Capture::on_fix, &cap));  // one in flight
+    uint64_t now = 10000;
+    pipe.service(now);  // kStart
+    while (pipe.busy()) {
+        now += 1000;
+        pipe.service(now);
+    }
+    CHECK_EQ(cap.calls, 1);
+    CHECK(cap.fix.valid != 0);
+    CHECK_EQ(pipe.cold_starts(), 1u);
+    CHECK_EQ(pipe.hot_starts(), 0u);
+    CHECK(pipe.last_ttf_ms() >= 28000u);
+    CHECK(!rx.powered);  // gated again after the fix
+    CHECK_EQ(store.saves(), 1u);
+
+    // Second request an hour later, fresh pipeline (reboot-free power
+    // gate): journaled ephemeris makes it a ~2 s hot start.
+    FixPipeline pipe2(rx, store);
+    Capture cap2;
+    CHECK(pipe2.request_fix(Capture::on_fix, &cap2));
+    now += 3600 * 1000;
+    pipe2.service(now);
+    const uint64_t hot_begin = now;
+    while (pipe2.busy()) {
+        now += 1000;
+        pipe2.service(now);
+    }
+    CHECK_EQ(cap2.calls, 1);
+    CHECK(cap2.fix.valid != 0);
+    CHECK(rx.got_eph_assist);
+    CHECK_EQ(rx.injected.lat_e7, 100000000);
+    CHECK_EQ(pipe2.hot_starts(), 1u);
+    CHECK_EQ(pipe2.cold_starts(), 0u);
+    CHECK(now - hot_begin <= 4000u);
+}
+
+void test_stale_ephemeris_is_position_only() {
+    FakeFlash flash;
+    AssistStore store(flash);
+    GpsFix old_fix{1000, 5, 6, 7, 10, 8, 1};
+    uint8_t eph[100] = {};
+    CHECK(store.save(old_fix, eph, sizeof(eph)));
+
+    FakeReceiver rx;
+    FixPipeline pipe(rx, store);
+    Capture cap;
+    CHECK(pipe.request_fix(Capture::on_fix, &cap));
+    // 6 hours later: position still fresh, ephemeris past its 4 h life.
+    uint64_t now = 1000 + 6ull * 3600 * 1000;
+    pipe.service(now);
+    CHECK(!rx.got_eph_assist);
+    CHECK_EQ(rx.injected.lat_e7, 5);  // position assist still handed over
+    CHECK_EQ(pipe.cold_starts(), 1u);
+    while (pipe.busy()) {
+        now += 1000;
+        pipe.service(now);
+    }
+    CHECK_EQ(cap.calls, 1);
+}
+
+void test_hot_timeout_falls_back_then_hard_timeout() {
+    FakeFlash flash;
+    AssistStore store(flash);
+    GpsFix last{1000, 5, 6, 7, 10, 8, 1};
+    uint8_t eph[64] = {};
+    CHECK(store.save(last, eph, sizeof(eph)));
+
+    FakeReceiver rx;
+    rx.never_fix = true;
+    FixPipeline pipe(rx, store);
+    Capture cap;
+    CHECK(pipe.request_fix(Capture::on_fix, &cap));
+    uint64_t now = 2000;
+    pipe.service(now);
+    CHECK_EQ(pipe.hot_starts(), 1u);
+
+    // Blow the hot deadline: the pipeline keeps the receiver powered and
+    // re-arms with a cold budget instead of reporting failure.
+    now += FixPipeline::kHotDeadlineMs + 1;
+    pipe.service(now);
+    CHECK(pipe.busy());
+    CHECK(rx.powered);
+    CHECK_EQ(pipe.cold_starts(), 1u);
+    CHECK_EQ(cap.calls, 0);
+
+    // Blow the cold deadline too: exactly one invalid-fix callback.
+    now += FixPipeline::kColdDeadlineMs + 1;
+    pipe.service(now);
+    CHECK(!pipe.busy());
+    CHECK(!rx.powered);
+    CHECK_EQ(cap.calls, 1);
+    CHECK_EQ(cap.fix.valid, 0u);
+    CHECK_EQ(pipe.timeouts(), 1u);
+    CHECK_EQ(pipe.fixes(), 0u);
+}
+
+}  // namespace
+
+int main() {
+    test_assist_store_roundtrip();
+    test_cold_then_hot_start();
+    test_stale_ephemeris_is_position_only();
+    test_hot_timeout_falls_back_then_hard_timeout();
+    return 0;
+}
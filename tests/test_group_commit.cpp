@@ -0,0 +1,134 @@
+#include "server/group_commit.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "core/sample_batch.h"
+#include "server/executor.h"
+#include "server/ingest.h"
+#include "storage/archive.h"
+#include "storage/frame.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::server;
+
+std::shared_ptr<SampleBatch> make_batch(uint64_t base_tick) {
+    auto b = std::make_shared<SampleBatch>();
+    b->base_tick = base_tick;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        b->append({int16_t(i), 0, 16384, 0, 0, 0, 2100, 10});
+    }
+    return b;
+}
+
+std::string tmp_path(const char* tag) {
+    return std::string("/tmp/collar_gc_") + tag + "_" +
+           std::to_string(getpid()) + ".arc";
+}
+
+void test_coalesces_fsyncs() {
+    const std::string path = tmp_path("coalesce");
+    storage::ArchiveWriter archive;
+    CHECK(archive.open(path));
+    {
+        GroupCommitWriter::Options opt;
+        opt.max_pending_bytes = 1 << 20;
+        opt.max_latency = std::chrono::milliseconds(50);
+        GroupCommitWriter gc(archive, opt);
+
+        // Many submitters racing in: far fewer commits than windows.
+        std::atomic<uint64_t> acked{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 32; ++i) {
+                    gc.submit(uint64_t(t + 1),
+                              make_batch(uint64_t(i) * 2560),
+                              [&] { ++acked; });
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        gc.flush_now();
+        CHECK_EQ(acked.load(), 128u);
+        CHECK_EQ(gc.windows_committed(), 128u);
+        CHECK(gc.commits() < 64);  // the whole point
+    }
+    CHECK(archive.close());
+
+    storage::ArchiveReader r;
+    CHECK(r.open(path));
+    CHECK_EQ(r.segment_count(), 128u);
+    std::remove(path.c_str());
+}
+
+void test_latency_flush_on_trickle() {
+    const std::string path = tmp_path("trickle");
+    storage::ArchiveWriter archive;
+    CHECK(archive.open(path));
+    {
+        GroupCommitWriter::Options opt;
+        opt.max_pending_bytes = 64 << 20;  // size threshold unreachable
+        opt.max_latency = std::chrono::milliseconds(5);
+        GroupCommitWriter gc(archive, opt);
+
+        std::atomic<bool> acked{false};
+        gc.submit(7, make_batch(0), [&] { acked = true; });
+        // The latency budget, not the size threshold, must flush this.
+        for (int i = 0; i < 200 && !acked; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(acked.load());
+        CHECK_EQ(gc.commits(), 1u);
+    }
+    CHECK(archive.close());
+    std::remove(path.c_str());
+}
+
+void test_pipeline_acks_after_durable() {
+    const std::string path = tmp_path("pipeline");
+    storage::ArchiveWriter archive;
+    CHECK(archive.open(path));
+    {
+        GroupCommitWriter gc(archive);
+        ShardedExecutor exec(2);
+        IngestPipeline pipe(exec);
+        pipe.set_group_writer(&gc);
+
+        uint8_t page[storage::kFlashPageSize];
+        for (uint32_t w = 0; w < 6; ++w) {
+            const auto b = make_batch(uint64_t(w) * 2560);
+            CHECK_EQ(storage::encode_frame(*b, 0, w, page), b->count);
+            pipe.on_upload(42, page, sizeof(page));
+        }
+        exec.drain();
+        gc.flush_now();
+        CHECK_EQ(pipe.total_frames(), 6u);
+        CHECK_EQ(pipe.total_durable(), 6u);
+    }
+    CHECK(archive.close());
+
+    storage::ArchiveReader r;
+    CHECK(r.open(path));
+    CHECK_EQ(r.segment_count(), 6u);
+    CHECK_EQ(r.meta(0).collar_id, 42u);
+    std::remove(path.c_str());
+}
+
+}  // namespace
+
+int main() {
+    test_coalesces_fsyncs();
+    test_latency_flush_on_trickle();
+    test_pipeline_acks_after_durable();
+    return 0;
+}
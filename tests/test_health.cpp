@@ -0,0 +1,79 @@
+#include "server/health.h"
+
+#include "test_util.h"
+
+namespace {
+
+using collar::SampleBatch;
+using collar::server::HealthMonitor;
+
+// count samples, constant temperature plus a tiny alternation so the window
+// variance is nonzero, accel steps of `step` LSB between samples.
+SampleBatch make_batch(int16_t temp, int16_t step) {
+    SampleBatch b;
+    b.clear();
+    for (int i = 0; i < 256; ++i) {
+        const int16_t a = (i & 1) ? step : int16_t(0);
+        b.append({a, a, a, 0, 0, 0, int16_t(temp + (i & 1)), 20});
+    }
+    return b;
+}
+
+void test_fever() {
+    HealthMonitor m;
+    const SampleBatch normal = make_batch(2000, 200);  // active, afebrile
+    for (uint32_t i = 0; i < HealthMonitor::kTempMinSamples + 8; ++i) {
+        CHECK_EQ(m.update(normal), HealthMonitor::kNone);
+    }
+    const int32_t baseline = m.temp_mean();
+
+    // A spike must be sustained for kFeverBatches before it flags.
+    const SampleBatch hot = make_batch(2300, 200);
+    for (uint32_t i = 0; i + 1 < HealthMonitor::kFeverBatches; ++i) {
+        CHECK_EQ(m.update(hot), HealthMonitor::kNone);
+    }
+    CHECK_EQ(m.update(hot), HealthMonitor::kFever);
+    CHECK_EQ(m.update(hot), HealthMonitor::kFever);
+
+    // Feverish batches are kept out of the ring: the baseline did not creep
+    // up, and a normal batch clears the flag immediately.
+    CHECK(m.temp_mean() <= baseline + 1);
+    CHECK_EQ(m.update(normal), HealthMonitor::kNone);
+}
+
+void test_single_hot_batch_is_noise() {
+    HealthMonitor m;
+    const SampleBatch normal = make_batch(2000, 200);
+    for (uint32_t i = 0; i < HealthMonitor::kTempMinSamples; ++i) {
+        m.update(normal);
+    }
+    CHECK_EQ(m.update(make_batch(2300, 200)), HealthMonitor::kNone);
+    CHECK_EQ(m.update(normal), HealthMonitor::kNone);
+}
+
+void test_lethargy() {
+    HealthMonitor m;
+    const SampleBatch still = make_batch(2000, 0);
+    for (uint32_t i = 0; i < HealthMonitor::kLethargyBatches - 1; ++i) {
+        CHECK(!(m.update(still) & HealthMonitor::kLethargy));
+    }
+    CHECK(m.update(still) & HealthMonitor::kLethargy);
+
+    // Motion resets the stillness run; the EWMA needs a few batches to
+    // climb back over the floor, so poke it with several active batches.
+    const SampleBatch active = make_batch(2000, 400);
+    for (int i = 0; i < 8; ++i) {
+        m.update(active);
+    }
+    CHECK_EQ(m.flags() & HealthMonitor::kLethargy, 0);
+    CHECK(m.activity_ewma() >= HealthMonitor::kLethargyActivityLsb);
+}
+
+}  // namespace
+
+int main() {
+    test_fever();
+    test_single_hot_batch_is_noise();
+    test_lethargy();
+    return 0;
+}
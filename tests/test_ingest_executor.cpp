@@ -0,0 +1,138 @@
+#include "server/executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "server/ingest.h"
+#include "storage/frame.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::server;
+
+void test_pinned_tasks_run_in_order() {
+    ShardedExecutor exec(4);
+    constexpr uint64_t kCollar = 0xc0ffee;
+    std::vector<int> order;
+    for (int i = 0; i < 100; ++i) {
+        exec.submit(kCollar, [&order, i] { order.push_back(i); });
+    }
+    exec.drain();
+    CHECK_EQ(order.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        CHECK_EQ(order[std::size_t(i)], i);
+    }
+}
+
+void test_pinned_tasks_never_overlap_per_collar() {
+    ShardedExecutor exec(4);
+    std::atomic<int> in_task{0};
+    std::atomic<bool> overlapped{false};
+    for (int i = 0; i < 200; ++i) {
+        exec.submit(42, [&] {
+            if (in_task.fetch_add(1) != 0) {
+                overlapped.store(true);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+            in_task.fetch_sub(1);
+        });
+    }
+    exec.drain();
+    CHECK(!overlapped.load());
+}
+
+void test_shared_tasks_get_stolen() {
+    ShardedExecutor exec(4);
+
+    // Pin a blocker onto three of the four shards; the only way the shared
+    // work round-robined onto their queues can finish is for the free
+    // worker to steal it.
+    std::atomic<int> ran{0};
+    constexpr int kTasks = 100;
+    std::atomic<bool> release{false};
+    int blocked = 0;
+    for (uint64_t id = 0; blocked < 3; ++id) {
+        const std::size_t shard = exec.shard_of(id);
+        if (shard == 3 || exec.shard_of(id) != shard) {
+            continue;
+        }
+        static bool taken[4] = {};
+        if (taken[shard]) {
+            continue;
+        }
+        taken[shard] = true;
+        ++blocked;
+        exec.submit(id, [&] {
+            while (!release.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (int i = 0; i < kTasks; ++i) {
+        exec.submit([&ran] { ran.fetch_add(1); });
+    }
+    while (ran.load() < kTasks) {
+        std::this_thread::yield();
+    }
+    release.store(true, std::memory_order_release);
+    exec.drain();
+    CHECK_EQ(ran.load(), kTasks);
+    CHECK(exec.steal_count() > 0);
+}
+
+void test_ingest_pipeline_decodes_uploads() {
+    ShardedExecutor exec(4);
+    IngestPipeline pipeline(exec);
+
+    // Build a 3-page upload for one collar the way the firmware would.
+    SampleBatch batch;
+    batch.base_tick = 7777;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        ImuSample s{};
+        s.ax = int16_t(i % 50);
+        s.az = 16384;
+        s.dt = 10;
+        batch.append(s);
+    }
+    std::vector<uint8_t> upload(3 * storage::kFlashPageSize);
+    for (int p = 0; p < 3; ++p) {
+        batch.base_tick = 7777 + uint64_t(p);
+        CHECK_EQ(storage::encode_frame(batch, 0, uint32_t(p),
+                                       &upload[std::size_t(p) *
+                                               storage::kFlashPageSize]),
+                 batch.count);
+    }
+
+    pipeline.on_upload(31337, upload.data(), upload.size());
+    // A corrupt payload from another collar must count as bad, not crash.
+    upload[sizeof(storage::FrameHeader) + 10] ^= 0xff;
+    pipeline.on_upload(555, upload.data(), storage::kFlashPageSize);
+    exec.drain();
+
+    const CollarSession good = pipeline.session(31337);
+    CHECK_EQ(good.frames, 3u);
+    CHECK_EQ(good.samples, 3u * SampleBatch::capacity);
+    CHECK_EQ(good.last_base_tick, 7779u);
+
+    const CollarSession bad = pipeline.session(555);
+    CHECK_EQ(bad.frames, 0u);
+    CHECK_EQ(bad.bad_frames, 1u);
+
+    CHECK_EQ(pipeline.total_frames(), 3u);
+    CHECK_EQ(pipeline.session(999).frames, 0u);  // unknown collar
+}
+
+}  // namespace
+
+int main() {
+    test_pinned_tasks_run_in_order();
+    test_pinned_tasks_never_overlap_per_collar();
+    test_shared_tasks_get_stolen();
+    test_ingest_pipeline_decodes_uploads();
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include "server/listener.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "core/sample_batch.h"
+#include "proto/wire.h"
+#include "server/executor.h"
+#include "server/ingest.h"
+#include "storage/frame.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::server;
+
+int connect_loopback(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    CHECK(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) ==
+          0);
+    return fd;
+}
+
+void send_all(int fd, const uint8_t* data, std::size_t len) {
+    std::size_t sent = 0;
+    while (sent < len) {
+        const ssize_t n = ::send(fd, data + sent, len - sent, 0);
+        CHECK(n > 0);
+        sent += std::size_t(n);
+    }
+}
+
+// Blocks until one full kAck header arrives and checks it.
+void expect_ack(int fd, uint64_t collar_id) {
+    uint8_t buf[proto::kWireHeaderSize];
+    std::size_t got = 0;
+    while (got < sizeof(buf)) {
+        const ssize_t n = ::recv(fd, buf + got, sizeof(buf) - got, 0);
+        CHECK(n > 0);
+        got += std::size_t(n);
+    }
+    proto::WireHeader h;
+    CHECK(proto::parse_header(buf, h));
+    CHECK_EQ(h.kind, uint16_t(proto::kAck));
+    CHECK_EQ(h.collar_id, collar_id);
+}
+
+void make_page(uint64_t base_tick, uint32_t seq, uint8_t* page) {
+    SampleBatch b;
+    b.base_tick = base_tick;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        b.append({int16_t(i), 0, 16384, 0, 0, 0, 2100, 10});
+    }
+    CHECK_EQ(storage::encode_frame(b, 0, seq, page), b.count);
+}
+
+void test_upload_roundtrip() {
+    ota::Reactor reactor;
+    ShardedExecutor exec(2);
+    IngestPipeline pipe(exec);
+    IngestListener listener(reactor, pipe);
+    CHECK(listener.listen(0));
+    std::thread loop([&] { reactor.run(); });
+
+    const uint64_t kCollar = 0xCA7;
+    const int fd = connect_loopback(listener.port());
+
+    // Hello first, like a real collar.
+    proto::WireHeader hello{};
+    hello.magic = proto::kWireMagic;
+    hello.version = proto::kWireVersion;
+    hello.kind = proto::kHello;
+    hello.collar_id = kCollar;
+    uint8_t hdr[proto::kWireHeaderSize];
+    proto::encode_header(hello, hdr);
+    send_all(fd, hdr, sizeof(hdr));
+    expect_ack(fd, kCollar);
+
+    // Two sync bursts of two pages each, built through the sg encoder and
+    // flattened for the blocking test socket.
+    uint8_t pages[2][storage::kFlashPageSize];
+    for (uint32_t burst = 0; burst < 2; ++burst) {
+        make_page(uint64_t(burst) * 5120, burst * 2, pages[0]);
+        make_page(uint64_t(burst) * 5120 + 2560, burst * 2 + 1, pages[1]);
+        const uint8_t* ptrs[2] = {pages[0], pages[1]};
+        proto::SgSpan iov[3];
+        const std::size_t n =
+            proto::pages_frame_sg(hdr, kCollar, ptrs, 2, iov);
+        std::vector<uint8_t> flat;
+        for (std::size_t i = 0; i < n; ++i) {
+            flat.insert(flat.end(), iov[i].data, iov[i].data + iov[i].len);
+        }
+        send_all(fd, flat.data(), flat.size());
+        expect_ack(fd, kCollar);
+    }
+    ::close(fd);
+
+    exec.drain();
+    CHECK_EQ(pipe.total_frames(), 4u);
+    CHECK_EQ(pipe.session(kCollar).frames, 4u);
+    CHECK_EQ(pipe.session(kCollar).samples, 4 * SampleBatch::capacity);
+    CHECK_EQ(listener.connections_served(), 1u);
+    CHECK_EQ(listener.frames_received(), 3u);  // hello + two page frames
+
+    reactor.stop();
+    loop.join();
+}
+
+// Reads one whole frame (header + payload) off the blocking test socket.
+proto::WireHeader recv_frame(int fd, std::vector<uint8_t>& payload) {
+    uint8_t hdr[proto::kWireHeaderSize];
+    std::size_t got = 0;
+    while (got < sizeof(hdr)) {
+        const ssize_t n = ::recv(fd, hdr + got, sizeof(hdr) - got, 0);
+        CHECK(n > 0);
+        got += std::size_t(n);
+    }
+    proto::WireHeader h;
+    CHECK(proto::parse_header(hdr, h));
+    payload.resize(h.payload_bytes);
+    got = 0;
+    while (got < payload.size()) {
+        const ssize_t n =
+            ::recv(fd, payload.data() + got, payload.size() - got, 0);
+        CHECK(n > 0);
+        got += std::size_t(n);
+    }
+    return h;
+}
+
+void test_dict_sync_roundtrip() {
+    ota::Reactor reactor;
+    ShardedExecutor exec(2);
+    IngestPipeline pipe(exec);
+    IngestListener listener(reactor, pipe);
+    CHECK(listener.listen(0));
+    std::thread loop([&] { reactor.run(); });
+
+    const uint64_t kCollar = 0xD1C7;
+    uint8_t hdr[proto::kWireHeaderSize];
+    proto::WireHeader hello{};
+    hello.magic = proto::kWireMagic;
+    hello.version = proto::kWireVersion;
+    hello.kind = proto::kHello;
+    hello.collar_id = kCollar;
+
+    // First sync: no dictionary yet, so the hello draws a bare ack and the
+    // training windows go up as plain pages.
+    {
+        const int fd = connect_loopback(listener.port());
+        proto::encode_header(hello, hdr);
+        send_all(fd, hdr, sizeof(hdr));
+        expect_ack(fd, kCollar);
+        uint8_t page[storage::kFlashPageSize];
+        for (uint32_t w = 0; w < DictTrainer::kTrainWindows; ++w) {
+            make_page(uint64_t(w) * 2560, w, page);
+            const uint8_t* ptrs[1] = {page};
+            proto::SgSpan iov[2];
+            const std::size_t n =
+                proto::pages_frame_sg(hdr, kCollar, ptrs, 1, iov);
+            std::vector<uint8_t> flat;
+            for (std::size_t i = 0; i < n; ++i) {
+                flat.insert(flat.end(), iov[i].data,
+                            iov[i].data + iov[i].len);
+            }
+            send_all(fd, flat.data(), flat.size());
+            expect_ack(fd, kCollar);
+        }
+        ::close(fd);
+    }
+    exec.drain();
+    CHECK_EQ(pipe.session(kCollar).dict.version, 1u);
+
+    // Second sync: the hello ack is followed by a kDict push carrying the
+    // trained dictionary.
+    const int fd = connect_loopback(listener.port());
+    proto::encode_header(hello, hdr);
+    send_all(fd, hdr, sizeof(hdr));
+    expect_ack(fd, kCollar);
+    std::vector<uint8_t> payload;
+    const proto::WireHeader dh = recv_frame(fd, payload);
+    CHECK_EQ(dh.kind, uint16_t(proto::kDict));
+    CHECK_EQ(dh.collar_id, kCollar);
+    CHECK_EQ(payload.size(), sizeof(proto::DeltaDict));
+    proto::DeltaDict dict;
+    std::memcpy(&dict, payload.data(), sizeof(dict));
+    CHECK_EQ(dict.version, 1u);
+
+    // Upload one window dict-coded; the server acks it like a page frame
+    // and the samples land in the session.
+    SampleBatch b;
+    b.base_tick = 99999;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        b.append({int16_t(i), 0, 16384, 0, 0, 0, 2100, 10});
+    }
+    uint8_t enc[proto::kDictWindowMax];
+    const std::size_t n = proto::dict_window_encode(dict, b, enc, sizeof(enc));
+    CHECK(n > 0);
+    proto::SgSpan iov[2];
+    CHECK_EQ(proto::dict_pages_frame_sg(hdr, kCollar, enc, n, iov), 2u);
+    std::vector<uint8_t> flat;
+    for (int i = 0; i < 2; ++i) {
+        flat.insert(flat.end(), iov[i].data, iov[i].data + iov[i].len);
+    }
+    send_all(fd, flat.data(), flat.size());
+    expect_ack(fd, kCollar);
+    ::close(fd);
+
+    exec.drain();
+    const CollarSession s = pipe.session(kCollar);
+    CHECK_EQ(s.frames, DictTrainer::kTrainWindows + 1);
+    CHECK_EQ(s.samples, (DictTrainer::kTrainWindows + 1) *
+                            SampleBatch::capacity);
+    CHECK_EQ(s.last_base_tick, 99999u);
+    CHECK_EQ(s.bad_frames, 0u);
+
+    reactor.stop();
+    loop.join();
+}
+
+void test_protocol_violation_drops_connection() {
+    ota::Reactor reactor;
+    ShardedExecutor exec(1);
+    IngestPipeline pipe(exec);
+    IngestListener listener(reactor, pipe);
+    CHECK(listener.listen(0));
+    std::thread loop([&] { reactor.run(); });
+
+    const int fd = connect_loopback(listener.port());
+    uint8_t junk[64];
+    std::memset(junk, 0x5a, sizeof(junk));
+    send_all(fd, junk, sizeof(junk));
+    // The server hangs up instead of guessing at a resync point.
+    uint8_t buf[16];
+    CHECK(::recv(fd, buf, sizeof(buf), 0) == 0);
+    ::close(fd);
+
+    exec.drain();
+    CHECK_EQ(pipe.total_frames(), 0u);
+
+    reactor.stop();
+    loop.join();
+}
+
+}  // namespace
+
+int main() {
+    test_upload_roundtrip();
+    test_dict_sync_roundtrip();
+    test_protocol_violation_drops_connection();
+    return 0;
+}
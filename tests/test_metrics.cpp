@@ -0,0 +1,88 @@
+#include "server/metrics.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "instrument/counters.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::server;
+
+int connect_loopback(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    CHECK(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) ==
+          0);
+    return fd;
+}
+
+std::string scrape(uint16_t port) {
+    const int fd = connect_loopback(port);
+    const char req[] = "GET /metrics HTTP/1.0\r\n\r\n";
+    CHECK(::send(fd, req, sizeof(req) - 1, 0) == ssize_t(sizeof(req) - 1));
+    std::string resp;
+    char buf[4096];
+    for (;;) {
+        const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        CHECK(n >= 0);
+        if (n == 0) {
+            break;  // Connection: close ends the response
+        }
+        resp.append(buf, std::size_t(n));
+    }
+    ::close(fd);
+    return resp;
+}
+
+void test_scrape() {
+    instrument::reset_stage_counters();
+    instrument::stage_counters(instrument::Stage::kIngestDecode).add_in(768);
+    instrument::stage_counters(instrument::Stage::kArchiveWrite)
+        .add_stalls(1);
+
+    ota::Reactor reactor;
+    MetricsListener metrics(reactor);
+    CHECK(metrics.listen(0));
+    std::thread loop([&] { reactor.run(); });
+
+    const std::string first = scrape(metrics.port());
+    CHECK(first.rfind("HTTP/1.0 200 OK\r\n", 0) == 0);
+    CHECK(first.find("Content-Type: text/plain; version=0.0.4\r\n") !=
+          std::string::npos);
+    CHECK(first.find(
+              "collar_stage_samples_in_total{stage=\"ingest_decode\"} 768"
+              "\n") != std::string::npos);
+    CHECK(first.find(
+              "collar_stage_stalls_total{stage=\"archive_write\"} 1\n") !=
+          std::string::npos);
+
+    // Counters move between scrapes; the endpoint serves the live table.
+    instrument::stage_counters(instrument::Stage::kIngestDecode).add_in(32);
+    const std::string second = scrape(metrics.port());
+    CHECK(second.find(
+              "collar_stage_samples_in_total{stage=\"ingest_decode\"} 800"
+              "\n") != std::string::npos);
+    CHECK_EQ(metrics.scrapes(), 2u);
+
+    reactor.stop();
+    loop.join();
+}
+
+}  // namespace
+
+int main() {
+    test_scrape();
+    return 0;
+}
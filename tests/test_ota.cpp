@@ -0,0 +1,164 @@
+#include "ota/ota_client.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "server/ota/ota_server.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::server::ota;
+
+std::vector<uint8_t> make_image(std::size_t size) {
+    std::vector<uint8_t> img(size);
+    uint32_t s = 0xf1ee7;
+    for (auto& b : img) {
+        s = s * 1664525u + 1013904223u;
+        b = uint8_t(s >> 24);
+    }
+    return img;
+}
+
+struct Sink {
+    std::vector<uint8_t> image;
+    static bool write(void* ctx, uint32_t offset, const uint8_t* data,
+                      uint32_t len) {
+        auto* self = static_cast<Sink*>(ctx);
+        if (self->image.size() < offset + len) {
+            self->image.resize(offset + len);
+        }
+        std::memcpy(self->image.data() + offset, data, len);
+        return true;
+    }
+};
+
+int connect_loopback(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    CHECK(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) ==
+          0);
+    return fd;
+}
+
+// Run one client's update over a blocking socket against the coroutine
+// server, starting from resume_offset.
+void run_update(uint16_t port, uint32_t release, uint32_t resume_offset,
+                Sink& sink, ota::OtaClient& client) {
+    const int fd = connect_loopback(port);
+    client.begin(release, resume_offset, Sink::write, &sink);
+    uint8_t buf[4096];
+    while (!client.done() && !client.failed()) {
+        const std::size_t req = client.next_request(buf);
+        CHECK(req > 0);
+        CHECK(::send(fd, buf, req, 0) == ssize_t(req));
+        const uint32_t prev_offset = client.offset();
+        while (!client.done() && !client.failed() &&
+               client.offset() == prev_offset) {
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            CHECK(n > 0);
+            CHECK(client.on_bytes(buf, std::size_t(n)) || client.failed());
+        }
+    }
+    ::close(fd);
+}
+
+void test_full_and_resumed_updates() {
+    const auto image = make_image(10 * ota::kOtaChunkSize + 1234);
+
+    ChunkCache cache;
+    cache.add_release(42, image);
+    Reactor reactor;
+    OtaServer server(reactor, cache);
+    CHECK(server.listen(0));
+    std::thread loop([&] { reactor.run(); });
+
+    // Fresh full update.
+    Sink sink1;
+    ota::OtaClient c1;
+    run_update(server.port(), 42, 0, sink1, c1);
+    CHECK(c1.done());
+    CHECK_EQ(c1.image_size(), image.size());
+    CHECK(sink1.image == image);
+
+    // Resume from a mid-image offset: only the tail is transferred.
+    Sink sink2;
+    ota::OtaClient c2;
+    const uint32_t resume = 7 * ota::kOtaChunkSize;
+    run_update(server.port(), 42, resume, sink2, c2);
+    CHECK(c2.done());
+    CHECK_EQ(sink2.image.size(), image.size());
+    CHECK(std::memcmp(sink2.image.data() + resume, image.data() + resume,
+                      image.size() - resume) == 0);
+
+    // Two clients asked for overlapping chunks: the cache must have served
+    // repeats from memory.
+    CHECK(cache.hits() > 0);
+    CHECK_EQ(server.connections_served(), 2u);
+
+    reactor.stop();
+    loop.join();
+}
+
+void test_unknown_release_fails_cleanly() {
+    ChunkCache cache;
+    cache.add_release(1, make_image(ota::kOtaChunkSize));
+    Reactor reactor;
+    OtaServer server(reactor, cache);
+    CHECK(server.listen(0));
+    std::thread loop([&] { reactor.run(); });
+
+    const int fd = connect_loopback(server.port());
+    ota::OtaClient client;
+    Sink sink;
+    client.begin(99, 0, Sink::write, &sink);  // no such release
+    uint8_t buf[4096];
+    const std::size_t req = client.next_request(buf);
+    CHECK(::send(fd, buf, req, 0) == ssize_t(req));
+    const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+    CHECK(n >= ssize_t(sizeof(ota::OtaChunkHeader)));
+    CHECK(!client.on_bytes(buf, std::size_t(n)));  // len == 0 -> failed
+    CHECK(client.failed());
+    ::close(fd);
+
+    reactor.stop();
+    loop.join();
+}
+
+void test_client_rejects_corrupt_chunk() {
+    ota::OtaClient client;
+    Sink sink;
+    client.begin(5, 0, Sink::write, &sink);
+
+    ota::OtaChunkHeader hdr{};
+    hdr.magic = ota::OtaChunkHeader::kMagic;
+    hdr.release_id = 5;
+    hdr.offset = 0;
+    hdr.len = 16;
+    hdr.crc = 0xdeadbeef;  // wrong
+    hdr.image_size = 16;
+    uint8_t wire[sizeof(hdr) + 16] = {};
+    std::memcpy(wire, &hdr, sizeof(hdr));
+    CHECK(!client.on_bytes(wire, sizeof(wire)));
+    CHECK(client.failed());
+    CHECK_EQ(sink.image.size(), 0u);  // nothing reached the sink
+}
+
+}  // namespace
+
+int main() {
+    test_full_and_resumed_updates();
+    test_unknown_release_fails_cleanly();
+    test_client_rejects_corrupt_chunk();
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "server/query/query.h"
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+#include "core/sample_batch.h"
+#include "storage/archive.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::server::query;
+
+SampleBatch make_batch(uint64_t base_tick, int16_t ax_level) {
+    SampleBatch b;
+    b.base_tick = base_tick;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        b.append({int16_t(ax_level + int16_t(i % 5)), 0, 16384, 0, 0, 0,
+                  2100, 10});
+    }
+    return b;
+}
+
+void test_count_in_range() {
+    int16_t v[100];
+    for (int i = 0; i < 100; ++i) {
+        v[i] = int16_t(i - 50);
+    }
+    CHECK_EQ(count_in_range(v, 100, -10, 9), 20u);
+    CHECK_EQ(count_in_range(v, 100, -32768, 32767), 100u);  // extremes
+    CHECK_EQ(count_in_range(v, 100, 100, 200), 0u);
+    CHECK_EQ(count_in_range(v, 33, -50, -50), 1u);  // odd tail
+}
+
+void test_scan() {
+    const std::string path =
+        "/tmp/collar_query_test_" + std::to_string(getpid()) + ".arc";
+
+    // Three collars, four hours of windows each, collar 2 "active" (high
+    // ax) in the second hour only.
+    {
+        storage::ArchiveWriter w;
+        CHECK(w.open(path));
+        for (int hour = 0; hour < 4; ++hour) {
+            for (uint64_t collar = 1; collar <= 3; ++collar) {
+                const uint64_t tick = uint64_t(hour) * 3686400;
+                const int16_t level =
+                    (collar == 2 && hour == 1) ? int16_t(2000) : int16_t(10);
+                CHECK(w.append(collar, make_batch(tick + collar, level)));
+            }
+        }
+        CHECK(w.close());
+    }
+
+    storage::ArchiveReader r;
+    CHECK(r.open(path));
+    QueryEngine eng(r, 3);
+
+    // Fleet-wide, no filter: every sample of every segment.
+    ScanResult all = eng.scan({});
+    CHECK_EQ(all.segments_scanned, 12u);
+    CHECK_EQ(all.samples_matched, 12 * SampleBatch::capacity);
+
+    // Collar set + time range prune on the footer index.
+    Predicate p;
+    p.collars = {2};
+    p.tick_min = 3686400;
+    p.tick_max = 2 * 3686400 - 1;
+    ScanResult one = eng.scan(p);
+    CHECK_EQ(one.segments_scanned, 1u);
+    CHECK_EQ(one.hits.size(), 1u);
+    CHECK_EQ(one.hits[0].collar_id, 2u);
+
+    // Column filter: "activity minutes" — high-ax samples per collar.
+    Predicate act;
+    act.has_filter = true;
+    act.filter_col = storage::ColumnId::kAx;
+    act.filter_lo = 1000;
+    act.filter_hi = 32767;
+    const auto by_collar = eng.matched_by_collar(act);
+    CHECK_EQ(by_collar.size(), 1u);  // only collar 2 was ever active
+    CHECK_EQ(by_collar[0].first, 2u);
+    CHECK_EQ(by_collar[0].second, SampleBatch::capacity);
+
+    // Parallel result must equal a single-threaded scan exactly.
+    QueryEngine serial(r, 1);
+    const ScanResult sr = serial.scan(act);
+    const ScanResult pr = eng.scan(act);
+    CHECK_EQ(sr.samples_matched, pr.samples_matched);
+    CHECK_EQ(sr.hits.size(), pr.hits.size());
+    for (std::size_t i = 0; i < sr.hits.size(); ++i) {
+        CHECK_EQ(sr.hits[i].segment, pr.hits[i].segment);
+        CHECK_EQ(sr.hits[i].matched, pr.hits[i].matched);
+    }
+
+    std::remove(path.c_str());
+}
+
+void test_scan_compacted_segments() {
+    // Compaction merges row groups up to 64K samples; a filtered scan must
+    // size its scratch from the footer instead of assuming one window.
+    const std::string path =
+        "/tmp/collar_query_merged_" + std::to_string(getpid()) + ".arc";
+    const std::size_t n = 4096;
+
+    std::vector<int16_t> ax(n), zero(n, 0);
+    std::vector<uint16_t> dt(n, 10);
+    std::size_t active = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        ax[i] = (i % 7 == 0) ? int16_t(1500) : int16_t(10);
+        active += (i % 7 == 0);
+    }
+
+    {
+        storage::ArchiveWriter w;
+        CHECK(w.open(path));
+        std::vector<uint8_t> bufs[storage::kArchiveColumns];
+        storage::EncodedColumn cols[storage::kArchiveColumns];
+        for (std::size_t c = 0; c < storage::kArchiveColumns; ++c) {
+            bufs[c].resize(storage::column_codec_bound(n));
+            if (c == storage::kArchiveColumns - 1) {
+                cols[c] = {bufs[c].data(),
+                           uint32_t(storage::encode_column_dt(
+                               dt.data(), n, bufs[c].data())),
+                           storage::kCodecVarint};
+            } else {
+                const int16_t* src = (c == 0) ? ax.data() : zero.data();
+                cols[c] = {bufs[c].data(),
+                           uint32_t(storage::encode_column_signed(
+                               src, n, bufs[c].data())),
+                           storage::kCodecDeltaVarint};
+            }
+        }
+        CHECK(w.append_encoded(9, 0, uint32_t(n), cols));
+        // The writer refuses a row group past the segment ceiling.
+        CHECK(!w.append_encoded(9, 0, storage::kArchiveMaxSegmentSamples + 1,
+                                cols));
+        CHECK(w.close());
+    }
+
+    storage::ArchiveReader r;
+    CHECK(r.open(path));
+    QueryEngine eng(r, 2);
+    Predicate act;
+    act.has_filter = true;
+    act.filter_col = storage::ColumnId::kAx;
+    act.filter_lo = 1000;
+    act.filter_hi = 32767;
+    const ScanResult res = eng.scan(act);
+    CHECK_EQ(res.segments_scanned, 1u);
+    CHECK_EQ(res.samples_scanned, n);
+    CHECK_EQ(res.samples_matched, active);
+
+    std::remove(path.c_str());
+}
+
+}  // namespace
+
+int main() {
+    test_count_in_range();
+    test_scan();
+    test_scan_compacted_segments();
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "core/sample_batch.h"
+
+#include "core/sample_ring.h"
+#include "test_util.h"
+
+namespace {
+
+void test_append_scatters_columns() {
+    collar::SampleBatch batch;
+    CHECK(batch.empty());
+
+    for (int i = 0; i < 10; ++i) {
+        collar::ImuSample s{};
+        s.ax = int16_t(i);
+        s.ay = int16_t(-i);
+        s.gz = int16_t(100 + i);
+        s.temp = 512;
+        s.dt = 10;
+        CHECK(batch.append(s));
+    }
+    CHECK_EQ(batch.count, 10u);
+    CHECK_EQ(batch.ax[7], 7);
+    CHECK_EQ(batch.ay[7], -7);
+    CHECK_EQ(batch.gz[7], 107);
+    CHECK_EQ(batch.temp[0], 512);
+}
+
+void test_fills_to_window() {
+    collar::SampleBatch batch;
+    collar::ImuSample s{};
+    for (std::size_t i = 0; i < collar::kSampleWindow; ++i) {
+        CHECK(batch.append(s));
+    }
+    CHECK(batch.full());
+    CHECK(!batch.append(s));
+    batch.clear();
+    CHECK(batch.empty());
+}
+
+// The intended drain path: ring -> batch, no intermediate buffer.
+void test_drain_from_ring() {
+    collar::SampleRing<collar::ImuSample, 64> ring;
+    for (int i = 0; i < 32; ++i) {
+        collar::ImuSample s{};
+        s.az = int16_t(i);
+        CHECK(ring.try_push(s));
+    }
+
+    collar::SampleBatch batch;
+    collar::ImuSample s;
+    while (ring.try_pop(s)) {
+        CHECK(batch.append(s));
+    }
+    CHECK_EQ(batch.count, 32u);
+    CHECK_EQ(batch.az[31], 31);
+}
+
+}  // namespace
+
+int main() {
+    test_append_scatters_columns();
+    test_fills_to_window();
+    test_drain_from_ring();
+    return 0;
+}
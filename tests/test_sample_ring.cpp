@@ -0,0 +1,83 @@
+#include "core/sample_ring.h"
+
+#include <cstdint>
+#include <thread>
+
+#include "test_util.h"
+
+namespace {
+
+struct ImuSample {
+    int16_t ax, ay, az;
+    uint16_t dt;
+};
+
+void test_push_pop_wraparound() {
+    collar::SampleRing<ImuSample, 8> ring;
+    CHECK(ring.empty());
+    CHECK_EQ(ring.capacity(), 7u);
+
+    // Fill, drain, refill several times so the indices wrap.
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 7; ++i) {
+            CHECK(ring.try_push({int16_t(i), int16_t(-i), int16_t(round), 10}));
+        }
+        CHECK(!ring.try_push({0, 0, 0, 0}));  // full
+        CHECK_EQ(ring.size(), 7u);
+
+        ImuSample s;
+        for (int i = 0; i < 7; ++i) {
+            CHECK(ring.try_pop(s));
+            CHECK_EQ(s.ax, i);
+            CHECK_EQ(s.az, round);
+        }
+        CHECK(!ring.try_pop(s));  // empty
+    }
+}
+
+void test_pop_bulk() {
+    collar::SampleRing<ImuSample, 16> ring;
+    for (int i = 0; i < 10; ++i) {
+        CHECK(ring.try_push({int16_t(i), 0, 0, 0}));
+    }
+    ImuSample out[16];
+    CHECK_EQ(ring.pop_bulk(out, 4), 4u);
+    CHECK_EQ(out[3].ax, 3);
+    CHECK_EQ(ring.pop_bulk(out, 16), 6u);
+    CHECK_EQ(out[5].ax, 9);
+    CHECK(ring.empty());
+}
+
+// Producer thread standing in for the ISR: every sample pushed must come out
+// the other side in order.
+void test_spsc_threads() {
+    static collar::SampleRing<uint32_t, 1024> ring;
+    constexpr uint32_t kCount = 200000;
+
+    std::thread producer([] {
+        for (uint32_t i = 0; i < kCount;) {
+            if (ring.try_push(i)) {
+                ++i;
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    while (expected < kCount) {
+        uint32_t v;
+        if (ring.try_pop(v)) {
+            CHECK_EQ(v, expected);
+            ++expected;
+        }
+    }
+    producer.join();
+}
+
+}  // namespace
+
+int main() {
+    test_push_pop_wraparound();
+    test_pop_bulk();
+    test_spsc_threads();
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "core/sampling_controller.h"
+
+#include "classify/classifier.h"
+#include "test_util.h"
+
+namespace {
+
+using collar::SamplingController;
+using Rate = SamplingController::Rate;
+using collar::classify::Activity;
+
+// The firmware main loop's gluing, verbatim: rest is the only label that
+// demotes, every other classifier output counts as motion.
+bool resting(Activity a) { return a == Activity::kRest; }
+
+void test_boots_at_full_rate() {
+    SamplingController c;
+    CHECK_EQ(uint8_t(c.rate()), uint8_t(Rate::kFull104Hz));
+    CHECK_EQ(c.dt_ticks(), 10u);
+}
+
+void test_demotes_stepwise_after_hysteresis() {
+    SamplingController c;
+    // Seven rest windows: still 104 Hz, no sensor writes.
+    for (uint32_t i = 0; i + 1 < SamplingController::kRestWindowsToDemote;
+         ++i) {
+        const auto d = c.on_window(resting(Activity::kRest));
+        CHECK(!d.changed);
+        CHECK_EQ(uint8_t(d.rate), uint8_t(Rate::kFull104Hz));
+    }
+    // Then one notch per rest window down the ladder.
+    CHECK_EQ(uint8_t(c.on_window(true).rate), uint8_t(Rate::kMid52Hz));
+    CHECK_EQ(uint8_t(c.on_window(true).rate), uint8_t(Rate::kLow26Hz));
+    CHECK_EQ(uint8_t(c.on_window(true).rate), uint8_t(Rate::kRest12Hz5));
+    CHECK_EQ(c.dt_ticks(), 82u);
+    // Floor: further rest windows change nothing.
+    CHECK(!c.on_window(true).changed);
+    CHECK_EQ(c.reconfigs(), 3u);
+}
+
+void test_motion_promotes_within_one_window() {
+    SamplingController c;
+    for (int i = 0; i < 20; ++i) {
+        c.on_window(true);
+    }
+    CHECK_EQ(uint8_t(c.rate()), uint8_t(Rate::kRest12Hz5));
+    const auto d = c.on_window(resting(Activity::kWalk));
+    CHECK(d.changed);
+    CHECK_EQ(uint8_t(d.rate), uint8_t(Rate::kFull104Hz));
+}
+
+void test_blip_resets_hysteresis() {
+    SamplingController c;
+    for (uint32_t i = 0; i < SamplingController::kRestWindowsToDemote - 1;
+         ++i) {
+        c.on_window(true);
+    }
+    c.on_window(resting(Activity::kGroom));  // twitch mid-nap
+    // The rest run starts over; another full hysteresis is needed.
+    for (uint32_t i = 0; i + 1 < SamplingController::kRestWindowsToDemote;
+         ++i) {
+        CHECK(!c.on_window(true).changed);
+    }
+    CHECK_EQ(uint8_t(c.on_window(true).rate), uint8_t(Rate::kMid52Hz));
+}
+
+void test_no_thrash_on_alternating_labels() {
+    SamplingController c;
+    for (int i = 0; i < 100; ++i) {
+        c.on_window(i % 2 == 0);
+    }
+    // Never left 104 Hz: alternating labels cause zero sensor writes.
+    CHECK_EQ(c.reconfigs(), 0u);
+    CHECK_EQ(uint8_t(c.rate()), uint8_t(Rate::kFull104Hz));
+}
+
+}  // namespace
+
+int main() {
+    test_boots_at_full_rate();
+    test_demotes_stepwise_after_hysteresis();
+    test_motion_promotes_within_one_window();
+    test_blip_resets_hysteresis();
+    test_no_thrash_on_alternating_labels();
+    return 0;
+}
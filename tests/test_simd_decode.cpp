@@ -0,0 +1,126 @@
+#include "server/simd_decode.h"
+
+#include <cstring>
+
+#include "storage/frame.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::storage;
+
+uint32_t lcg(uint32_t& s) {
+    s = s * 1664525u + 1013904223u;
+    return s;
+}
+
+// shift controls delta magnitude: large shift -> tiny deltas (all one-byte
+// varints, pure vector path), small shift -> frequent multi-byte varints.
+SampleBatch make_batch(uint32_t seed, int shift) {
+    SampleBatch b;
+    b.base_tick = 42;
+    int16_t ax = 0, ay = 0, az = 16384;
+    for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+        ImuSample s{};
+        ax = int16_t(ax + int(lcg(seed) >> shift) - int(1u << (31 - shift)));
+        ay = int16_t(ay + int(lcg(seed) >> shift) - int(1u << (31 - shift)));
+        s.ax = ax;
+        s.ay = ay;
+        s.az = az;
+        s.gx = int16_t(lcg(seed) >> shift);
+        s.temp = 500;
+        s.dt = uint16_t(9 + (lcg(seed) & 3));
+        b.append(s);
+    }
+    return b;
+}
+
+void check_equivalent(const SampleBatch& in) {
+    uint8_t page[kFlashPageSize];
+    std::size_t first = 0;
+    while (first < in.count) {
+        const std::size_t n = encode_frame(in, first, 1, page);
+        CHECK(n > 0);
+        SampleBatch ref, fast;
+        CHECK(decode_frame(page, ref));
+        CHECK(collar::server::decode_frame_simd(page, fast));
+        CHECK_EQ(fast.count, ref.count);
+        CHECK_EQ(fast.base_tick, ref.base_tick);
+        for (std::size_t i = 0; i < ref.count; ++i) {
+            CHECK_EQ(fast.ax[i], ref.ax[i]);
+            CHECK_EQ(fast.ay[i], ref.ay[i]);
+            CHECK_EQ(fast.az[i], ref.az[i]);
+            CHECK_EQ(fast.gx[i], ref.gx[i]);
+            CHECK_EQ(fast.temp[i], ref.temp[i]);
+            CHECK_EQ(fast.dt[i], ref.dt[i]);
+        }
+        first += n;
+    }
+}
+
+void test_matches_scalar_on_smooth_data() {
+    for (uint32_t seed = 1; seed <= 4; ++seed) {
+        check_equivalent(make_batch(seed, 28));  // ~all single-byte deltas
+    }
+}
+
+void test_matches_scalar_on_noisy_data() {
+    for (uint32_t seed = 1; seed <= 4; ++seed) {
+        check_equivalent(make_batch(seed, 22));  // multi-byte stretches
+    }
+}
+
+void test_rejects_corruption() {
+    uint8_t page[kFlashPageSize];
+    const SampleBatch b = make_batch(9, 28);
+    CHECK(encode_frame(b, 0, 1, page) > 0);
+    page[sizeof(FrameHeader) + 40] ^= 0x81;
+    SampleBatch out;
+    CHECK(!collar::server::decode_frame_simd(page, out));
+}
+
+void test_rejects_crafted_len_table() {
+    // A self-consistent frame whose length table points past the page: the
+    // CRC covers the crafted table, so only the tiling check rejects it.
+    // This path terminates network uploads, so it must never read past the
+    // 4 KB buffer.
+    uint8_t page[kFlashPageSize];
+    const SampleBatch b = make_batch(11, 28);
+    CHECK(encode_frame(b, 0, 1, page) > 0);
+
+    FrameHeader hdr;
+    std::memcpy(&hdr, page, sizeof(hdr));
+    uint8_t* payload = page + sizeof(FrameHeader);
+    const uint16_t huge = 0x8000;
+    std::memcpy(payload + 2, &huge, sizeof(huge));  // inflate column 1
+    hdr.payload_crc = crc32c(payload, hdr.payload_bytes);
+    std::memcpy(page, &hdr, sizeof(hdr));
+    SampleBatch out;
+    CHECK(!collar::server::decode_frame_simd(page, out));
+
+    // Degenerate frame: payload is nothing but the table.
+    std::memset(page, 0, sizeof(page));
+    FrameHeader tiny{};
+    tiny.magic = FrameHeader::kMagic;
+    tiny.version = FrameHeader::kVersion;
+    tiny.sample_count = 32;
+    tiny.payload_bytes = 16;
+    for (std::size_t c = 0; c < 8; ++c) {
+        const uint16_t len = 0x7000;
+        std::memcpy(payload + 2 * c, &len, sizeof(len));
+    }
+    tiny.payload_crc = crc32c(payload, tiny.payload_bytes);
+    std::memcpy(page, &tiny, sizeof(tiny));
+    CHECK(!collar::server::decode_frame_simd(page, out));
+}
+
+}  // namespace
+
+int main() {
+    test_matches_scalar_on_smooth_data();
+    test_matches_scalar_on_noisy_data();
+    test_rejects_corruption();
+    test_rejects_crafted_len_table();
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "instrument/counters.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "core/sample_ring.h"
+#include "storage/flash_log.h"
+#include "test_util.h"
+
+namespace {
+
+using namespace collar;
+using namespace collar::instrument;
+
+class FakeFlash : public storage::FlashDevice {
+public:
+    static constexpr std::size_t kPages = 32;
+    FakeFlash() : mem_(kPages * storage::kFlashPageSize, 0xff) {}
+
+    std::size_t page_count() const override { return kPages; }
+    std::size_t pages_per_sector() const override { return 4; }
+    bool read_page(std::size_t page, uint8_t* out) override {
+        std::memcpy(out, &mem_[page * storage::kFlashPageSize],
+                    storage::kFlashPageSize);
+        return true;
+    }
+    bool program_page(std::size_t page, const uint8_t* data) override {
+        std::memcpy(&mem_[page * storage::kFlashPageSize], data,
+                    storage::kFlashPageSize);
+        return true;
+    }
+    bool erase_sector(std::size_t first_page) override {
+        std::memset(&mem_[first_page * storage::kFlashPageSize], 0xff,
+                    4 * storage::kFlashPageSize);
+        return true;
+    }
+
+private:
+    std::vector<uint8_t> mem_;
+};
+
+uint64_t get_u64_le(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v |= uint64_t(p[i]) << (8 * i);
+    }
+    return v;
+}
+
+void test_table_layout_and_snapshot() {
+    reset_stage_counters();
+    // One slot per cache line: neighbours must not share one.
+    CHECK_EQ(sizeof(StageCounters), 64u);
+    CHECK_EQ(uintptr_t(&stage_counters(Stage::kRingToFlash)) -
+                 uintptr_t(&stage_counters(Stage::kIsrToRing)),
+             64u);
+
+    auto& c = stage_counters(Stage::kIngestDecode);
+    c.add_in(100);
+    c.add_out(90);
+    c.add_drops(10);
+    c.add_stalls(3);
+    c.add_bytes(4096);
+    const StageSnapshot snap = snapshot_counters(Stage::kIngestDecode);
+    CHECK_EQ(snap.samples_in, 100u);
+    CHECK_EQ(snap.samples_out, 90u);
+    CHECK_EQ(snap.drops, 10u);
+    CHECK_EQ(snap.stalls, 3u);
+    CHECK_EQ(snap.bytes, 4096u);
+    // The neighbouring stages were untouched.
+    CHECK_EQ(snapshot_counters(Stage::kFlashToBle).samples_in, 0u);
+    CHECK_EQ(snapshot_counters(Stage::kAnomaly).samples_in, 0u);
+}
+
+void test_gatt_blob() {
+    reset_stage_counters();
+    stage_counters(Stage::kIsrToRing).add_in(7);
+    stage_counters(Stage::kArchiveWrite).add_bytes(0x123456789abcull);
+
+    uint8_t blob[kCountersBlobSize];
+    // The blob must fit one read at the MTU the autotuner negotiates.
+    CHECK(kCountersBlobSize <= 244);
+    CHECK_EQ(counters_gatt_read(blob, sizeof(blob)), kCountersBlobSize);
+    CHECK_EQ(blob[0], kCountersBlobVersion);
+    CHECK_EQ(blob[1], uint8_t(kStageCount));
+    CHECK_EQ(get_u64_le(blob + 4), 7u);  // first stage, samples_in
+    // Last stage's bytes field: header + 5 slots * 40 + 32.
+    CHECK_EQ(get_u64_le(blob + 4 + 5 * 40 + 32), 0x123456789abcull);
+
+    // A short buffer is refused, not truncated.
+    CHECK_EQ(counters_gatt_read(blob, kCountersBlobSize - 1), 0u);
+}
+
+void test_prometheus_text() {
+    reset_stage_counters();
+    stage_counters(Stage::kIngestDecode).add_in(512);
+    stage_counters(Stage::kRingToFlash).add_drops(2);
+
+    char text[4096];
+    const std::size_t n = counters_prometheus(text, sizeof(text));
+    CHECK(n > 0);
+    const std::string body(text, n);
+    CHECK(body.find("# TYPE collar_stage_samples_in_total counter\n") !=
+          std::string::npos);
+    CHECK(body.find(
+              "collar_stage_samples_in_total{stage=\"ingest_decode\"} 512"
+              "\n") != std::string::npos);
+    CHECK(body.find(
+              "collar_stage_drops_total{stage=\"ring_to_flash\"} 2\n") !=
+          std::string::npos);
+    // Every stage appears under every family: 6 stages x 5 families.
+    std::size_t labels = 0;
+    for (std::size_t at = body.find("{stage="); at != std::string::npos;
+         at = body.find("{stage=", at + 1)) {
+        ++labels;
+    }
+    CHECK_EQ(labels, kStageCount * 5);
+    CHECK_EQ(counters_prometheus(text, 64), 0u);  // too small: refused
+}
+
+void test_ring_to_flash_conservation() {
+    reset_stage_counters();
+    FakeFlash flash;
+    storage::FlashLog log(flash);
+    CHECK(log.mount());
+
+    SampleRing<ImuSample, 512> ring;
+    std::size_t pushed = 0;
+    // Two windows and a bit, drained in ring-sized gulps.
+    const std::size_t total = 2 * SampleBatch::capacity + 50;
+    while (pushed < total) {
+        std::size_t burst = 0;
+        while (pushed < total && burst < 400) {
+            CHECK(ring.try_push({int16_t(pushed), 0, 16384, 0, 0, 0, 2100,
+                                 10}));
+            ++pushed;
+            ++burst;
+        }
+        CHECK(log.drain(ring, uint64_t(pushed) * 10));
+    }
+
+    const StageSnapshot snap = snapshot_counters(Stage::kRingToFlash);
+    CHECK_EQ(snap.samples_in, total);
+    // The tail of the third window is still staged: in minus out is
+    // exactly the gap a dashboard would show mid-window.
+    CHECK_EQ(snap.samples_out, 2 * SampleBatch::capacity);
+    CHECK_EQ(snap.samples_in - snap.samples_out, 50u);
+    CHECK_EQ(snap.drops, 0u);
+    CHECK_EQ(snap.bytes, uint64_t(log.frame_count()) *
+                             storage::kFlashPageSize);
+}
+
+}  // namespace
+
+int main() {
+    test_table_layout_and_snapshot();
+    test_gatt_blob();
+    test_prometheus_text();
+    test_ring_to_flash_conservation();
+    return 0;
+}
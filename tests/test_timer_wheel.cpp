@@ -0,0 +1,137 @@
+#include "core/timer_wheel.h"
+
+#include <vector>
+
+#include "test_util.h"
+
+namespace {
+
+using collar::TimerWheel;
+using Wheel = TimerWheel<8>;
+
+struct FireLog {
+    std::vector<std::pair<int, uint64_t>> events;  // (tag, tick)
+    const Wheel* wheel = nullptr;
+};
+
+template <int Tag>
+void record(void* ctx) {
+    auto* log = static_cast<FireLog*>(ctx);
+    log->events.push_back({Tag, log->wheel->now()});
+}
+
+void test_one_shot_ordering() {
+    Wheel w;
+    FireLog log;
+    log.wheel = &w;
+    CHECK(w.arm(30, record<3>, &log) != Wheel::kInvalidTimer);
+    CHECK(w.arm(10, record<1>, &log) != Wheel::kInvalidTimer);
+    CHECK(w.arm(20, record<2>, &log) != Wheel::kInvalidTimer);
+    CHECK_EQ(w.armed(), 3u);
+    CHECK_EQ(w.next_deadline(), 10u);
+
+    w.advance(9);
+    CHECK_EQ(log.events.size(), 0u);
+    w.advance(100);
+    CHECK_EQ(log.events.size(), 3u);
+    CHECK_EQ(log.events[0].first, 1);
+    CHECK_EQ(log.events[0].second, 10u);
+    CHECK_EQ(log.events[1].first, 2);
+    CHECK_EQ(log.events[2].first, 3);
+    CHECK_EQ(log.events[2].second, 30u);
+    CHECK_EQ(w.armed(), 0u);
+    CHECK_EQ(w.next_deadline(), Wheel::kNever);
+}
+
+void test_cancel() {
+    Wheel w;
+    FireLog log;
+    log.wheel = &w;
+    const auto id = w.arm(50, record<1>, &log);
+    CHECK(w.arm(60, record<2>, &log) != Wheel::kInvalidTimer);
+    CHECK(w.cancel(id));
+    CHECK(!w.cancel(id));  // double cancel is a no-op
+    w.advance(100);
+    CHECK_EQ(log.events.size(), 1u);
+    CHECK_EQ(log.events[0].first, 2);
+}
+
+void test_periodic_drift_free() {
+    Wheel w;
+    FireLog log;
+    log.wheel = &w;
+    const auto id = w.arm(100, record<1>, &log, 100);
+    // Wake exactly at each precomputed deadline, as the main loop does.
+    for (int i = 0; i < 5; ++i) {
+        w.advance(w.next_deadline());
+    }
+    CHECK_EQ(log.events.size(), 5u);
+    for (int i = 0; i < 5; ++i) {
+        CHECK_EQ(log.events[i].second, uint64_t(100 * (i + 1)));
+    }
+    CHECK(w.cancel(id));
+    CHECK_EQ(w.armed(), 0u);
+}
+
+void test_long_delay_cascades_exactly() {
+    // Crosses level-1, level-2 and level-3 windows; the deadline must
+    // survive every re-bucketing unchanged.
+    Wheel w;
+    FireLog log;
+    log.wheel = &w;
+    CHECK(w.arm(300000, record<1>, &log) != Wheel::kInvalidTimer);
+    w.advance(299999);
+    CHECK_EQ(log.events.size(), 0u);
+    w.advance(300000);
+    CHECK_EQ(log.events.size(), 1u);
+    CHECK_EQ(log.events[0].second, 300000u);
+}
+
+void test_pool_exhaustion() {
+    Wheel w;
+    FireLog log;
+    log.wheel = &w;
+    Wheel::TimerId ids[8];
+    for (int i = 0; i < 8; ++i) {
+        ids[i] = w.arm(uint64_t(10 + i), record<1>, &log);
+        CHECK(ids[i] != Wheel::kInvalidTimer);
+    }
+    CHECK_EQ(w.arm(5, record<2>, &log), Wheel::kInvalidTimer);
+    CHECK(w.cancel(ids[0]));
+    CHECK(w.arm(5, record<2>, &log) != Wheel::kInvalidTimer);  // slot freed
+}
+
+void rearm_cb(void* ctx);
+struct RearmCtx {
+    Wheel* wheel;
+    int fires = 0;
+};
+void rearm_cb(void* ctx) {
+    auto* c = static_cast<RearmCtx*>(ctx);
+    if (++c->fires < 3) {
+        c->wheel->arm(7, rearm_cb, c);  // re-arm from inside the callback
+    }
+}
+
+void test_rearm_in_callback() {
+    Wheel w;
+    RearmCtx c{&w};
+    w.arm(7, rearm_cb, &c);
+    while (w.armed() > 0) {
+        w.advance(w.next_deadline());
+    }
+    CHECK_EQ(c.fires, 3);
+    CHECK_EQ(w.now(), 21u);
+}
+
+}  // namespace
+
+int main() {
+    test_one_shot_ordering();
+    test_cancel();
+    test_periodic_drift_free();
+    test_long_delay_cascades_exactly();
+    test_pool_exhaustion();
+    test_rearm_in_callback();
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "instrument/trace.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "test_util.h"
+
+namespace {
+
+using namespace collar::instrument;
+
+volatile int g_sink = 0;
+
+void spin(int n) {
+    for (int i = 0; i < n; ++i) {
+        g_sink = g_sink + i;
+    }
+}
+
+void traced_work(int n) {
+    COLLAR_TRACE_SCOPE("traced_work");
+    spin(n);
+}
+
+void test_accumulates_stats() {
+    reset_traces();
+    for (int i = 0; i < 50; ++i) {
+        traced_work(100 + i * 100);
+    }
+
+    struct Found {
+        const TraceStat* s = nullptr;
+    } found;
+    visit_traces(
+        [](const TraceStat& s, void* ctx) {
+            if (std::strcmp(s.name, "traced_work") == 0) {
+                static_cast<Found*>(ctx)->s = &s;
+            }
+        },
+        &found);
+    CHECK(found.s != nullptr);
+    CHECK_EQ(found.s->count, 50u);
+    CHECK(found.s->min <= found.s->max);
+    CHECK(found.s->mean() >= found.s->min);
+    CHECK(found.s->mean() <= found.s->max);
+    CHECK(found.s->total >= found.s->count * found.s->min);
+}
+
+void test_dump_and_reset() {
+    reset_traces();
+    traced_work(1000);
+
+    std::vector<std::string> lines;
+    dump_traces(
+        [](const char* line, void* ctx) {
+            static_cast<std::vector<std::string>*>(ctx)->push_back(line);
+        },
+        &lines);
+    CHECK(lines.size() >= 2);  // header plus at least our scope
+    bool seen = false;
+    for (const auto& l : lines) {
+        if (l.find("traced_work") != std::string::npos) {
+            seen = true;
+        }
+    }
+    CHECK(seen);
+
+    reset_traces();
+    CHECK_EQ(visit_traces([](const TraceStat&, void*) {}, nullptr), 0u);
+}
+
+void test_nested_scopes_get_own_slots() {
+    reset_traces();
+    {
+        COLLAR_TRACE_SCOPE("outer");
+        {
+            COLLAR_TRACE_SCOPE("inner");
+            spin(10);
+        }
+    }
+    CHECK_EQ(visit_traces([](const TraceStat&, void*) {}, nullptr), 2u);
+}
+
+}  // namespace
+
+int main() {
+    test_accumulates_stats();
+    test_dump_and_reset();
+    test_nested_scopes_get_own_slots();
+    return 0;
+}
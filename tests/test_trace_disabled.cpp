@@ -0,0 +1,27 @@
+// Compiled with -DCOLLAR_TRACE=0: the point of this test is that the macro
+// vanishes cleanly — no registry reference, no unused-variable warnings, and
+// it still parses as one statement inside an if without braces.
+
+#define COLLAR_TRACE 0
+#include "instrument/trace.h"
+
+#include "test_util.h"
+
+namespace {
+
+int work(bool flag) {
+    COLLAR_TRACE_SCOPE("never_recorded");
+    if (flag)
+        COLLAR_TRACE_SCOPE("single_statement_position");
+    return flag ? 1 : 0;
+}
+
+}  // namespace
+
+int main() {
+    CHECK_EQ(work(true), 1);
+    // Nothing may have been registered by the disabled macros.
+    CHECK_EQ(collar::instrument::visit_traces([](
+        const collar::instrument::TraceStat&, void*) {}, nullptr), 0u);
+    return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// Minimal check macros for the unit tests. The firmware side of this repo
+// cannot depend on a heavyweight test framework, so tests are plain
+// executables that return non-zero on the first failed check; ctest does the
+// rest.
+
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__,      \
+                         __LINE__, #cond);                                   \
+            std::exit(1);                                                    \
+        }                                                                    \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+#define CHECK_NEAR(a, b, eps)                                                \
+    do {                                                                     \
+        double check_near_d_ = static_cast<double>(a) - static_cast<double>(b); \
+        CHECK(check_near_d_ < (eps) && check_near_d_ > -(eps));              \
+    } while (0)
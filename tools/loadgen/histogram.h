@@ -0,0 +1,76 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace collar::loadgen {
+
+// HDR-style latency histogram: log2 major buckets with 32 linear sub-buckets
+// each, so any recorded value is reported within ~3% of its true magnitude
+// across the whole range. Fixed footprint, O(1) record with no allocation —
+// safe to hammer from inside the event loop at storm rates.
+//
+// Values are unitless; the harness records microseconds, and 40 major
+// buckets then cover a bit over an hour, far past any latency worth
+// distinguishing.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 5;
+    static constexpr int kSub = 1 << kSubBits;
+    static constexpr int kBuckets = 40;
+
+    void record(uint64_t v) {
+        if (v == 0) {
+            v = 1;
+        }
+        int major = std::bit_width(v) - 1;
+        if (major >= kBuckets) {
+            major = kBuckets - 1;
+        }
+        const int shift = major > kSubBits ? major - kSubBits : 0;
+        ++counts_[major][(v >> shift) & (kSub - 1)];
+        ++total_;
+        if (v > max_) {
+            max_ = v;
+        }
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+
+    // Value at quantile q in [0, 1]: the upper edge of the sub-bucket
+    // holding the q'th sample, so percentiles never under-report.
+    uint64_t percentile(double q) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        uint64_t rank = uint64_t(q * double(total_));
+        if (rank >= total_) {
+            rank = total_ - 1;
+        }
+        uint64_t seen = 0;
+        for (int major = 0; major < kBuckets; ++major) {
+            for (int sub = 0; sub < kSub; ++sub) {
+                seen += counts_[major][sub];
+                if (seen > rank) {
+                    const int shift =
+                        major > kSubBits ? major - kSubBits : 0;
+                    uint64_t prefix = uint64_t(sub);
+                    if (major >= kSubBits) {
+                        prefix |= uint64_t(1) << kSubBits;
+                    }
+                    return (prefix << shift) + ((uint64_t(1) << shift) - 1);
+                }
+            }
+        }
+        return max_;
+    }
+
+private:
+    uint64_t counts_[kBuckets][kSub] = {};
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+};
+
+}  // namespace collar::loadgen
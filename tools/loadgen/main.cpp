@@ -0,0 +1,430 @@
+// collar_loadgen — fleet-scale replay harness for collar_ingestd.
+//
+// Simulates a fleet of collars syncing over the v2 wire protocol: each
+// simulated collar opens its own nonblocking connection, sends a kHello,
+// then replays flash-log pages as kPages frames built with the real proto/
+// encoder, waiting for the server's kAck after each frame. All connections
+// are driven from one epoll loop, so one process sustains tens of thousands
+// of collars without a thread apiece.
+//
+// The interesting knob is --storm-ms: connection start times are spread
+// uniformly over that window, so --storm-ms 0 is the worst-case thundering
+// herd ("everyone's human gets home at 6pm and every collar syncs at once")
+// and larger values model staggered arrivals. Per-frame upload latency
+// (send start to ack) lands in an HDR-style histogram printed at exit.
+//
+// Pages come from a recorded flash-log dump (--dump, any whole number of
+// 4 KB pages, e.g. a file produced by dd'ing a collar's log partition) or,
+// by default, from synthetic frames encoded through storage::encode_frame
+// so the server-side decode work is realistic either way.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "core/sample_batch.h"
+#include "proto/wire.h"
+#include "storage/frame.h"
+#include "tools/loadgen/histogram.h"
+
+namespace {
+
+using namespace collar;
+
+uint64_t now_us() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count());
+}
+
+// Synthesize a plausible log: a resting cat with occasional shakes, so the
+// delta+varint payload density matches a real dump rather than zeros.
+std::vector<uint8_t> synth_pages(std::size_t n_pages) {
+    std::vector<uint8_t> pages(n_pages * storage::kFlashPageSize);
+    std::mt19937 rng(0x107ca7);
+    std::uniform_int_distribution<int> jitter(-6, 6);
+    uint32_t seq = 0;
+    uint64_t tick = 0;
+    for (std::size_t p = 0; p < n_pages; ++p) {
+        SampleBatch batch;
+        batch.base_tick = tick;
+        int16_t ax = 40, ay = -25, az = 16380;
+        for (std::size_t i = 0; i < SampleBatch::capacity; ++i) {
+            ax = int16_t(ax + jitter(rng));
+            ay = int16_t(ay + jitter(rng));
+            az = int16_t(az + jitter(rng));
+            batch.append({ax, ay, az, int16_t(jitter(rng)),
+                          int16_t(jitter(rng)), int16_t(jitter(rng)), 2150,
+                          10});
+        }
+        // One batch may spill over a page on noisy stretches; the replay
+        // only needs full pages, so whatever fits in page p is the frame.
+        storage::encode_frame(batch, 0,
+                              seq++, &pages[p * storage::kFlashPageSize]);
+        tick += SampleBatch::capacity * 10;
+    }
+    return pages;
+}
+
+std::vector<uint8_t> load_dump(const char* path) {
+    std::vector<uint8_t> pages;
+    std::FILE* f = std::fopen(path, "rb");
+    if (f == nullptr) {
+        return pages;
+    }
+    std::fseek(f, 0, SEEK_END);
+    const long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    if (size > 0 && std::size_t(size) % storage::kFlashPageSize == 0) {
+        pages.resize(std::size_t(size));
+        if (std::fread(pages.data(), 1, pages.size(), f) != pages.size()) {
+            pages.clear();
+        }
+    }
+    std::fclose(f);
+    return pages;
+}
+
+struct Conn {
+    enum State { kIdle, kConnecting, kSending, kAwaitAck, kDone };
+
+    int fd = -1;
+    uint64_t collar_id = 0;
+    uint64_t start_us = 0;
+    std::size_t frames_left = 0;
+    State state = kIdle;
+    bool hello_done = false;  // first ack on the wire is the hello's
+    std::vector<uint8_t> tx;  // current frame, flattened
+    std::size_t tx_off = 0;
+    uint8_t rx[proto::kWireHeaderSize];
+    std::size_t rx_off = 0;
+    std::size_t rx_skip = 0;  // push payload bytes left to discard
+    uint64_t sent_at_us = 0;
+    std::size_t next_page = 0;
+};
+
+struct Harness {
+    const std::vector<uint8_t>* pages;
+    std::size_t pages_per_frame;
+    uint16_t port;
+    int epfd = -1;
+    loadgen::LatencyHistogram hist;
+    uint64_t frames_acked = 0;
+    uint64_t errors = 0;
+    std::size_t done = 0;
+};
+
+// Builds the next frame for c into c.tx: the hello first, then kPages
+// frames through the real scatter-gather encoder. The tool flattens the
+// iov — the bytes on the wire are identical, and a flat buffer keeps the
+// epoll state machine to one (offset, len) pair.
+void build_next_frame(Harness& h, Conn& c) {
+    uint8_t hdr[proto::kWireHeaderSize];
+    c.tx.clear();
+    c.tx_off = 0;
+    if (!c.hello_done) {
+        proto::WireHeader hello{};
+        hello.magic = proto::kWireMagic;
+        hello.version = proto::kWireVersion;
+        hello.kind = proto::kHello;
+        hello.collar_id = c.collar_id;
+        proto::encode_header(hello, hdr);
+        c.tx.assign(hdr, hdr + sizeof(hdr));
+        return;
+    }
+    const std::size_t total_pages = h.pages->size() / storage::kFlashPageSize;
+    const uint8_t* page_ptrs[proto::kMaxPayload / storage::kFlashPageSize];
+    for (std::size_t i = 0; i < h.pages_per_frame; ++i) {
+        page_ptrs[i] = h.pages->data() +
+                       ((c.next_page + i) % total_pages) *
+                           storage::kFlashPageSize;
+    }
+    c.next_page = (c.next_page + h.pages_per_frame) % total_pages;
+    proto::SgSpan iov[proto::kMaxPayload / storage::kFlashPageSize + 1];
+    const std::size_t n =
+        proto::pages_frame_sg(hdr, c.collar_id, page_ptrs, h.pages_per_frame,
+                              iov);
+    for (std::size_t i = 0; i < n; ++i) {
+        c.tx.insert(c.tx.end(), iov[i].data, iov[i].data + iov[i].len);
+    }
+}
+
+void fail_conn(Harness& h, Conn& c) {
+    ++h.errors;
+    if (c.fd >= 0) {
+        ::epoll_ctl(h.epfd, EPOLL_CTL_DEL, c.fd, nullptr);
+        ::close(c.fd);
+        c.fd = -1;
+    }
+    c.state = Conn::kDone;
+    ++h.done;
+}
+
+void finish_conn(Harness& h, Conn& c) {
+    ::epoll_ctl(h.epfd, EPOLL_CTL_DEL, c.fd, nullptr);
+    ::close(c.fd);
+    c.fd = -1;
+    c.state = Conn::kDone;
+    ++h.done;
+}
+
+void start_conn(Harness& h, Conn& c) {
+    c.fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (c.fd < 0) {
+        fail_conn(h, c);
+        return;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(h.port);
+    if (::connect(c.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) !=
+            0 &&
+        errno != EINPROGRESS) {
+        fail_conn(h, c);
+        return;
+    }
+    c.state = Conn::kConnecting;
+    epoll_event ev{};
+    ev.events = EPOLLOUT;
+    ev.data.ptr = &c;
+    if (::epoll_ctl(h.epfd, EPOLL_CTL_ADD, c.fd, &ev) != 0) {
+        fail_conn(h, c);
+    }
+}
+
+void want(Harness& h, Conn& c, uint32_t events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.ptr = &c;
+    ::epoll_ctl(h.epfd, EPOLL_CTL_MOD, c.fd, &ev);
+}
+
+void pump_send(Harness& h, Conn& c) {
+    while (c.tx_off < c.tx.size()) {
+        const ssize_t n = ::send(c.fd, c.tx.data() + c.tx_off,
+                                 c.tx.size() - c.tx_off, MSG_NOSIGNAL);
+        if (n > 0) {
+            c.tx_off += std::size_t(n);
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            want(h, c, EPOLLOUT);
+            return;
+        } else {
+            fail_conn(h, c);
+            return;
+        }
+    }
+    c.state = Conn::kAwaitAck;
+    c.rx_off = 0;
+    want(h, c, EPOLLIN);
+}
+
+void pump_recv(Harness& h, Conn& c) {
+    proto::WireHeader ack;
+    for (;;) {
+        // Discard any pending push payload first. A warm ingestd answers a
+        // hello with an ack followed by a kDict push; a real collar keeps
+        // the table, the harness only needs it off the socket.
+        while (c.rx_skip > 0) {
+            uint8_t sink[4096];
+            const std::size_t want_n = std::min(c.rx_skip, sizeof(sink));
+            const ssize_t n = ::recv(c.fd, sink, want_n, 0);
+            if (n > 0) {
+                c.rx_skip -= std::size_t(n);
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;  // stay armed for EPOLLIN
+            } else {
+                fail_conn(h, c);
+                return;
+            }
+        }
+        while (c.rx_off < sizeof(c.rx)) {
+            const ssize_t n =
+                ::recv(c.fd, c.rx + c.rx_off, sizeof(c.rx) - c.rx_off, 0);
+            if (n > 0) {
+                c.rx_off += std::size_t(n);
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;  // stay armed for EPOLLIN
+            } else {
+                fail_conn(h, c);
+                return;
+            }
+        }
+        if (!proto::parse_header(c.rx, ack) ||
+            ack.collar_id != c.collar_id) {
+            fail_conn(h, c);
+            return;
+        }
+        c.rx_off = 0;
+        if (ack.kind == proto::kAck) {
+            break;
+        }
+        // kDict today, any future non-ack push tomorrow: skip its payload
+        // and keep waiting for the ack.
+        c.rx_skip = ack.payload_bytes;
+    }
+    if (c.hello_done) {
+        h.hist.record(now_us() - c.sent_at_us);
+        ++h.frames_acked;
+        --c.frames_left;
+    } else {
+        c.hello_done = true;
+    }
+    if (c.frames_left == 0) {
+        finish_conn(h, c);
+        return;
+    }
+    build_next_frame(h, c);
+    c.sent_at_us = now_us();
+    c.state = Conn::kSending;
+    pump_send(h, c);
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s --port P [--collars N] [--frames N] [--pages N]\n"
+                 "          [--storm-ms N] [--dump PATH] [--seed N]\n",
+                 argv0);
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t collars = 1000;
+    std::size_t frames = 4;
+    std::size_t pages_per_frame = 8;
+    uint64_t storm_ms = 0;
+    uint64_t seed = 1;
+    int port = 0;
+    const char* dump = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--collars") == 0 && i + 1 < argc) {
+            collars = std::size_t(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = std::size_t(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--pages") == 0 && i + 1 < argc) {
+            pages_per_frame = std::size_t(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--storm-ms") == 0 && i + 1 < argc) {
+            storm_ms = uint64_t(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = uint64_t(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dump = argv[++i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (port <= 0 || port > 65535 || collars == 0 || frames == 0 ||
+        pages_per_frame == 0 ||
+        pages_per_frame > proto::kMaxPayload / storage::kFlashPageSize) {
+        return usage(argv[0]);
+    }
+
+    const std::vector<uint8_t> pages =
+        dump != nullptr ? load_dump(dump) : synth_pages(64);
+    if (pages.empty()) {
+        std::fprintf(stderr, "cannot load dump %s (whole 4 KB pages only)\n",
+                     dump);
+        return 1;
+    }
+
+    Harness h;
+    h.pages = &pages;
+    h.pages_per_frame = pages_per_frame;
+    h.port = uint16_t(port);
+    h.epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (h.epfd < 0) {
+        std::perror("epoll_create1");
+        return 1;
+    }
+
+    // The storm schedule: start offsets spread uniformly over the window,
+    // sorted so the loop only ever looks at the front.
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<uint64_t> spread(0, storm_ms * 1000);
+    std::vector<Conn> conns(collars);
+    const uint64_t t0 = now_us();
+    for (std::size_t i = 0; i < collars; ++i) {
+        conns[i].collar_id = uint64_t(i) + 1;
+        conns[i].frames_left = frames;
+        conns[i].start_us = t0 + (storm_ms > 0 ? spread(rng) : 0);
+        // Stagger replay offsets so the server does not decode one page
+        // fleet-wide in lockstep.
+        conns[i].next_page =
+            (i * 7) % (pages.size() / storage::kFlashPageSize);
+    }
+    std::sort(conns.begin(), conns.end(),
+              [](const Conn& a, const Conn& b) {
+                  return a.start_us < b.start_us;
+              });
+    std::size_t next_start = 0;
+
+    epoll_event events[512];
+    while (h.done < collars) {
+        const uint64_t now = now_us();
+        while (next_start < collars &&
+               conns[next_start].start_us <= now) {
+            start_conn(h, conns[next_start++]);
+        }
+        int timeout = -1;
+        if (next_start < collars) {
+            timeout = int((conns[next_start].start_us - now) / 1000 + 1);
+        }
+        if (h.done >= collars) {
+            break;
+        }
+        const int n = ::epoll_wait(h.epfd, events, 512, timeout);
+        for (int i = 0; i < n; ++i) {
+            auto* c = static_cast<Conn*>(events[i].data.ptr);
+            if (c->state == Conn::kConnecting) {
+                int err = 0;
+                socklen_t len = sizeof(err);
+                ::getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                if (err != 0) {
+                    fail_conn(h, *c);
+                    continue;
+                }
+                build_next_frame(h, *c);
+                c->sent_at_us = now_us();
+                c->state = Conn::kSending;
+                pump_send(h, *c);
+            } else if (c->state == Conn::kSending) {
+                pump_send(h, *c);
+            } else if (c->state == Conn::kAwaitAck) {
+                pump_recv(h, *c);
+            }
+        }
+    }
+    const double wall_s = double(now_us() - t0) / 1e6;
+    ::close(h.epfd);
+
+    const double mib = double(h.frames_acked) *
+                       double(pages_per_frame * storage::kFlashPageSize) /
+                       (1024.0 * 1024.0);
+    std::printf("collar_loadgen: %zu collars, %" PRIu64
+                " frames acked, %" PRIu64 " errors, %.2f s wall\n",
+                collars, h.frames_acked, h.errors, wall_s);
+    std::printf("  upload latency us: p50=%" PRIu64 " p90=%" PRIu64
+                " p99=%" PRIu64 " p99.9=%" PRIu64 " max=%" PRIu64 "\n",
+                h.hist.percentile(0.50), h.hist.percentile(0.90),
+                h.hist.percentile(0.99), h.hist.percentile(0.999),
+                h.hist.max());
+    std::printf("  throughput: %.0f frames/s, %.1f MiB/s\n",
+                double(h.frames_acked) / wall_s, mib / wall_s);
+    return h.errors == 0 ? 0 : 1;
+}